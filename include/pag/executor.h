@@ -0,0 +1,65 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <functional>
+#include <memory>
+#include "pag/defines.h"
+
+namespace pag {
+class TaskGroup;
+
+/**
+ * TaskExecutor is the interface through which PAG dispatches all of its background work, such as
+ * image decoding, video decoding and decoder initialization. Hosts can implement it to run the
+ * work on their own thread pool, and then pass it to PAG::SetTaskExecutor().
+ */
+class PAG_API TaskExecutor {
+ public:
+  /**
+   * Creates a TaskExecutor that runs jobs on a built-in thread pool with at most maxThreads
+   * threads. Jobs that the render thread is waiting for are always picked up before others.
+   * Returns nullptr if threads are not supported on the current platform.
+   */
+  static std::shared_ptr<TaskExecutor> MakeThreadPool(int maxThreads);
+
+  /**
+   * Creates a TaskExecutor that runs every job synchronously on the calling thread. This is
+   * useful for deterministic testing.
+   */
+  static std::shared_ptr<TaskExecutor> MakeInline();
+
+  virtual ~TaskExecutor() = default;
+
+  /**
+   * Schedules the job to be executed. The job can be run on any thread, including the calling
+   * thread, but it must be run exactly once, even if PAG has lost interest in its result, in which
+   * case the job returns immediately.
+   * @param job The work to run.
+   * @param urgent True if the render thread is waiting (or will wait very soon) for the result.
+   */
+  virtual void execute(std::function<void()> job, bool urgent) = 0;
+
+ private:
+  virtual TaskGroup* getTaskGroup() {
+    return nullptr;
+  }
+
+  friend class Task;
+};
+}  // namespace pag
@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <mutex>
 #include "pag/types.h"
@@ -206,6 +207,16 @@ class Keyframe {
     return startValue;
   }
 
+  /**
+   * Writes the values of count frames starting at the specified frame to values, which is the
+   * same as calling getValueAt() for each of them but evaluates the easing curves in one batch.
+   */
+  virtual void getValuesAt(Frame startFrame, size_t count, T* values) {
+    for (size_t i = 0; i < count; i++) {
+      values[i] = getValueAt(startFrame + static_cast<Frame>(i));
+    }
+  }
+
   bool containsTime(Frame time) const {
     return time >= startTime && time < endTime;
   }
@@ -256,11 +267,88 @@ std::vector<TimeRange> PAG_API OffsetTimeRanges(const std::vector<TimeRange>& ti
 bool PAG_API HasVaryingTimeRange(const std::vector<TimeRange>* staticTimeRanges, Frame startTime,
                                  Frame duration);
 
+/**
+ * Describes how a value of type T is stored in the flat float buffer of a baked property. Each
+ * component of the value has its own contiguous run of samples, the stride is the distance between
+ * two runs. Types that can not be stored as a fixed number of floats have no components and are
+ * never baked.
+ */
+template <typename T>
+struct BakedValue {
+  static constexpr size_t Components = 0;
+};
+
+template <>
+struct BakedValue<float> {
+  static constexpr size_t Components = 1;
+
+  static void Write(const float& value, float* data, size_t) {
+    data[0] = value;
+  }
+
+  static float Read(const float* data, size_t) {
+    return data[0];
+  }
+};
+
+template <>
+struct BakedValue<uint8_t> {
+  static constexpr size_t Components = 1;
+
+  static void Write(const uint8_t& value, float* data, size_t) {
+    data[0] = value;
+  }
+
+  static uint8_t Read(const float* data, size_t) {
+    return static_cast<uint8_t>(data[0]);
+  }
+};
+
+template <>
+struct BakedValue<Point> {
+  static constexpr size_t Components = 2;
+
+  static void Write(const Point& value, float* data, size_t stride) {
+    data[0] = value.x;
+    data[stride] = value.y;
+  }
+
+  static Point Read(const float* data, size_t stride) {
+    return Point::Make(data[0], data[stride]);
+  }
+};
+
+template <>
+struct BakedValue<Color> {
+  static constexpr size_t Components = 3;
+
+  static void Write(const Color& value, float* data, size_t stride) {
+    data[0] = value.red;
+    data[stride] = value.green;
+    data[stride * 2] = value.blue;
+  }
+
+  static Color Read(const float* data, size_t stride) {
+    return {static_cast<uint8_t>(data[0]), static_cast<uint8_t>(data[stride]),
+            static_cast<uint8_t>(data[stride * 2])};
+  }
+};
+
+/**
+ * The samples of a baked property, see AnimatableProperty::bake().
+ */
+struct BakedSamples {
+  // The samples of all keyframes.
+  std::vector<float> values = {};
+  // The offset of the first sample of each keyframe in values, or -1 if the keyframe is static.
+  std::vector<int64_t> offsets = {};
+};
+
 template <typename T>
 class AnimatableProperty : public Property<T> {
  public:
   explicit AnimatableProperty(const std::vector<Keyframe<T>*>& keyframes)
-      : keyframes(keyframes), lastKeyframeIndex(0) {
+      : keyframes(keyframes) {
     this->value = keyframes[0]->startValue;
     for (Keyframe<T>* keyframe : keyframes) {
       keyframe->initialize();
@@ -292,36 +380,77 @@ class AnimatableProperty : public Property<T> {
     }
   }
 
+  /**
+   * Returns the value at the specified frame. It never modifies the property, so one property can
+   * be evaluated from multiple threads at the same time.
+   */
   T getValueAt(Frame frame) override {
-    T result;
-    Keyframe<T>* lastKeyframe = keyframes[lastKeyframeIndex];
-    if (lastKeyframe->containsTime(frame)) {
-      return lastKeyframe->getValueAt(frame);
+    return getKeyframeValueAt(findKeyframeIndex(frame), frame);
+  }
+
+  /**
+   * Returns the value at the specified frame. The cursor keeps the index of the keyframe found by
+   * the previous call, which makes sequential lookups O(1). Each caller must own its cursor, and
+   * the cursor should be initialized to 0.
+   */
+  T getValueAt(Frame frame, size_t* cursor) {
+    auto index = *cursor;
+    if (index >= keyframes.size() || !keyframes[index]->containsTime(frame)) {
+      if (index + 1 < keyframes.size() && keyframes[index + 1]->containsTime(frame)) {
+        index++;
+      } else {
+        index = findKeyframeIndex(frame);
+      }
+      *cursor = index;
     }
-    if (frame < lastKeyframe->startTime) {
-      while (lastKeyframeIndex > 0) {
-        lastKeyframeIndex--;
-        if (keyframes[lastKeyframeIndex]->containsTime(frame)) {
-          break;
+    return getKeyframeValueAt(index, frame);
+  }
+
+  /**
+   * Evaluates the interpolated keyframes at every frame and stores the results in a flat float
+   * buffer, getValueAt() reads the samples afterwards instead of evaluating the easing curves.
+   * Keyframes that hold or keep the same value are static and not sampled. Returns the memory cost
+   * of the samples in bytes, or 0 if nothing is sampled. The keyframes must not be modified after
+   * baking, and the property must not be evaluated while baking.
+   */
+  size_t bake() {
+    if constexpr (BakedValue<T>::Components == 0) {
+      return 0;
+    } else {
+      std::vector<int64_t> offsets(keyframes.size(), -1);
+      int64_t sampleCount = 0;
+      for (size_t i = 0; i < keyframes.size(); i++) {
+        auto keyframe = keyframes[i];
+        if (IsStaticKeyframe(keyframe)) {
+          continue;
         }
+        offsets[i] = sampleCount;
+        sampleCount += (keyframe->endTime - keyframe->startTime) *
+                       static_cast<int64_t>(BakedValue<T>::Components);
       }
-    } else {
-      while (lastKeyframeIndex < keyframes.size() - 1) {
-        lastKeyframeIndex++;
-        if (keyframes[lastKeyframeIndex]->containsTime(frame)) {
-          break;
+      if (sampleCount == 0) {
+        return 0;
+      }
+      std::vector<float> values(static_cast<size_t>(sampleCount));
+      std::vector<T> samples = {};
+      for (size_t i = 0; i < keyframes.size(); i++) {
+        if (offsets[i] < 0) {
+          continue;
+        }
+        auto keyframe = keyframes[i];
+        auto frameCount = static_cast<size_t>(keyframe->endTime - keyframe->startTime);
+        samples.resize(frameCount);
+        keyframe->getValuesAt(keyframe->startTime, frameCount, samples.data());
+        auto data = values.data() + offsets[i];
+        for (size_t frame = 0; frame < frameCount; frame++) {
+          BakedValue<T>::Write(samples[frame], data + frame, frameCount);
         }
       }
+      baked = std::make_unique<BakedSamples>();
+      baked->values = std::move(values);
+      baked->offsets = std::move(offsets);
+      return baked->values.size() * sizeof(float) + baked->offsets.size() * sizeof(int64_t);
     }
-    lastKeyframe = keyframes[lastKeyframeIndex];
-    if (frame <= lastKeyframe->startTime) {
-      result = lastKeyframe->startValue;
-    } else if (frame >= lastKeyframe->endTime) {
-      result = lastKeyframe->endValue;
-    } else {
-      result = lastKeyframe->getValueAt(frame);
-    }
-    return result;
   }
 
   /**
@@ -330,7 +459,53 @@ class AnimatableProperty : public Property<T> {
   std::vector<Keyframe<T>*> keyframes;
 
  private:
-  std::atomic_size_t lastKeyframeIndex;
+  // The baked samples of all keyframes, or nullptr if the property is not baked, see bake().
+  std::unique_ptr<BakedSamples> baked = nullptr;
+
+  static bool IsStaticKeyframe(const Keyframe<T>* keyframe) {
+    if (keyframe->interpolationType == KeyframeInterpolationType::Hold) {
+      return true;
+    }
+    return keyframe->startValue == keyframe->endValue && keyframe->spatialOut.isZero() &&
+           keyframe->spatialIn.isZero();
+  }
+
+  /**
+   * Returns the index of the last keyframe that starts at or before the specified frame, or 0 if
+   * the frame is before all keyframes.
+   */
+  size_t findKeyframeIndex(Frame frame) const {
+    // The keyframes are sorted by time and never overlap, use a binary search on their start times.
+    auto result = std::upper_bound(
+        keyframes.begin(), keyframes.end(), frame,
+        [](Frame time, const Keyframe<T>* keyframe) { return time < keyframe->startTime; });
+    if (result == keyframes.begin()) {
+      return 0;
+    }
+    return static_cast<size_t>(result - keyframes.begin()) - 1;
+  }
+
+  T getKeyframeValueAt(size_t index, Frame frame) const {
+    auto keyframe = keyframes[index];
+    if (frame <= keyframe->startTime) {
+      return keyframe->startValue;
+    }
+    if (frame >= keyframe->endTime) {
+      return keyframe->endValue;
+    }
+    if constexpr (BakedValue<T>::Components > 0) {
+      if (baked != nullptr) {
+        auto offset = baked->offsets[index];
+        if (offset < 0) {
+          return keyframe->startValue;
+        }
+        auto frameCount = static_cast<size_t>(keyframe->endTime - keyframe->startTime);
+        return BakedValue<T>::Read(baked->values.data() + offset + (frame - keyframe->startTime),
+                                   frameCount);
+      }
+    }
+    return keyframe->getValueAt(frame);
+  }
 
   RTTR_ENABLE(Property<T>)
 };
@@ -1937,6 +2112,42 @@ class PAG_API Sequence {
 
   Frame toSequenceFrame(Frame compositionFrame);
 
+  /**
+   * Decodes the frames of the sequence if they were deferred by a lazy decoding. It does nothing if
+   * the frames are already decoded, and it is safe to call from multiple threads.
+   */
+  void decodeFrames();
+
+  /**
+   * Returns true if the decoding of frames is deferred and decodeFrames() has not been called yet.
+   * The frames (and the headers of a VideoSequence) stay empty until then.
+   */
+  bool framesDeferred() const;
+
+  /**
+   * Defers the decoding of frames until decodeFrames() is called. The decoder must produce exactly
+   * frameCount frames, and the validator checks the deferred frame data without decoding it.
+   */
+  void deferFrames(Frame frameCount, std::function<void(Sequence*)> decoder,
+                   std::function<bool()> validator);
+
+ protected:
+  /**
+   * The number of frames recorded by deferFrames(), or 0 if the frames are decoded eagerly.
+   */
+  Frame deferredFrameCount = 0;
+
+  /**
+   * Checks the deferred frame data without decoding it. Returns false if no frames were deferred.
+   */
+  bool verifyDeferredFrames() const;
+
+ private:
+  mutable std::mutex frameLocker = {};
+  std::atomic_bool deferred = {false};
+  std::function<void(Sequence*)> frameDecoder = nullptr;
+  std::function<bool()> frameValidator = nullptr;
+
   RTTR_ENABLE()
 };
 
@@ -1959,12 +2170,13 @@ class PAG_API BitmapSequence : public Sequence {
  public:
   ~BitmapSequence() override;
   /**
-   * The bitmap frames of the Composition.
+   * The bitmap frames of the Composition. It is empty until decodeFrames() is called if
+   * framesDeferred() returns true.
    */
   std::vector<BitmapFrame*> frames;
 
   Frame duration() const override {
-    return static_cast<Frame>(frames.size());
+    return deferredFrameCount > 0 ? deferredFrameCount : static_cast<Frame>(frames.size());
   }
 
   bool verify() const override;
@@ -2022,18 +2234,20 @@ class PAG_API VideoSequence : public Sequence {
    */
   int32_t alphaStartY = 0;
   /**
-   * The video frames of the Composition.
+   * The video frames of the Composition. It is empty until decodeFrames() is called if
+   * framesDeferred() returns true.
    */
   std::vector<VideoFrame*> frames;
   /**
-   * Codec specific data.
+   * Codec specific data. It is empty until decodeFrames() is called if framesDeferred() returns
+   * true.
    */
   std::vector<ByteData*> headers;
 
   std::vector<TimeRange> staticTimeRanges;
 
   Frame duration() const override {
-    return static_cast<Frame>(frames.size());
+    return deferredFrameCount > 0 ? deferredFrameCount : static_cast<Frame>(frames.size());
   }
 
   bool verify() const override;
@@ -2126,9 +2340,12 @@ class PAG_API File {
                                     const std::string& filePath = "");
   /**
    *  Load a pag file from path, return null if the file does not exist or the data is not a pag
-   * file.
+   * file. If mapFile is true, the file is mapped into memory instead of being read, which saves
+   * loading the pages that are never accessed. Only set it to true if the file is guaranteed not
+   * to be modified or truncated while the returned File is alive, otherwise the payloads may change
+   * or the process may crash when accessing them.
    */
-  static std::shared_ptr<File> Load(const std::string& filePath);
+  static std::shared_ptr<File> Load(const std::string& filePath, bool mapFile = false);
 
   ~File();
 
@@ -2199,6 +2416,12 @@ class PAG_API File {
 
   bool hasScaledTimeRange() const;
 
+  /**
+   * Returns the memory cost in bytes of the property samples baked while decoding this file, or 0
+   * if property baking was disabled. See Codec::SetPropertyBakingEnabled().
+   */
+  int64_t bakedMemory() const;
+
   /**
    * Indicates how to stretch the duration of File when rendering.
    */
@@ -2214,6 +2437,7 @@ class PAG_API File {
   Composition* mainComposition = nullptr;
   uint16_t _tagLevel = 1;
   int _numLayers = 0;
+  int64_t _bakedMemory = 0;
 
   // Just references, no need to delete them.
   std::vector<TextLayer*> textLayers = {};
@@ -2221,6 +2445,9 @@ class PAG_API File {
   // Just references, no need to delete them.
   std::vector<std::vector<ImageLayer*>> imageLayers = {};
 
+  // The backing store of a file decoded in zero-copy mode, payloads of the file are views into it.
+  std::unique_ptr<ByteData> fileBytes = nullptr;
+
   File(std::vector<Composition*> compositionList, std::vector<pag::ImageBytes*> imageList);
   void updateEditables(Composition* composition);
 
@@ -2232,6 +2459,8 @@ class PAG_API File {
  */
 int64_t PAG_API CalculateGraphicsMemory(std::shared_ptr<File> file);
 
+class CodecContext;
+
 class PAG_API Codec {
  public:
   /**
@@ -2239,6 +2468,21 @@ class PAG_API Codec {
    */
   static uint16_t MaxSupportedTagLevel();
 
+  /**
+   * Sets whether the images and compositions of a pag file are decoded concurrently on the task
+   * executor, which speeds up loading files with many compositions. The default value is false.
+   */
+  static void SetParallelDecodingEnabled(bool enabled);
+
+  /**
+   * Sets whether the animatable properties of a pag file are baked on the task executor after
+   * decoding. A baked property keeps the value of each frame of its interpolated keyframes, which
+   * makes rendering cheaper at the cost of memory, see File::bakedMemory(). Only the properties of
+   * numbers, points and colors are baked, such as the ones of transforms, shapes, masks and
+   * effects. The default value is false.
+   */
+  static void SetPropertyBakingEnabled(bool enabled);
+
   /**
    * Replace all temporary mask with real references.
    */
@@ -2267,6 +2511,14 @@ class PAG_API Codec {
   static std::shared_ptr<File> Decode(const void* bytes, uint32_t byteLength,
                                       const std::string& path);
 
+  /**
+   * Decode a pag file from the specified byte data and take ownership of it. The image, video and
+   * bitmap payloads of the returned file are views into the byte data instead of copies, and the
+   * byte data is kept alive until the file is released. The byte data may be modified in place
+   * during decoding, return null if the byte data is empty or it's not a valid pag file.
+   */
+  static std::shared_ptr<File> Decode(std::unique_ptr<ByteData> fileBytes, const std::string& path);
+
   /**
    * Encode a pag file to byte data, return null if the file is null.
    */
@@ -2285,5 +2537,9 @@ class PAG_API Codec {
    */
   static std::shared_ptr<PerformanceData> ReadPerformanceData(const void* bytes,
                                                               uint32_t byteLength);
+
+ private:
+  static std::shared_ptr<File> Decode(CodecContext* context, const void* bytes,
+                                      uint32_t byteLength, const std::string& path);
 };
 }  // namespace pag
@@ -21,6 +21,7 @@
 #include <functional>  // for windows
 #include <unordered_map>
 #include "pag/decoder.h"
+#include "pag/executor.h"
 #include "pag/gpu.h"
 #include "pag/types.h"
 
@@ -496,6 +497,10 @@ class PAG_API PAGLayer : public Content {
   friend class FileReporter;
 
   friend class PAGImageLayer;
+
+  friend class DamageTracker;
+
+  friend class OcclusionCuller;
 };
 
 class SolidLayer;
@@ -957,6 +962,10 @@ class PAG_API PAGComposition : public PAGLayer {
 
   friend class PAGImageLayer;
 
+  friend class DamageTracker;
+
+  friend class OcclusionCuller;
+
   friend class FileReporter;
 };
 
@@ -974,9 +983,11 @@ class PAG_API PAGFile : public PAGComposition {
                                        const std::string& filePath = "");
   /**
    *  Load a pag file from path, return null if the file does not exist or the data is not a pag
-   * file.
+   * file. If mapFile is true, the file is mapped into memory instead of being read, which saves
+   * loading the pages that are never accessed. Only set it to true if the file is guaranteed not
+   * to be modified or truncated while the returned PAGFile is alive.
    */
-  static std::shared_ptr<PAGFile> Load(const std::string& filePath);
+  static std::shared_ptr<PAGFile> Load(const std::string& filePath, bool mapFile = false);
 
   PAGFile(std::shared_ptr<File> file, PreComposeLayer* layer);
 
@@ -1141,6 +1152,15 @@ class Drawable {
 
 class Graphic;
 
+class AsyncPixelReader;
+
+/**
+ * The callback of PAGSurface::readPixelsAsync(). The frame is the one passed to readPixelsAsync(),
+ * and the pixels are only valid during the callback. The pixels are null if the read failed.
+ */
+typedef std::function<void(int64_t frame, const void* pixels, size_t rowBytes)>
+    ReadPixelsCallback;
+
 class PAG_API PAGSurface {
  public:
   /**
@@ -1205,6 +1225,27 @@ class PAG_API PAGSurface {
    */
   bool readPixels(ColorType colorType, AlphaType alphaType, void* dstPixels, size_t dstRowBytes);
 
+  /**
+   * Starts copying pixels from current PAGSurface with specified color type and alpha type without
+   * waiting for the GPU, so the next frames can be rendered while the pixels are transferred. The
+   * callback is called with the pixels once the copy is finished, during a later call to
+   * readPixelsAsync() or finishReadPixels(), and always in the order the copies were started. The
+   * copies still pending when the PAGSurface is destroyed are finished by its destructor, or are
+   * handed to their callbacks with null pixels if the GPU context is unavailable. The frame is
+   * passed back to the callback to identify the copy. The pixels are read synchronously and handed
+   * to the callback immediately if the GPU does not support pixel buffers, such as on OpenGL ES
+   * 2.0. Returns false if the copy can not be started.
+   */
+  bool readPixelsAsync(int64_t frame, ColorType colorType, AlphaType alphaType,
+                       ReadPixelsCallback callback);
+
+  /**
+   * Waits for all the copies started by readPixelsAsync() and calls their callbacks.
+   */
+  void finishReadPixels();
+
+  ~PAGSurface();
+
  private:
   uint32_t contentVersion = 0;
   PAGPlayer* pagPlayer = nullptr;
@@ -1212,12 +1253,14 @@ class PAG_API PAGSurface {
   std::shared_ptr<Drawable> drawable = nullptr;
   std::shared_ptr<Device> device = nullptr;
   std::shared_ptr<Surface> surface = nullptr;
+  AsyncPixelReader* pixelReader = nullptr;
 
   explicit PAGSurface(std::shared_ptr<Drawable> drawable);
 
   bool draw(RenderCache* cache, std::shared_ptr<Graphic> graphic, BackendSemaphore* signalSemaphore,
-            bool autoClear = true);
+            bool autoClear = true, const Rect* damageRect = nullptr);
   bool hitTest(RenderCache* cache, std::shared_ptr<Graphic> graphic, float x, float y);
+  bool prewarm(RenderCache* cache, PAGComposition* composition);
   Context* lockContext();
   void unlockContext();
   bool wait(const BackendSemaphore& waitSemaphore);
@@ -1229,6 +1272,57 @@ class PAG_API PAGSurface {
 
 class FileReporter;
 
+class DamageTracker;
+
+/**
+ * The cache statistics of the last flush of a PAGPlayer, which help to find out what made a frame
+ * slow, such as a snapshot rasterization, a program compilation or an image that was not decoded
+ * in advance.
+ */
+struct PAGCacheStats {
+  /**
+   * The bitmap caches of layers and images.
+   */
+  CacheCounters snapshots;
+  /**
+   * The decoded images. A miss means the image was not decoded in advance.
+   */
+  CacheCounters images;
+  /**
+   * The video and bitmap sequence readers. A miss means a reader was created.
+   */
+  CacheCounters sequenceReaders;
+  /**
+   * The filters of layer styles and effects.
+   */
+  CacheCounters filters;
+  /**
+   * The GPU programs. A miss means a program was compiled.
+   */
+  CacheCounters programs;
+  /**
+   * The GPU resources that are kept for reuse, such as textures and render targets.
+   */
+  CacheCounters recycledResources;
+  /**
+   * The gradient textures.
+   */
+  CacheCounters gradients;
+  /**
+   * The mask textures of the paths that can not be drawn directly on the GPU.
+   */
+  CacheCounters pathMasks;
+  /**
+   * The glyph images in the glyph atlas. A miss means a glyph was rasterized and uploaded.
+   */
+  CacheCounters glyphs;
+  /**
+   * The per-frame contents of layers, such as the shapes, texts and compositions. These caches are
+   * shared by all players of the same PAGFile.
+   */
+  CacheCounters contents;
+};
+
 class PAG_API PAGPlayer {
  public:
   PAGPlayer();
@@ -1278,6 +1372,20 @@ class PAG_API PAGPlayer {
    */
   void setCacheEnabled(bool value);
 
+  /**
+   * If set to true, the internal bitmap caches of this PAGPlayer are shared with other PAGPlayers
+   * that render the same content at the same scale onto the same GPU device, and have also enabled
+   * this property. Sharing reduces the graphics memory and rasterization work when playing one
+   * PAGFile in multiple players. It takes effect only if the cacheEnabled property is true. The
+   * default value is false.
+   */
+  bool sharedCacheEnabled();
+
+  /**
+   * Set the value of sharedCacheEnabled property.
+   */
+  void setSharedCacheEnabled(bool value);
+
   /**
    * This value defines the scale factor for internal graphics caches, ranges from 0.0 to 1.0. The
    * scale factors less than 1.0 may result in blurred output, but it can reduce the usage of
@@ -1363,6 +1471,31 @@ class PAG_API PAGPlayer {
    */
   void setAutoClear(bool value);
 
+  /**
+   * If true, PAGPlayer only clears and redraws the area of PAGSurface that changed since the last
+   * flush. The default value is false.
+   */
+  bool partialRedraw();
+
+  /**
+   * Sets the partialRedraw property. When enabled, PAGPlayer compares the layers of every new frame
+   * with the ones of the last frame, and restricts the clear and the drawing to the area covered by
+   * the layers that changed. This saves most of the GPU work when only a small part of a large
+   * content animates. The PAGSurface must keep its pixels between flushes, which holds for the
+   * offscreen PAGSurfaces and the ones made from textures, window surfaces need to preserve their
+   * back buffers after presenting. It takes no effect if autoClear is false.
+   */
+  void setPartialRedraw(bool value);
+
+  /**
+   * Returns the area of PAGSurface that was redrawn by the last flush, in the coordinates of the
+   * PAGSurface. It can be passed to the platform to present only that area, for example by
+   * eglSwapBuffersWithDamageKHR(). Returns the bounds of the whole PAGSurface if partialRedraw is
+   * false or the whole PAGSurface had to be redrawn, and an empty rect if the last flush did not
+   * change the PAGSurface.
+   */
+  Rect damageRect();
+
   /**
    * Inserts a GPU semaphore that the current GPU-backed API must wait on before executing any more
    * commands on the GPU for this player. It is usually called before PAGPlayer.flush(). PAG will
@@ -1426,6 +1559,17 @@ class PAG_API PAGPlayer {
   bool hitTestPoint(std::shared_ptr<PAGLayer> pagLayer, float surfaceX, float surfaceY,
                     bool pixelHitTest = false);
 
+  /**
+   * Builds the GPU programs and gradient textures that the layers of the composition may need,
+   * such as those of the effects, layer styles, motion blur and gradient fills, so that they are
+   * not created during playback. The composition does not need to be set to this PAGPlayer yet,
+   * which makes it possible to prewarm a newly loaded file before playing it, but it should be set
+   * before the next flush(), which releases the filters prewarmed for the layers not in this
+   * PAGPlayer. Nothing is drawn to the surface. Returns false if the PAGPlayer has no surface or
+   * the GPU context is unavailable.
+   */
+  bool prewarm(std::shared_ptr<PAGComposition> composition);
+
   /**
    * The time cost by rendering in microseconds.
    */
@@ -1446,6 +1590,27 @@ class PAG_API PAGPlayer {
    */
   int64_t graphicsMemory();
 
+  /**
+   * The number of draw calls issued to the GPU by the last flush.
+   */
+  int drawCallCount();
+
+  /**
+   * The number of draws that were merged into other draw calls by the last flush.
+   */
+  int mergedDrawCount();
+
+  /**
+   * The number of layers that were not drawn by the last flush because they were completely hidden
+   * by opaque layers above them.
+   */
+  int culledLayerCount();
+
+  /**
+   * Returns the cache statistics of the last flush.
+   */
+  PAGCacheStats cacheStats();
+
  protected:
   std::shared_ptr<std::mutex> rootLocker = nullptr;
   std::shared_ptr<PAGStage> stage = nullptr;
@@ -1459,11 +1624,16 @@ class PAG_API PAGPlayer {
 
  private:
   FileReporter* reporter = nullptr;
+  DamageTracker* damageTracker = nullptr;
+  Rect pendingDamage = Rect::MakeEmpty();
+  Rect lastDamage = Rect::MakeEmpty();
+  int lastCulledLayerCount = 0;
   float _maxFrameRate = 60;
   int _scaleMode = PAGScaleMode::LetterBox;
   bool _autoClear = true;
 
   void updateStageSize();
+  void resetDamage();
   void setSurfaceInternal(std::shared_ptr<PAGSurface> newSurface);
   int64_t getTimeStampInternal();
 
@@ -1493,6 +1663,48 @@ class PAG_API PAG {
    * Get SDK version information.
    */
   static std::string SDKVersion();
+
+  /**
+   * Set the TaskExecutor that PAG dispatches all of its background work to, for example to share
+   * the host's own thread pool. Pass nullptr to restore the default thread pool, which is sized
+   * by the number of CPU cores. Tasks that are already scheduled keep running on the executor they
+   * were dispatched to. The default thread pool is not started until the first task is scheduled
+   * without a custom executor.
+   */
+  static void SetTaskExecutor(std::shared_ptr<TaskExecutor> executor);
+
+  /**
+   * Sets the maximum memory in bytes that the per-frame contents generated from files, such as
+   * paths, glyph runs and transforms, can take up in the whole process. Once the limit is
+   * exceeded, the contents of the frames farthest from the ones being played are released and
+   * generated again when needed. GPU caches are not affected. The default value is 64 MB.
+   */
+  static void SetFrameCacheLimit(size_t maxMemory);
+
+  /**
+   * Sets the maximum graphics memory in bytes that the caches of all PAGPlayers in the process can
+   * take up, such as snapshots of layers and images, the textures of sequence frames, the buffers
+   * of filters and the GPU resources kept for reuse. Once the limit is reached, no more snapshots
+   * are created, and the players that have been idle the longest release their caches at the start
+   * of their next flush or hit test. The default value is 300 MB. Use PAGPlayer::graphicsMemory()
+   * to get the usage of each player.
+   */
+  static void SetMaxGraphicsMemory(size_t maxMemory);
+
+  /**
+   * Returns the graphics memory in bytes taken up by the caches of all PAGPlayers in the process.
+   */
+  static size_t GraphicsMemory();
+
+  /**
+   * Sets the directory to store the compiled GPU programs, which must exist and be writable. The
+   * programs stored there are loaded directly the next time the process starts instead of being
+   * compiled again, which shortens the first frames of a new animation. Stored programs are
+   * discarded automatically once the GPU driver changes. Pass an empty string to disable the
+   * cache, which is the default. Only takes effect on OpenGL devices that support program
+   * binaries.
+   */
+  static void SetProgramCacheDirectory(const std::string& directory);
 };
 
 }  // namespace pag
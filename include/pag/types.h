@@ -49,6 +49,32 @@ inline Opacity PAG_API OpacityConcat(Opacity a, Opacity b) {
   return static_cast<Opacity>(a * b / 255);
 }
 
+/**
+ * Hit, miss and eviction counters of a cache.
+ */
+struct CacheCounters {
+  /**
+   * The number of lookups that found a cached entry.
+   */
+  int64_t hits = 0;
+  /**
+   * The number of lookups that had to create a new entry.
+   */
+  int64_t misses = 0;
+  /**
+   * The number of entries removed from the cache.
+   */
+  int64_t evictions = 0;
+  /**
+   * The memory in bytes taken up by the new entries, or 0 if the cache does not track memory.
+   */
+  int64_t allocatedBytes = 0;
+  /**
+   * The memory in bytes freed by the evictions, or 0 if the cache does not track memory.
+   */
+  int64_t evictedBytes = 0;
+};
+
 struct Color {
   uint8_t red, green, blue;  // in the range [0 - 255]
 };
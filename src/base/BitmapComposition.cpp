@@ -77,6 +77,7 @@ void BitmapComposition::updateStaticTimeRanges() {
       }
     }
     float timeScale = frameRate / sequence->frameRate;
+    sequence->decodeFrames();
     for (auto frame : sequence->frames) {
       if (IsEmptyBitmapFrame(frame)) {
         end = index;
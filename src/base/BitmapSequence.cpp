@@ -44,10 +44,14 @@ BitmapSequence::~BitmapSequence() {
 }
 
 bool BitmapSequence::verify() const {
-  if (!Sequence::verify() || frames.empty()) {
+  if (!Sequence::verify() || duration() <= 0) {
     VerifyFailed();
     return false;
   }
+  if (framesDeferred()) {
+    // The frames are still empty, checks the data they will be decoded from instead.
+    return verifyDeferredFrames();
+  }
   auto frameNotNull = [](BitmapFrame* frame) { return frame != nullptr && frame->verify(); };
   if (!std::all_of(frames.begin(), frames.end(), frameNotNull)) {
     VerifyFailed();
@@ -19,6 +19,7 @@
 #include <algorithm>
 #include <unordered_map>
 
+#include "base/utils/FileMapping.h"
 #include "pag/file.h"
 
 namespace pag {
@@ -55,12 +56,35 @@ static std::shared_ptr<File> FindFileByPath(const std::string& filePath) {
   return nullptr;
 }
 
-std::shared_ptr<File> File::Load(const std::string& filePath) {
-  auto byteData = ByteData::FromPath(filePath);
-  if (byteData == nullptr) {
-    return nullptr;
+static void AddFileToCache(const std::string& filePath, std::shared_ptr<File> file) {
+  std::lock_guard<std::mutex> autoLock(globalLocker);
+  std::weak_ptr<File> weak = file;
+  weakFileMap.insert(std::make_pair(filePath, std::move(weak)));
+}
+
+std::shared_ptr<File> File::Load(const std::string& filePath, bool mapFile) {
+  auto file = FindFileByPath(filePath);
+  if (file != nullptr) {
+    return file;
+  }
+  // The image and video payloads are views into the file bytes either way. A mapping only loads
+  // the pages actually accessed, but it is unsafe if the file is changed on disk, so it is used
+  // only when the caller asks for it.
+  std::unique_ptr<ByteData> fileBytes = nullptr;
+  if (mapFile) {
+    fileBytes = MapFileBytes(filePath);
   }
-  return pag::File::Load(byteData->data(), byteData->length(), filePath);
+  if (fileBytes == nullptr) {
+    fileBytes = ByteData::FromPath(filePath);
+    if (fileBytes == nullptr) {
+      return nullptr;
+    }
+  }
+  file = Codec::Decode(std::move(fileBytes), filePath);
+  if (file != nullptr) {
+    AddFileToCache(filePath, file);
+  }
+  return file;
 }
 
 uint16_t File::MaxSupportedTagLevel() {
@@ -74,9 +98,7 @@ std::shared_ptr<File> File::Load(const void* bytes, size_t length, const std::st
   }
   file = Codec::Decode(bytes, static_cast<uint32_t>(length), filePath);
   if (file != nullptr) {
-    std::lock_guard<std::mutex> autoLock(globalLocker);
-    std::weak_ptr<File> weak = file;
-    weakFileMap.insert(std::make_pair(filePath, std::move(weak)));
+    AddFileToCache(filePath, file);
   }
   return file;
 }
@@ -242,4 +264,8 @@ std::vector<ImageLayer*> File::getImageAt(int index) const {
 bool File::hasScaledTimeRange() const {
   return scaledTimeRange.start != 0 || scaledTimeRange.end != mainComposition->duration;
 }
+
+int64_t File::bakedMemory() const {
+  return _bakedMemory;
+}
 }  // namespace pag
@@ -49,4 +49,36 @@ Frame Sequence::toSequenceFrame(Frame compositionFrame) {
   }
   return sequenceFrame;
 }
+
+bool Sequence::framesDeferred() const {
+  return deferred.load(std::memory_order_acquire);
+}
+
+void Sequence::decodeFrames() {
+  if (!framesDeferred()) {
+    return;
+  }
+  std::lock_guard<std::mutex> autoLock(frameLocker);
+  if (frameDecoder == nullptr) {
+    return;
+  }
+  frameDecoder(this);
+  frameDecoder = nullptr;
+  deferred.store(false, std::memory_order_release);
+}
+
+void Sequence::deferFrames(Frame frameCount, std::function<void(Sequence*)> decoder,
+                           std::function<bool()> validator) {
+  std::lock_guard<std::mutex> autoLock(frameLocker);
+  deferredFrameCount = frameCount;
+  frameDecoder = std::move(decoder);
+  frameValidator = std::move(validator);
+  deferred.store(frameDecoder != nullptr, std::memory_order_release);
+}
+
+bool Sequence::verifyDeferredFrames() const {
+  std::lock_guard<std::mutex> autoLock(frameLocker);
+  // The validator is kept after decoding, the deferred data lives as long as the file.
+  VerifyAndReturn(frameValidator != nullptr && frameValidator());
+}
 }  // namespace pag
\ No newline at end of file
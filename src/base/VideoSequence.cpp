@@ -35,10 +35,14 @@ VideoSequence::~VideoSequence() {
 }
 
 bool VideoSequence::verify() const {
-  if (!Sequence::verify() || frames.empty()) {
+  if (!Sequence::verify() || duration() <= 0) {
     VerifyFailed();
     return false;
   }
+  if (framesDeferred()) {
+    // The frames are still empty, checks the data they will be decoded from instead.
+    return verifyDeferredFrames();
+  }
   auto frameNotNull = [](VideoFrame* frame) {
     return frame != nullptr && frame->fileBytes != nullptr;
   };
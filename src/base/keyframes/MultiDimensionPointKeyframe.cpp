@@ -43,4 +43,21 @@ Point MultiDimensionPointKeyframe::getValueAt(Frame time) {
   return {x, y};
 }
 
+void MultiDimensionPointKeyframe::getValuesAt(Frame startFrame, size_t count, Point* values) {
+  std::vector<float> progresses(count);
+  std::vector<float> xProgresses(count);
+  std::vector<float> yProgresses(count);
+  auto duration = static_cast<float>(this->endTime - this->startTime);
+  for (size_t i = 0; i < count; i++) {
+    progresses[i] =
+        static_cast<float>(startFrame + static_cast<Frame>(i) - this->startTime) / duration;
+  }
+  xInterpolator->getInterpolations(progresses.data(), xProgresses.data(), count);
+  yInterpolator->getInterpolations(progresses.data(), yProgresses.data(), count);
+  for (size_t i = 0; i < count; i++) {
+    values[i] = {Interpolate(this->startValue.x, this->endValue.x, xProgresses[i]),
+                 Interpolate(this->startValue.y, this->endValue.y, yProgresses[i])};
+  }
+}
+
 }  // namespace pag
\ No newline at end of file
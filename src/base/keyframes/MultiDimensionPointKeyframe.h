@@ -30,6 +30,8 @@ class MultiDimensionPointKeyframe : public Keyframe<Point> {
 
   Point getValueAt(Frame time) override;
 
+  void getValuesAt(Frame startFrame, size_t count, Point* values) override;
+
  private:
   Interpolator* xInterpolator = nullptr;
   Interpolator* yInterpolator = nullptr;
@@ -47,6 +47,19 @@ class SingleEaseKeyframe : public Keyframe<T> {
     return Interpolate(this->startValue, this->endValue, progress);
   }
 
+  void getValuesAt(Frame startFrame, size_t count, T* values) override {
+    std::vector<float> progresses(count);
+    auto duration = static_cast<float>(this->endTime - this->startTime);
+    for (size_t i = 0; i < count; i++) {
+      progresses[i] = static_cast<float>(startFrame + static_cast<Frame>(i) - this->startTime) /
+                      duration;
+    }
+    interpolator->getInterpolations(progresses.data(), progresses.data(), count);
+    for (size_t i = 0; i < count; i++) {
+      values[i] = Interpolate(this->startValue, this->endValue, progresses[i]);
+    }
+  }
+
  private:
   Interpolator* interpolator = nullptr;
 };
@@ -17,10 +17,21 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "BezierEasing.h"
+#include <algorithm>
 
 namespace pag {
 BezierEasing::BezierEasing(const Point& control1, const Point& control2) {
   bezierPath = BezierPath::Build(Point::Zero(), control1, control2, Point::Make(1, 1), 0.005f);
+  auto& segments = bezierPath->segments;
+  auto lastIndex = static_cast<uint32_t>(segments.size() - 1);
+  uint32_t index = 0;
+  for (int i = 0; i <= BEZIER_EASING_TABLE_SIZE; i++) {
+    auto x = static_cast<float>(i) / BEZIER_EASING_TABLE_SIZE;
+    while (index + 1 < lastIndex && segments[index + 1].position.x <= x) {
+      index++;
+    }
+    segmentTable[i] = index;
+  }
 }
 
 float BezierEasing::getInterpolation(float input) {
@@ -30,6 +41,38 @@ float BezierEasing::getInterpolation(float input) {
   if (input >= 1) {
     return 1;
   }
-  return bezierPath->getY(input);
+  return getY(input);
+}
+
+void BezierEasing::getInterpolations(const float* inputs, float* outputs, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    auto input = inputs[i];
+    outputs[i] = input <= 0 ? 0 : (input >= 1 ? 1 : getY(input));
+  }
+}
+
+float BezierEasing::getY(float x) const {
+  // Same as BezierPath::getY(), but only searches the segments around the table entry of x.
+  auto& segments = bezierPath->segments;
+  auto tableIndex =
+      std::min(static_cast<int>(x * BEZIER_EASING_TABLE_SIZE), BEZIER_EASING_TABLE_SIZE - 1);
+  auto startIndex = static_cast<int>(segmentTable[tableIndex]);
+  auto endIndex = static_cast<int>(segmentTable[tableIndex + 1]) + 1;
+  while (endIndex - startIndex > 1) {
+    auto middleIndex = (startIndex + endIndex) >> 1;
+    if (x < segments[middleIndex].position.x) {
+      endIndex = middleIndex;
+    } else {
+      startIndex = middleIndex;
+    }
+  }
+  auto& start = segments[startIndex].position;
+  auto& end = segments[endIndex].position;
+  auto xRange = end.x - start.x;
+  if (xRange == 0) {
+    return start.y;
+  }
+  auto fraction = (x - start.x) / xRange;
+  return Interpolate(start.y, end.y, fraction);
 }
-}  // namespace pag
\ No newline at end of file
+}  // namespace pag
@@ -22,6 +22,8 @@
 #include "Interpolator.h"
 
 namespace pag {
+#define BEZIER_EASING_TABLE_SIZE 32
+
 class BezierEasing : public Interpolator {
  public:
   BezierEasing(const Point& control1, const Point& control2);
@@ -37,7 +39,14 @@ class BezierEasing : public Interpolator {
    */
   float getInterpolation(float input) override;
 
+  void getInterpolations(const float* inputs, float* outputs, size_t count) override;
+
  private:
   std::shared_ptr<BezierPath> bezierPath = nullptr;
+  // The index of the last polyline segment of bezierPath that starts at or before each of the
+  // evenly spaced x values, which narrows the segment search down to one or two segments.
+  uint32_t segmentTable[BEZIER_EASING_TABLE_SIZE + 1] = {};
+
+  float getY(float x) const;
 };
 }  // namespace pag
@@ -89,5 +89,7 @@ class BezierPath {
 
   BezierPath() = default;
   void findSegmentAtDistance(float distance, int& startIndex, int& endIndex, float& fraction) const;
+
+  friend class BezierEasing;
 };
 }  // namespace pag
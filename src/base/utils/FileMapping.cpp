@@ -0,0 +1,65 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "FileMapping.h"
+
+#if !defined(_WIN32) && !defined(PAG_BUILD_FOR_WEB)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define PAG_USE_MMAP
+#endif
+
+namespace pag {
+#ifdef PAG_USE_MMAP
+
+std::unique_ptr<ByteData> MapFileBytes(const std::string& filePath) {
+  if (filePath.empty()) {
+    return nullptr;
+  }
+  auto fd = open(filePath.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return nullptr;
+  }
+  struct stat fileStat = {};
+  if (fstat(fd, &fileStat) != 0 || fileStat.st_size <= 0) {
+    close(fd);
+    return nullptr;
+  }
+  auto length = static_cast<size_t>(fileStat.st_size);
+  // MAP_PRIVATE + PROT_WRITE gives us copy-on-write pages, the decoder may patch a few bytes in
+  // place (e.g. the start codes of video frames) without touching the file on disk.
+  auto address = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  // The mapping stays valid after the file descriptor is closed.
+  close(fd);
+  if (address == MAP_FAILED) {
+    return nullptr;
+  }
+  return ByteData::MakeAdopted(reinterpret_cast<uint8_t*>(address), length,
+                               [length](uint8_t* data) { munmap(data, length); });
+}
+
+#else
+
+std::unique_ptr<ByteData> MapFileBytes(const std::string&) {
+  return nullptr;
+}
+
+#endif
+}  // namespace pag
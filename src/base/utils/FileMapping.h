@@ -0,0 +1,33 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "pag/types.h"
+
+namespace pag {
+/**
+ * Maps the file at the specified path into memory with a private copy-on-write mapping. Returns
+ * nullptr if the file can not be mapped or memory mapping is not supported on the current
+ * platform. The file is unmapped when the returned ByteData is released. Pages are loaded from disk
+ * only when they are accessed, and writing to the returned bytes never modifies the file. The
+ * caller must make sure the file is not modified or truncated while the mapping is alive, the
+ * untouched pages reflect the changes on disk and accessing truncated pages raises SIGBUS.
+ */
+std::unique_ptr<ByteData> MapFileBytes(const std::string& filePath);
+}  // namespace pag
@@ -37,5 +37,15 @@ class Interpolator {
   virtual float getInterpolation(float input) {
     return input;
   }
+
+  /**
+   * Maps count values at once, which is the same as calling getInterpolation() for each of them
+   * but saves the virtual call per value. The inputs and outputs may point to the same memory.
+   */
+  virtual void getInterpolations(const float* inputs, float* outputs, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+      outputs[i] = inputs[i];
+    }
+  }
 };
 }  // namespace pag
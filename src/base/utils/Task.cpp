@@ -20,6 +20,7 @@
 
 #include "Task.h"
 #include <algorithm>
+#include "pag/pag.h"
 
 #ifdef __APPLE__
 
@@ -44,25 +45,153 @@ int GetCPUCores() {
   return cpuCores;
 }
 
+class FunctionExecutor : public Executor {
+ public:
+  explicit FunctionExecutor(std::function<void()> job) : job(std::move(job)) {
+  }
+
+ private:
+  std::function<void()> job = nullptr;
+
+  void execute() override {
+    job();
+  }
+};
+
+class ThreadPoolExecutor : public TaskExecutor {
+ public:
+  explicit ThreadPoolExecutor(int maxThreads) : taskGroup(maxThreads) {
+  }
+
+  void execute(std::function<void()> job, bool urgent) override {
+    // Nobody waits for jobs submitted directly, the worker deletes the task after executing.
+    auto task = new Task(std::make_unique<FunctionExecutor>(std::move(job)));
+    task->detached = true;
+    task->running = true;
+    task->taskGroup = &taskGroup;
+    task->priority = urgent ? TaskPriority::Urgent : TaskPriority::Prefetch;
+    taskGroup.pushTask(task);
+  }
+
+ private:
+  TaskGroup taskGroup;
+
+  TaskGroup* getTaskGroup() override {
+    return &taskGroup;
+  }
+};
+
+class InlineExecutor : public TaskExecutor {
+ public:
+  void execute(std::function<void()> job, bool) override {
+    job();
+  }
+};
+
+std::shared_ptr<TaskExecutor> TaskExecutor::MakeThreadPool(int maxThreads) {
+  return std::make_shared<ThreadPoolExecutor>(maxThreads);
+}
+
+std::shared_ptr<TaskExecutor> TaskExecutor::MakeInline() {
+  return std::make_shared<InlineExecutor>();
+}
+
+static std::mutex executorLocker = {};
+static std::shared_ptr<TaskExecutor> globalExecutor = nullptr;
+
+void PAG::SetTaskExecutor(std::shared_ptr<TaskExecutor> executor) {
+  std::lock_guard<std::mutex> autoLock(executorLocker);
+  globalExecutor = std::move(executor);
+}
+
+static std::shared_ptr<TaskExecutor> GetTaskExecutor() {
+  std::lock_guard<std::mutex> autoLock(executorLocker);
+  return globalExecutor;
+}
+
+// The TaskGroup and queue index of the current worker thread, used to push tasks created by a
+// worker into its own queue.
+static thread_local TaskGroup* currentGroup = nullptr;
+static thread_local size_t currentQueue = 0;
+
 std::shared_ptr<Task> Task::Make(std::unique_ptr<Executor> executor) {
-  return std::shared_ptr<Task>(new Task(std::move(executor)));
+  auto task = std::shared_ptr<Task>(new Task(std::move(executor)));
+  task->weakThis = task;
+  return task;
+}
+
+std::shared_ptr<Task> Task::MakeAfter(const std::vector<std::shared_ptr<Task>>& dependencies,
+                                      std::unique_ptr<Executor> executor,
+                                      TaskPriority priority) {
+  auto task = Make(std::move(executor));
+  {
+    std::lock_guard<std::mutex> autoLock(task->locker);
+    task->running = true;
+    task->priority = priority;
+    task->dependencies = dependencies;
+    // Holds one extra count until all dependencies are registered, in case the task is dispatched
+    // halfway.
+    task->pendingDependencies = dependencies.size() + 1;
+  }
+  for (auto& dependency : dependencies) {
+    if (dependency == nullptr || !dependency->addContinuation(task)) {
+      task->onDependencyFinished();
+    }
+  }
+  task->onDependencyFinished();
+  return task;
 }
 
 Task::Task(std::unique_ptr<Executor> executor) : executor(std::move(executor)) {
-  taskGroup = TaskGroup::GetInstance();
 }
 
 Task::~Task() {
   cancel();
 }
 
-void Task::run() {
-  std::lock_guard<std::mutex> autoLock(locker);
+float Task::QueueLoad() {
+  auto taskExecutor = GetTaskExecutor();
+  auto taskGroup = taskExecutor ? taskExecutor->getTaskGroup() : TaskGroup::GetInstance();
+  if (taskGroup == nullptr || taskGroup->queues.empty()) {
+    return 0;
+  }
+  auto pendingTasks = static_cast<float>(taskGroup->pendingTasks.load());
+  return pendingTasks / static_cast<float>(taskGroup->queues.size());
+}
+
+void Task::run(TaskPriority taskPriority) {
+  std::unique_lock<std::mutex> autoLock(locker);
   if (running) {
     return;
   }
   running = true;
-  taskGroup->pushTask(this);
+  dispatch(autoLock, taskPriority);
+}
+
+std::shared_ptr<Task> Task::then(std::unique_ptr<Executor> nextExecutor, TaskPriority priority) {
+  return MakeAfter({weakThis.lock()}, std::move(nextExecutor), priority);
+}
+
+void Task::dispatch(std::unique_lock<std::mutex>& autoLock, TaskPriority taskPriority) {
+  taskExecutor = GetTaskExecutor();
+  taskGroup = taskExecutor ? taskExecutor->getTaskGroup() : TaskGroup::GetInstance();
+  if (taskGroup != nullptr) {
+    priority = taskPriority;
+    taskGroup->pushTask(this);
+    return;
+  }
+  auto customExecutor = taskExecutor;
+  // The job may be executed synchronously, so it must be dispatched without holding the locker.
+  autoLock.unlock();
+  std::weak_ptr<Task> weakTask = weakThis;
+  customExecutor->execute(
+      [weakTask]() {
+        auto task = weakTask.lock();
+        if (task) {
+          task->executeIfPending();
+        }
+      },
+      taskPriority == TaskPriority::Urgent);
 }
 
 bool Task::isRunning() {
@@ -72,10 +201,33 @@ bool Task::isRunning() {
 
 Executor* Task::wait() {
   std::unique_lock<std::mutex> autoLock(locker);
+  if (pendingDependencies > 0) {
+    urgentRequested = true;
+    auto taskDependencies = dependencies;
+    autoLock.unlock();
+    for (auto& dependency : taskDependencies) {
+      if (dependency) {
+        dependency->wait();
+      }
+    }
+    autoLock.lock();
+    // The last dependency may have finished but not dispatched this task yet.
+    condition.wait(autoLock, [this] { return pendingDependencies == 0 || !running; });
+  }
   if (!running) {
     return executor.get();
   }
-  condition.wait(autoLock);
+  if (taskGroup != nullptr) {
+    // Someone is blocked on this task now, it should not stay behind any prefetch work.
+    taskGroup->promoteTask(this);
+  } else if (!executing) {
+    // We have no control over the queue of a custom TaskExecutor, run the task here instead.
+    executing = true;
+    autoLock.unlock();
+    execute();
+    return executor.get();
+  }
+  condition.wait(autoLock, [this] { return !running; });
   return executor.get();
 }
 
@@ -84,85 +236,237 @@ void Task::cancel() {
   if (!running) {
     return;
   }
-  if (taskGroup->removeTask(this)) {
-    running = false;
+  bool removed = false;
+  if (pendingDependencies > 0) {
+    pendingDependencies = 0;
+    removed = true;
+  } else if (taskGroup != nullptr) {
+    removed = taskGroup->removeTask(this);
+  } else {
+    // The job left in a custom TaskExecutor will find the task is not running and return.
+    removed = !executing;
+  }
+  if (!removed) {
+    condition.wait(autoLock, [this] { return !running; });
     return;
   }
-  condition.wait(autoLock);
+  running = false;
+  condition.notify_all();
+  auto cancelledTasks = std::move(continuations);
+  continuations = {};
+  autoLock.unlock();
+  for (auto& weakTask : cancelledTasks) {
+    auto task = weakTask.lock();
+    if (task) {
+      task->cancel();
+    }
+  }
 }
 
 void Task::execute() {
   executor->execute();
-  std::lock_guard<std::mutex> auoLock(locker);
-  running = false;
+  std::vector<std::weak_ptr<Task>> finishedTasks = {};
+  {
+    std::lock_guard<std::mutex> auoLock(locker);
+    running = false;
+    executing = false;
+    finishedTasks.swap(continuations);
+    condition.notify_all();
+  }
+  // The continuations hold references to this task, no need to worry about being destroyed here.
+  for (auto& weakTask : finishedTasks) {
+    auto task = weakTask.lock();
+    if (task) {
+      task->onDependencyFinished();
+    }
+  }
+}
+
+bool Task::addContinuation(std::shared_ptr<Task> task) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  if (!running) {
+    return false;
+  }
+  continuations.push_back(task);
+  return true;
+}
+
+void Task::onDependencyFinished() {
+  std::unique_lock<std::mutex> autoLock(locker);
+  if (!running || pendingDependencies == 0) {
+    return;
+  }
+  pendingDependencies--;
+  if (pendingDependencies > 0) {
+    return;
+  }
   condition.notify_all();
+  dispatch(autoLock, urgentRequested ? TaskPriority::Urgent : priority);
+}
+
+void Task::executeIfPending() {
+  {
+    std::lock_guard<std::mutex> autoLock(locker);
+    if (!running || executing) {
+      return;
+    }
+    executing = true;
+  }
+  execute();
 }
 
 TaskGroup* TaskGroup::GetInstance() {
-  static TaskGroup taskGroup = {};
+  static const int CPUCores = GetCPUCores();
+  static TaskGroup taskGroup(CPUCores > 16 ? 16 : CPUCores);
   return &taskGroup;
 }
 
-void TaskGroup::RunLoop(TaskGroup* taskGroup) {
+void TaskGroup::RunLoop(TaskGroup* taskGroup, size_t queueIndex) {
+  currentGroup = taskGroup;
+  currentQueue = queueIndex;
   while (true) {
-    auto task = taskGroup->popTask();
+    auto task = taskGroup->popTask(queueIndex);
     if (!task) {
       break;
     }
+    auto detached = task->detached;
     task->execute();
+    if (detached) {
+      delete task;
+    }
+    if (currentGroup != taskGroup) {
+      // The TaskGroup was destroyed by the task that just finished, don't touch it anymore.
+      break;
+    }
   }
 }
 
-TaskGroup::TaskGroup() {
-  static const int CPUCores = GetCPUCores();
-  auto maxThreads = CPUCores > 16 ? 16 : CPUCores;
-  activeThreads = maxThreads;
-  for (int i = 0; i < maxThreads; i++) {
-    threads.emplace_back(&TaskGroup::RunLoop, this);
+TaskGroup::TaskGroup(int threadCount) {
+  if (threadCount <= 0) {
+    threadCount = 1;
+  }
+  for (int i = 0; i < threadCount; i++) {
+    queues.push_back(new TaskQueue());
+  }
+  for (int i = 0; i < threadCount; i++) {
+    threads.emplace_back(&TaskGroup::RunLoop, this, static_cast<size_t>(i));
   }
 }
 
 TaskGroup::~TaskGroup() {
   exit();
+  auto currentThreadID = std::this_thread::get_id();
   for (auto& thread : threads) {
-    if (thread.joinable()) {
+    if (!thread.joinable()) {
+      continue;
+    }
+    if (thread.get_id() == currentThreadID) {
+      // The last reference is dropped from one of our own workers, which can not join itself.
+      thread.detach();
+    } else {
       thread.join();
     }
   }
+  if (currentGroup == this) {
+    currentGroup = nullptr;
+  }
+  // Every task pushed into the queues must be executed exactly once, runs the ones that were left
+  // behind by the workers on the current thread.
+  while (auto task = tryPopTask(0)) {
+    auto detached = task->detached;
+    task->execute();
+    if (detached) {
+      delete task;
+    }
+  }
+  for (auto queue : queues) {
+    delete queue;
+  }
 }
 
 void TaskGroup::pushTask(Task* task) {
-  std::lock_guard<std::mutex> autoLock(locker);
-  tasks.push_back(task);
-  condition.notify_one();
+  // Tasks pushed from a worker stay in its own queue, others are spread over all queues.
+  auto queueIndex =
+      currentGroup == this ? currentQueue : nextQueue.fetch_add(1) % queues.size();
+  auto queue = queues[queueIndex];
+  {
+    std::lock_guard<std::mutex> autoLock(queue->locker);
+    task->queueIndex = queueIndex;
+    queue->tasks[static_cast<int>(task->priority)].push_back(task);
+  }
+  pendingTasks++;
+  // Only touch the shared locker when there is a worker to wake up. A worker always increases
+  // sleepingThreads before checking pendingTasks, so at least one side will see the other.
+  if (sleepingThreads > 0) {
+    std::lock_guard<std::mutex> autoLock(locker);
+    condition.notify_one();
+  }
 }
 
-Task* TaskGroup::popTask() {
-  std::unique_lock<std::mutex> autoLock(locker);
-  activeThreads--;
-  while (true) {
-    if (tasks.empty()) {
-      condition.wait(autoLock);
-      if (exited) {
-        return nullptr;
+Task* TaskGroup::tryPopTask(size_t queueIndex) {
+  auto queueCount = queues.size();
+  for (int priority = 0; priority < TASK_PRIORITY_COUNT; priority++) {
+    // Checks the worker's own queue first, then steals from the others.
+    for (size_t i = 0; i < queueCount; i++) {
+      auto queue = queues[(queueIndex + i) % queueCount];
+      std::lock_guard<std::mutex> autoLock(queue->locker);
+      auto& tasks = queue->tasks[priority];
+      if (!tasks.empty()) {
+        auto task = tasks.front();
+        tasks.pop_front();
+        pendingTasks--;
+        return task;
       }
-    } else {
-      auto task = tasks.front();
-      tasks.pop_front();
-      activeThreads++;
-      // LOGI("TaskGroup.activeThreads : %d", activeThreads);
+    }
+  }
+  return nullptr;
+}
+
+Task* TaskGroup::popTask(size_t queueIndex) {
+  while (true) {
+    auto task = tryPopTask(queueIndex);
+    if (task) {
       return task;
     }
+    std::unique_lock<std::mutex> autoLock(locker);
+    if (exited) {
+      return nullptr;
+    }
+    sleepingThreads++;
+    if (pendingTasks == 0) {
+      condition.wait(autoLock);
+    }
+    sleepingThreads--;
   }
 }
 
+bool TaskGroup::promoteTask(Task* task) {
+  auto queue = queues[task->queueIndex];
+  std::lock_guard<std::mutex> autoLock(queue->locker);
+  if (task->priority == TaskPriority::Urgent) {
+    return false;
+  }
+  auto& tasks = queue->tasks[static_cast<int>(task->priority)];
+  auto position = std::find(tasks.begin(), tasks.end(), task);
+  if (position == tasks.end()) {
+    return false;
+  }
+  tasks.erase(position);
+  task->priority = TaskPriority::Urgent;
+  queue->tasks[static_cast<int>(TaskPriority::Urgent)].push_back(task);
+  return true;
+}
+
 bool TaskGroup::removeTask(Task* task) {
-  std::lock_guard<std::mutex> autoLock(locker);
+  auto queue = queues[task->queueIndex];
+  std::lock_guard<std::mutex> autoLock(queue->locker);
+  auto& tasks = queue->tasks[static_cast<int>(task->priority)];
   auto position = std::find(tasks.begin(), tasks.end(), task);
   if (position == tasks.end()) {
     return false;
   }
   tasks.erase(position);
+  pendingTasks--;
   return true;
 }
 
@@ -173,4 +477,29 @@ void TaskGroup::exit() {
 }
 }  // namespace pag
 
+#else
+
+#include "pag/pag.h"
+
+namespace pag {
+class InlineExecutor : public TaskExecutor {
+ public:
+  void execute(std::function<void()> job, bool) override {
+    job();
+  }
+};
+
+std::shared_ptr<TaskExecutor> TaskExecutor::MakeThreadPool(int) {
+  return nullptr;
+}
+
+std::shared_ptr<TaskExecutor> TaskExecutor::MakeInline() {
+  return std::make_shared<InlineExecutor>();
+}
+
+void PAG::SetTaskExecutor(std::shared_ptr<TaskExecutor>) {
+  // Tasks are always executed on the render thread on the web platform.
+}
+}  // namespace pag
+
 #endif
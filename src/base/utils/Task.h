@@ -20,13 +20,33 @@
 
 #ifndef PAG_BUILD_FOR_WEB
 
+#include <atomic>
 #include <condition_variable>
-#include <list>
+#include <deque>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <vector>
+#include "pag/executor.h"
 
 namespace pag {
+/**
+ * Defines the scheduling classes of tasks. Urgent tasks are always picked up before any prefetch
+ * task, no matter which worker queue they are sitting in.
+ */
+enum class TaskPriority {
+  /**
+   * The result is needed (or will be needed very soon) by the render thread.
+   */
+  Urgent = 0,
+  /**
+   * Speculative look-ahead work, such as decoding images or sequences before they become visible.
+   */
+  Prefetch = 1
+};
+
+#define TASK_PRIORITY_COUNT 2
+
 class Executor {
  public:
   virtual ~Executor() = default;
@@ -42,24 +62,87 @@ class TaskGroup;
 class Task {
  public:
   static std::shared_ptr<Task> Make(std::unique_ptr<Executor> executor);
+
+  /**
+   * Returns the average number of tasks waiting for each thread of the thread pool that new tasks
+   * are dispatched to, which indicates how long a new task has to wait before it starts. Returns 0
+   * if tasks are dispatched to a custom TaskExecutor.
+   */
+  static float QueueLoad();
+
+  /**
+   * Creates a Task that is scheduled with the specified priority once all the dependencies have
+   * finished. The returned task is running from the beginning, dependencies that are not running
+   * are treated as finished. If any dependency is cancelled, the returned task is cancelled too.
+   * The dependencies are kept alive until the returned task is destroyed, so their executors are
+   * still accessible from the executor of the returned task.
+   */
+  static std::shared_ptr<Task> MakeAfter(const std::vector<std::shared_ptr<Task>>& dependencies,
+                                         std::unique_ptr<Executor> executor,
+                                         TaskPriority priority = TaskPriority::Prefetch);
+
   ~Task();
 
-  void run();
+  /**
+   * Schedules the task to run on the current TaskExecutor with the specified priority, or on the
+   * default thread pool if no TaskExecutor is set. Does nothing if the task is already running.
+   */
+  void run(TaskPriority priority = TaskPriority::Prefetch);
   bool isRunning();
+  /**
+   * Blocks until the task finishes. If the task is still waiting in a built-in thread pool, it is
+   * promoted to TaskPriority::Urgent first. If it is waiting in a custom TaskExecutor, it is
+   * executed on the calling thread immediately.
+   */
   Executor* wait();
   void cancel();
 
+  /**
+   * Creates a Task that runs the specified executor after this task finishes. This is a shortcut
+   * for Task::MakeAfter() with this task as the only dependency.
+   */
+  std::shared_ptr<Task> then(std::unique_ptr<Executor> executor,
+                             TaskPriority priority = TaskPriority::Prefetch);
+
  private:
   std::mutex locker = {};
   std::condition_variable condition = {};
   bool running = false;
+  bool executing = false;
+  bool detached = false;
+  bool urgentRequested = false;
+  size_t pendingDependencies = 0;
+  std::vector<std::shared_ptr<Task>> dependencies = {};
+  std::vector<std::weak_ptr<Task>> continuations = {};
+  std::weak_ptr<Task> weakThis;
+  // Keeps the TaskExecutor the task was dispatched to alive until the task is destroyed.
+  std::shared_ptr<TaskExecutor> taskExecutor = nullptr;
+  // The thread pool the task is pushed into, or nullptr if it was dispatched to a custom
+  // TaskExecutor.
   TaskGroup* taskGroup = nullptr;
   std::unique_ptr<Executor> executor = nullptr;
+  // The following fields are guarded by the locker of the TaskQueue the task is pushed into.
+  size_t queueIndex = 0;
+  TaskPriority priority = TaskPriority::Prefetch;
 
   explicit Task(std::unique_ptr<Executor> executor);
+  void dispatch(std::unique_lock<std::mutex>& autoLock, TaskPriority taskPriority);
   void execute();
+  void executeIfPending();
+  bool addContinuation(std::shared_ptr<Task> task);
+  void onDependencyFinished();
 
   friend class TaskGroup;
+  friend class ThreadPoolExecutor;
+};
+
+/**
+ * A task queue owned by one worker thread. Workers always take the oldest task first, either from
+ * their own queue or by stealing from the others.
+ */
+struct TaskQueue {
+  std::mutex locker = {};
+  std::deque<Task*> tasks[TASK_PRIORITY_COUNT] = {};
 };
 
 class TaskGroup {
@@ -69,28 +152,36 @@ class TaskGroup {
  private:
   std::mutex locker = {};
   std::condition_variable condition = {};
-  int activeThreads = 0;
   bool exited = false;
-  std::list<Task*> tasks = {};
+  std::atomic_int sleepingThreads = {0};
+  std::atomic_int pendingTasks = {0};
+  std::atomic_size_t nextQueue = {0};
+  std::vector<TaskQueue*> queues = {};
   std::vector<std::thread> threads = {};
 
   static TaskGroup* GetInstance();
-  static void RunLoop(TaskGroup* taskGroup);
+  static void RunLoop(TaskGroup* taskGroup, size_t queueIndex);
 
-  TaskGroup();
+  explicit TaskGroup(int threadCount);
   void pushTask(Task* task);
-  Task* popTask();
+  Task* popTask(size_t queueIndex);
+  Task* tryPopTask(size_t queueIndex);
+  bool promoteTask(Task* task);
   bool removeTask(Task* task);
   void exit();
 
   friend class Task;
+  friend class ThreadPoolExecutor;
 };
 }  // namespace pag
 #else
 
 #include <memory>
+#include <vector>
 
 namespace pag {
+enum class TaskPriority { Urgent = 0, Prefetch = 1 };
+
 class Executor {
  public:
   virtual ~Executor() = default;
@@ -104,17 +195,36 @@ class Executor {
 class Task {
  public:
   static std::shared_ptr<Task> Make(std::unique_ptr<Executor> executor) {
-    return std::shared_ptr<Task>(new Task(std::move(executor)));
+    auto task = std::shared_ptr<Task>(new Task(std::move(executor)));
+    task->weakThis = task;
+    return task;
+  }
+
+  static float QueueLoad() {
+    return 0;
   }
 
-  void run() {
+  void run(TaskPriority = TaskPriority::Prefetch) {
   }
 
   bool isRunning() const {
     return running;
   }
 
+  static std::shared_ptr<Task> MakeAfter(const std::vector<std::shared_ptr<Task>>& dependencies,
+                                         std::unique_ptr<Executor> executor,
+                                         TaskPriority = TaskPriority::Prefetch) {
+    auto task = Make(std::move(executor));
+    task->dependencies = dependencies;
+    return task;
+  }
+
   Executor* wait() {
+    for (auto& dependency : dependencies) {
+      if (dependency) {
+        dependency->wait();
+      }
+    }
     running = true;
     executor->execute();
     running = false;
@@ -124,8 +234,15 @@ class Task {
   void cancel() {
   }
 
+  std::shared_ptr<Task> then(std::unique_ptr<Executor> executor,
+                             TaskPriority priority = TaskPriority::Prefetch) {
+    return MakeAfter({weakThis.lock()}, std::move(executor), priority);
+  }
+
  private:
   bool running = false;
+  std::weak_ptr<Task> weakThis;
+  std::vector<std::shared_ptr<Task>> dependencies = {};
   std::unique_ptr<Executor> executor = nullptr;
 
   explicit Task(std::unique_ptr<Executor> executor) : executor(std::move(executor)) {
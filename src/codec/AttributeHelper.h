@@ -242,7 +242,15 @@ Property<T>* ReadProperty(DecodeStream* stream, const AttributeConfig<T>& config
       if (flag.hasSpatial) {
         ReadSpatialEase(stream, keyframes);
       }
-      property = new AnimatableProperty<T>(keyframes);
+      auto animatableProperty = new AnimatableProperty<T>(keyframes);
+      if constexpr (BakedValue<T>::Components > 0) {
+        auto context = static_cast<CodecContext*>(stream->context);
+        if (context->propertyBakingEnabled) {
+          context->propertyBakers.push_back(
+              [animatableProperty]() { return animatableProperty->bake(); });
+        }
+      }
+      property = animatableProperty;
     } else {
       property = new Property<T>();
       property->value = ReadValue(stream, config, flag);
@@ -16,9 +16,12 @@
 //
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include <atomic>
+#include <limits>
 #include <unordered_map>
 #include <unordered_set>
 #include "Compression.h"
+#include "base/utils/Task.h"
 #include "base/utils/USE.h"
 #include "base/utils/Verify.h"
 #include "codec/Version.h"
@@ -30,6 +33,12 @@ namespace pag {
 
 static const uint8_t CompatibleVersion = 2;
 
+static std::atomic_bool parallelDecodingEnabled = {false};
+static std::atomic_bool propertyBakingEnabled = {false};
+
+// The number of properties baked by one task.
+#define PROPERTY_BAKING_BATCH_SIZE 64
+
 static bool HasTrackMatte(Enum type) {
   switch (type) {
     case TrackMatteType::Alpha:
@@ -44,6 +53,61 @@ uint16_t Codec::MaxSupportedTagLevel() {
   return static_cast<uint16_t>(TagCode::Count) - 1;
 }
 
+void Codec::SetParallelDecodingEnabled(bool enabled) {
+  parallelDecodingEnabled = enabled;
+}
+
+void Codec::SetPropertyBakingEnabled(bool enabled) {
+  propertyBakingEnabled = enabled;
+}
+
+class PropertyBakingTask : public Executor {
+ public:
+  explicit PropertyBakingTask(std::vector<std::function<size_t()>> bakers)
+      : bakers(std::move(bakers)) {
+  }
+
+  void bake() {
+    for (auto& baker : bakers) {
+      memoryCost += static_cast<int64_t>(baker());
+    }
+    bakers.clear();
+  }
+
+  int64_t getMemoryCost() const {
+    return memoryCost;
+  }
+
+ private:
+  std::vector<std::function<size_t()>> bakers;
+  int64_t memoryCost = 0;
+
+  void execute() override {
+    bake();
+  }
+};
+
+static int64_t BakeProperties(std::vector<std::function<size_t()>> bakers) {
+  std::vector<std::shared_ptr<Task>> tasks = {};
+  for (size_t start = 0; start < bakers.size(); start += PROPERTY_BAKING_BATCH_SIZE) {
+    auto end = std::min(start + PROPERTY_BAKING_BATCH_SIZE, bakers.size());
+    std::vector<std::function<size_t()>> batch(bakers.begin() + start, bakers.begin() + end);
+    auto task = Task::Make(std::make_unique<PropertyBakingTask>(std::move(batch)));
+    task->run(TaskPriority::Urgent);
+    tasks.push_back(task);
+  }
+  int64_t memoryCost = 0;
+  for (auto& task : tasks) {
+    // Take back the batches that no thread has picked up yet and bake them on the current thread,
+    // which may be a worker of the task executor itself.
+    task->cancel();
+    auto baker = static_cast<PropertyBakingTask*>(task->wait());
+    baker->bake();
+    memoryCost += baker->getMemoryCost();
+  }
+  return memoryCost;
+}
+
 void Codec::InstallReferences(Layer* layer) {
   std::unordered_map<ID, MaskData*> maskMap;
   for (auto mask : layer->masks) {
@@ -196,19 +260,46 @@ DecodeStream ReadBodyBytes(DecodeStream* stream) {
 std::shared_ptr<File> Codec::Decode(const void* bytes, uint32_t byteLength,
                                     const std::string& filePath) {
   CodecContext context = {};
-  DecodeStream stream(&context, reinterpret_cast<const uint8_t*>(bytes), byteLength);
+  return Decode(&context, bytes, byteLength, filePath);
+}
+
+std::shared_ptr<File> Codec::Decode(std::unique_ptr<ByteData> fileBytes,
+                                    const std::string& filePath) {
+  if (fileBytes == nullptr || fileBytes->length() == 0 ||
+      fileBytes->length() > std::numeric_limits<uint32_t>::max()) {
+    return nullptr;
+  }
+  CodecContext context = {};
+  context.zeroCopy = true;
+  auto file = Decode(&context, fileBytes->data(), static_cast<uint32_t>(fileBytes->length()),
+                     filePath);
+  if (file != nullptr) {
+    file->fileBytes = std::move(fileBytes);
+  }
+  return file;
+}
+
+std::shared_ptr<File> Codec::Decode(CodecContext* context, const void* bytes, uint32_t byteLength,
+                                    const std::string& filePath) {
+  context->propertyBakingEnabled = propertyBakingEnabled;
+  DecodeStream stream(context, reinterpret_cast<const uint8_t*>(bytes), byteLength);
   auto bodyBytes = ReadBodyBytes(&stream);
-  if (context.hasException()) {
+  if (context->hasException()) {
     return nullptr;
   }
-  ReadTags(&bodyBytes, &context, ReadTagsOfFile);
-  InstallReferences(context.compositions);
-  if (context.hasException()) {
+  if (parallelDecodingEnabled) {
+    ReadTagsOfFileInParallel(&bodyBytes, context);
+  } else {
+    ReadTags(&bodyBytes, context, ReadTagsOfFile);
+  }
+  // Compositions reference each other across tags, resolve them once all tags are decoded.
+  InstallReferences(context->compositions);
+  if (context->hasException()) {
     return nullptr;
   }
 
   // Verify 提前到使用之前，避免未经Verify导致使用时crash
-  auto file = VerifyAndMake(context.releaseCompositions(), context.releaseImages());
+  auto file = VerifyAndMake(context->releaseCompositions(), context->releaseImages());
   if (file == nullptr) {
     return nullptr;
   }
@@ -220,13 +311,18 @@ std::shared_ptr<File> Codec::Decode(const void* bytes, uint32_t byteLength,
     }
   }
 
-  if (context.scaledTimeRange != nullptr) {
-    file->scaledTimeRange.start = std::max(static_cast<int64_t>(0), context.scaledTimeRange->start);
-    file->scaledTimeRange.end = std::min(file->duration(), context.scaledTimeRange->end);
+  if (context->scaledTimeRange != nullptr) {
+    file->scaledTimeRange.start =
+        std::max(static_cast<int64_t>(0), context->scaledTimeRange->start);
+    file->scaledTimeRange.end = std::min(file->duration(), context->scaledTimeRange->end);
+  }
+  if (!context->propertyBakers.empty()) {
+    file->_bakedMemory = BakeProperties(std::move(context->propertyBakers));
+    context->propertyBakers.clear();
   }
-  file->_tagLevel = context.tagLevel;
-  file->timeStretchMode = context.timeStretchMode;
-  file->fileAttributes = context.fileAttributes;
+  file->_tagLevel = context->tagLevel;
+  file->timeStretchMode = context->timeStretchMode;
+  file->fileAttributes = context->fileAttributes;
   file->path = filePath;
   return file;
 }
@@ -19,6 +19,11 @@
 #include "CodecContext.h"
 
 namespace pag {
+CodecContext::CodecContext(CodecContext* parent) : parent(parent) {
+  zeroCopy = parent->zeroCopy;
+  propertyBakingEnabled = parent->propertyBakingEnabled;
+}
+
 CodecContext::~CodecContext() {
   for (auto& font : fontIDMap) {
     delete font.second;
@@ -41,6 +46,9 @@ CodecContext::~CodecContext() {
 }
 
 FontData CodecContext::getFontData(int id) {
+  if (parent != nullptr) {
+    return parent->getFontData(id);
+  }
   auto result = fontIDMap.find(id);
   if (result != fontIDMap.end()) {
     auto font = result->second;
@@ -50,6 +58,11 @@ FontData CodecContext::getFontData(int id) {
 }
 
 ImageBytes* CodecContext::getImageBytes(pag::ID imageID) {
+  if (parent != nullptr) {
+    return parent->getImageBytes(imageID);
+  }
+  // Layers of different compositions may be decoded in parallel.
+  std::lock_guard<std::mutex> autoLock(imageLocker);
   for (auto image : images) {
     if (image->id == imageID) {
       return image;
@@ -77,6 +90,27 @@ std::vector<pag::ImageBytes*> CodecContext::releaseImages() {
   return images;
 }
 
+void CodecContext::mergeInto(CodecContext* target) {
+  auto decodedCompositions = releaseCompositions();
+  target->compositions.insert(target->compositions.end(), decodedCompositions.begin(),
+                              decodedCompositions.end());
+  auto decodedImages = releaseImages();
+  {
+    // Other decoders may still be looking up images of the target.
+    std::lock_guard<std::mutex> autoLock(target->imageLocker);
+    target->images.insert(target->images.end(), decodedImages.begin(), decodedImages.end());
+  }
+  target->propertyBakers.insert(target->propertyBakers.end(), propertyBakers.begin(),
+                                propertyBakers.end());
+  propertyBakers.clear();
+  for (auto& message : StreamContext::errorMessages) {
+    target->throwException(message);
+  }
+  if (target->tagLevel < tagLevel) {
+    target->tagLevel = tagLevel;
+  }
+}
+
 uint32_t CodecContext::getFontID(const std::string& fontFamily, const std::string& fontStyle) {
   auto result = fontNameMap.find(fontFamily + " - " + fontStyle);
   if (result != fontNameMap.end()) {
@@ -18,6 +18,8 @@
 
 #pragma once
 
+#include <functional>
+#include <mutex>
 #include <unordered_map>
 #include "codec/utils/StreamContext.h"
 #include "pag/file.h"
@@ -31,6 +33,15 @@ struct FontDescriptor {
 
 class CodecContext : public StreamContext {
  public:
+  CodecContext() = default;
+
+  /**
+   * Creates a child context for decoding a top-level tag on another thread. The child resolves
+   * fonts and images through the parent, and collects the decoded compositions and images by itself
+   * until they are merged back with mergeInto().
+   */
+  explicit CodecContext(CodecContext* parent);
+
   ~CodecContext() override;
   uint32_t getFontID(const std::string& fontFamily, const std::string& fontStyle);
   FontData getFontData(int id);
@@ -38,6 +49,12 @@ class CodecContext : public StreamContext {
   std::vector<Composition*> releaseCompositions();
   std::vector<ImageBytes*> releaseImages();
 
+  /**
+   * Moves the decoded compositions, images, property bakers and errors of this child context to its
+   * parent.
+   */
+  void mergeInto(CodecContext* target);
+
   std::vector<std::string> errorMessages;
   std::unordered_map<std::string, FontDescriptor*> fontNameMap;
   std::unordered_map<int, FontDescriptor*> fontIDMap;
@@ -47,5 +64,13 @@ class CodecContext : public StreamContext {
   TimeRange* scaledTimeRange = nullptr;
   FileAttributes fileAttributes = {};
   uint16_t tagLevel = 0;
+  bool propertyBakingEnabled = false;
+  // Bakes one of the decoded animatable properties and returns its memory cost, collected only if
+  // propertyBakingEnabled is true.
+  std::vector<std::function<size_t()>> propertyBakers;
+
+ private:
+  CodecContext* parent = nullptr;
+  std::mutex imageLocker = {};
 };
 }  // namespace pag
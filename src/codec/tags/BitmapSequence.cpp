@@ -19,11 +19,7 @@
 #include "BitmapSequence.h"
 
 namespace pag {
-BitmapSequence* ReadBitmapSequence(DecodeStream* stream) {
-  auto sequence = new BitmapSequence();
-  sequence->width = stream->readEncodedInt32();
-  sequence->height = stream->readEncodedInt32();
-  sequence->frameRate = stream->readFloat();
+static void ReadBitmapFrames(DecodeStream* stream, BitmapSequence* sequence) {
   auto count = stream->readEncodedUint32();
   for (uint32_t i = 0; i < count; i++) {
     auto bitmapFrame = new BitmapFrame();
@@ -41,10 +37,73 @@ BitmapSequence* ReadBitmapSequence(DecodeStream* stream) {
       bitmap->fileBytes = stream->readByteData().release();
     }
   }
+}
+
+/**
+ * Only validates the frames and returns the count of them, their payloads will be decoded when
+ * Sequence::decodeFrames() is called.
+ */
+static uint32_t SkipBitmapFrames(DecodeStream* stream) {
+  auto count = stream->readEncodedUint32();
+  for (uint32_t i = 0; i < count; i++) {
+    stream->readBitBoolean();
+  }
+  for (uint32_t i = 0; i < count && !stream->context->hasException(); i++) {
+    uint32_t bitmapCount = stream->readEncodedUint32();
+    for (uint32_t j = 0; j < bitmapCount && !stream->context->hasException(); j++) {
+      stream->readEncodedInt32();
+      stream->readEncodedInt32();
+      auto length = stream->readEncodedUint32();
+      stream->readBytes(length);
+      if (length == 0) {
+        Throw(stream->context, "Empty bitmap data was encountered.");
+      }
+    }
+  }
+  return count;
+}
+
+static void DeferBitmapFrames(DecodeStream* stream, BitmapSequence* sequence) {
+  auto framesStart = stream->position();
+  auto count = SkipBitmapFrames(stream);
+  if (stream->context->hasException()) {
+    return;
+  }
+  auto bytes = stream->data() + framesStart;
+  auto length = stream->position() - framesStart;
+  stream->context->viewEnd = bytes + length;
+  auto decoder = [bytes, length](Sequence* target) {
+    StreamContext context = {};
+    context.zeroCopy = true;
+    context.viewEnd = bytes;
+    DecodeStream frameStream(&context, bytes, length);
+    ReadBitmapFrames(&frameStream, static_cast<BitmapSequence*>(target));
+  };
+  auto validator = [bytes, length, count]() {
+    StreamContext context = {};
+    DecodeStream frameStream(&context, bytes, length);
+    return SkipBitmapFrames(&frameStream) == count && !context.hasException() &&
+           frameStream.bytesAvailable() == 0;
+  };
+  sequence->deferFrames(static_cast<Frame>(count), decoder, validator);
+}
+
+BitmapSequence* ReadBitmapSequence(DecodeStream* stream) {
+  auto sequence = new BitmapSequence();
+  sequence->width = stream->readEncodedInt32();
+  sequence->height = stream->readEncodedInt32();
+  sequence->frameRate = stream->readFloat();
+  // The frames are decoded lazily if the file bytes outlive the sequence.
+  if (stream->context->zeroCopy) {
+    DeferBitmapFrames(stream, sequence);
+  } else {
+    ReadBitmapFrames(stream, sequence);
+  }
   return sequence;
 }
 
 TagCode WriteBitmapSequence(EncodeStream* stream, BitmapSequence* sequence) {
+  sequence->decodeFrames();
   stream->writeEncodedInt32(sequence->width);
   stream->writeEncodedInt32(sequence->height);
   stream->writeFloat(sequence->frameRate);
@@ -19,6 +19,7 @@
 #include "FileTags.h"
 #include <unordered_set>
 #include "base/utils/EnumClassHash.h"
+#include "base/utils/Task.h"
 #include "codec/tags/BitmapCompositionTag.h"
 #include "codec/tags/FileAttributes.h"
 #include "codec/tags/FontTables.h"
@@ -96,6 +97,104 @@ void ReadTagsOfFile(DecodeStream* stream, TagCode code, CodecContext* context) {
   }
 }
 
+class TagDecodingTask : public Executor {
+ public:
+  TagDecodingTask(TagCode code, const DecodeStream& tagBytes, CodecContext* parent)
+      : code(code), context(parent), tagBytes(&context, tagBytes.data(), tagBytes.length()) {
+  }
+
+  void decode() {
+    ReadTagsOfFile(&tagBytes, code, &context);
+    decoded = true;
+  }
+
+  bool isDecoded() const {
+    return decoded;
+  }
+
+  CodecContext* getContext() {
+    return &context;
+  }
+
+ private:
+  TagCode code;
+  CodecContext context;
+  DecodeStream tagBytes;
+  bool decoded = false;
+
+  void execute() override {
+    decode();
+  }
+};
+
+struct TagDecodingTasks {
+  std::vector<std::unique_ptr<TagDecodingTask>> images;
+  std::vector<std::unique_ptr<TagDecodingTask>> compositions;
+};
+
+static void CollectTagsOfFile(DecodeStream* stream, TagCode code, TagDecodingTasks* tasks) {
+  auto context = static_cast<CodecContext*>(stream->context);
+  switch (code) {
+    case TagCode::ImageTables:
+    case TagCode::ImageBytes:
+    case TagCode::ImageBytesV2:
+    case TagCode::ImageBytesV3:
+      tasks->images.push_back(std::make_unique<TagDecodingTask>(code, *stream, context));
+      break;
+    case TagCode::VectorCompositionBlock:
+    case TagCode::BitmapCompositionBlock:
+    case TagCode::VideoCompositionBlock:
+      tasks->compositions.push_back(std::make_unique<TagDecodingTask>(code, *stream, context));
+      break;
+    default:
+      ReadTagsOfFile(stream, code, context);
+      break;
+  }
+}
+
+static void DecodeInParallel(std::vector<std::unique_ptr<TagDecodingTask>> decoders,
+                             CodecContext* context) {
+  if (decoders.empty()) {
+    return;
+  }
+  // The last tag is decoded on the current thread instead of waiting idle.
+  auto lastDecoder = std::move(decoders.back());
+  decoders.pop_back();
+  std::vector<std::shared_ptr<Task>> tasks = {};
+  for (auto& decoder : decoders) {
+    auto task = Task::Make(std::move(decoder));
+    task->run(TaskPriority::Urgent);
+    tasks.push_back(task);
+  }
+  lastDecoder->decode();
+  // Merge in tag order, so that the result is the same as decoding sequentially.
+  for (auto& task : tasks) {
+    // Take back the tags that no thread has picked up yet, the current thread may be a worker of
+    // the task executor itself, and it must not block on the tasks queued behind it.
+    task->cancel();
+    auto decoder = static_cast<TagDecodingTask*>(task->wait());
+    if (!decoder->isDecoded()) {
+      decoder->decode();
+    }
+    decoder->getContext()->mergeInto(context);
+  }
+  lastDecoder->getContext()->mergeInto(context);
+}
+
+void ReadTagsOfFileInParallel(DecodeStream* stream, CodecContext* context) {
+  TagDecodingTasks tasks = {};
+  ReadTags(stream, &tasks, CollectTagsOfFile);
+  if (context->hasException()) {
+    return;
+  }
+  // Layers resolve their image references while decoding, all images must be ready before that.
+  DecodeInParallel(std::move(tasks.images), context);
+  if (context->hasException()) {
+    return;
+  }
+  DecodeInParallel(std::move(tasks.compositions), context);
+}
+
 void GetFontFromTextDocument(std::vector<FontData>& fontList,
                              std::unordered_set<std::string>& fontSet,
                              const TextDocumentHandle& textDocument) {
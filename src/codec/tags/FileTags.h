@@ -23,5 +23,11 @@
 namespace pag {
 void ReadTagsOfFile(DecodeStream* stream, TagCode code, CodecContext* context);
 
+/**
+ * Reads all tags of a file like ReadTags(stream, context, ReadTagsOfFile) does, but decodes the
+ * image tags and then the composition tags concurrently on the task executor.
+ */
+void ReadTagsOfFileInParallel(DecodeStream* stream, CodecContext* context);
+
 void WriteTagsOfFile(EncodeStream* stream, const File* file, PerformanceData* performanceData);
 }  // namespace pag
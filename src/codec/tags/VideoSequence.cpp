@@ -20,17 +20,7 @@
 #include "codec/utils/NALUReader.h"
 
 namespace pag {
-VideoSequence* ReadVideoSequence(DecodeStream* stream, bool hasAlpha) {
-  auto sequence = new VideoSequence();
-  sequence->width = stream->readEncodedInt32();
-  sequence->height = stream->readEncodedInt32();
-  sequence->frameRate = stream->readFloat();
-
-  if (hasAlpha) {
-    sequence->alphaStartX = stream->readEncodedInt32();
-    sequence->alphaStartY = stream->readEncodedInt32();
-  }
-
+static void ReadVideoFrames(DecodeStream* stream, VideoSequence* sequence) {
   auto sps = ReadByteDataWithStartCode(stream);
   auto pps = ReadByteDataWithStartCode(stream);
   sequence->headers.push_back(sps.release());
@@ -47,9 +37,80 @@ VideoSequence* ReadVideoSequence(DecodeStream* stream, bool hasAlpha) {
     videoFrame->frame = ReadTime(stream);
     videoFrame->fileBytes = ReadByteDataWithStartCode(stream).release();
   }
+}
+
+static void SkipByteData(DecodeStream* stream) {
+  auto length = stream->readEncodedUint32();
+  stream->readBytes(length);
+  if (length == 0) {
+    Throw(stream->context, "Empty frame data was encountered.");
+  }
+}
+
+/**
+ * Only validates the frames and returns the count of them, their payloads will be decoded when
+ * Sequence::decodeFrames() is called.
+ */
+static uint32_t SkipVideoFrames(DecodeStream* stream) {
+  SkipByteData(stream);
+  SkipByteData(stream);
+  auto count = stream->readEncodedUint32();
+  for (uint32_t i = 0; i < count; i++) {
+    stream->readBitBoolean();
+  }
+  for (uint32_t i = 0; i < count && !stream->context->hasException(); i++) {
+    ReadTime(stream);
+    SkipByteData(stream);
+  }
+  return count;
+}
+
+static void DeferVideoFrames(DecodeStream* stream, VideoSequence* sequence) {
+  auto framesStart = stream->position();
+  auto count = SkipVideoFrames(stream);
+  if (stream->context->hasException()) {
+    return;
+  }
+  auto bytes = stream->data() + framesStart;
+  auto length = stream->position() - framesStart;
+  // Nothing may be written into the deferred bytes before they are decoded.
+  stream->context->viewEnd = bytes + length;
+  auto decoder = [bytes, length](Sequence* target) {
+    StreamContext context = {};
+    context.zeroCopy = true;
+    context.viewEnd = bytes;
+    DecodeStream frameStream(&context, bytes, length);
+    ReadVideoFrames(&frameStream, static_cast<VideoSequence*>(target));
+  };
+  auto validator = [bytes, length, count]() {
+    StreamContext context = {};
+    DecodeStream frameStream(&context, bytes, length);
+    return SkipVideoFrames(&frameStream) == count && !context.hasException() &&
+           frameStream.bytesAvailable() == 0;
+  };
+  sequence->deferFrames(static_cast<Frame>(count), decoder, validator);
+}
+
+VideoSequence* ReadVideoSequence(DecodeStream* stream, bool hasAlpha) {
+  auto sequence = new VideoSequence();
+  sequence->width = stream->readEncodedInt32();
+  sequence->height = stream->readEncodedInt32();
+  sequence->frameRate = stream->readFloat();
+
+  if (hasAlpha) {
+    sequence->alphaStartX = stream->readEncodedInt32();
+    sequence->alphaStartY = stream->readEncodedInt32();
+  }
+
+  // The frames are decoded lazily if the file bytes outlive the sequence.
+  if (stream->context->zeroCopy) {
+    DeferVideoFrames(stream, sequence);
+  } else {
+    ReadVideoFrames(stream, sequence);
+  }
 
   if (stream->bytesAvailable() > 0) {
-    count = stream->readEncodedUint32();
+    auto count = stream->readEncodedUint32();
     for (uint32_t i = 0; i < count; i++) {
       TimeRange staticTimeRange = {};
       staticTimeRange.start = ReadTime(stream);
@@ -76,6 +137,7 @@ static void WriteByteDataWithoutStartCode(EncodeStream* stream, ByteData* byteDa
 TagCode WriteVideoSequence(EncodeStream* stream, std::pair<VideoSequence*, bool>* parameter) {
   auto sequence = parameter->first;
   auto hasAlpha = parameter->second;
+  sequence->decodeFrames();
   stream->writeEncodedInt32(sequence->width);
   stream->writeEncodedInt32(sequence->height);
   stream->writeFloat(sequence->frameRate);
@@ -66,6 +66,10 @@ std::unique_ptr<ByteData> DecodeStream::readByteData() {
   if (length == 0 || context->hasException()) {
     return nullptr;
   }
+  if (context->zeroCopy) {
+    context->viewEnd = bytes.data() + length;
+    return ByteData::MakeWithoutCopy(const_cast<uint8_t*>(bytes.data()), length);
+  }
   return ByteData::MakeCopy(bytes.data(), length);
 }
 
@@ -20,15 +20,7 @@
 #include "platform/Platform.h"
 
 namespace pag {
-std::unique_ptr<ByteData> ReadByteDataWithStartCode(DecodeStream* stream) {
-  auto length = stream->readEncodedUint32();
-  auto bytes = stream->readBytes(length);
-  // must check whether the bytes is valid. otherwise memcpy will crash.
-  if (length == 0 || stream->context->hasException()) {
-    return nullptr;
-  }
-  auto data = new uint8_t[length + 4];
-  memcpy(data + 4, bytes.data(), length);
+static void WriteStartCode(uint8_t* data, uint32_t length) {
   if (Platform::Current()->naluType() == NALUType::AVCC) {
     // AVCC
     data[0] = static_cast<uint8_t>((length >> 24) & 0xFF);
@@ -42,6 +34,28 @@ std::unique_ptr<ByteData> ReadByteDataWithStartCode(DecodeStream* stream) {
     data[2] = 0;
     data[3] = 1;
   }
+}
+
+std::unique_ptr<ByteData> ReadByteDataWithStartCode(DecodeStream* stream) {
+  auto length = stream->readEncodedUint32();
+  auto bytes = stream->readBytes(length);
+  // must check whether the bytes is valid. otherwise memcpy will crash.
+  if (length == 0 || stream->context->hasException()) {
+    return nullptr;
+  }
+  auto context = stream->context;
+  auto start = bytes.data() - 4;
+  if (context->zeroCopy && (context->viewEnd == nullptr || start >= context->viewEnd)) {
+    // The 4 bytes before the payload hold the frame time and the length we have already consumed,
+    // overwrite them with the start code so that the frame can be a view into the file bytes.
+    auto data = const_cast<uint8_t*>(start);
+    WriteStartCode(data, length);
+    context->viewEnd = bytes.data() + length;
+    return ByteData::MakeWithoutCopy(data, length + 4);
+  }
+  auto data = new uint8_t[length + 4];
+  memcpy(data + 4, bytes.data(), length);
+  WriteStartCode(data, length);
   return ByteData::MakeAdopted(data, length + 4);
 }
 }  // namespace pag
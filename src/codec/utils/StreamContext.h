@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include "base/utils/Log.h"
@@ -36,6 +37,18 @@ class StreamContext {
   }
 
   std::vector<std::string> errorMessages;
+
+  /**
+   * If true, the bytes being decoded are privately writable and outlive all the decoded objects, so
+   * ByteData payloads are created as views into them instead of copies.
+   */
+  bool zeroCopy = false;
+
+  /**
+   * The end of the last ByteData view created in zero-copy mode. Bytes before it are referenced by
+   * decoded objects and must never be modified.
+   */
+  const uint8_t* viewEnd = nullptr;
 };
 
 #ifdef DEBUG
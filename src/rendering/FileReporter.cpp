@@ -99,6 +99,11 @@ void FileReporter::reportData() {
   reportInfos.insert(std::make_pair("graphicsMemoryMax", std::to_string(graphicsMemoryMax)));
   reportInfos.insert(std::make_pair("graphicsMemoryAverage",
                                     std::to_string(GetAverage(graphicsMemoryTotal, flushCount))));
+  auto flushDuration = lastFlushTimestamp - firstFlushTimestamp;
+  auto rescalingPerSecond =
+      flushDuration > 0 ? snapshotRescalingTotal * 1000000 / flushDuration : 0;
+  reportInfos.insert(
+      std::make_pair("snapshotRescalingPerSecond", std::to_string(rescalingPerSecond)));
   reportInfos.insert(std::make_pair("flushCount", std::to_string(flushCount)));
   reportInfos.insert(std::make_pair("pagInfo", pagInfoString));
   reportInfos.insert(std::make_pair("event", "pag_monitor"));
@@ -115,6 +120,11 @@ static int64_t GetOldRenderTime(RenderCache* cache) {
 
 void FileReporter::recordPerformance(RenderCache* cache) {
   flushCount++;
+  lastFlushTimestamp = GetTimer();
+  if (firstFlushTimestamp == 0) {
+    firstFlushTimestamp = lastFlushTimestamp;
+  }
+  snapshotRescalingTotal += cache->snapshotRescalingCount;
 
   if (presentFirstFrameTime == 0) {
     presentFirstFrameTime = cache->presentingTime;
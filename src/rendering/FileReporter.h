@@ -65,5 +65,9 @@ class FileReporter {
 
   size_t graphicsMemoryMax = 0;
   size_t graphicsMemoryTotal = 0;
+
+  int64_t snapshotRescalingTotal = 0;
+  int64_t firstFlushTimestamp = 0;
+  int64_t lastFlushTimestamp = 0;
 };
 }  // namespace pag
@@ -17,6 +17,7 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "pag/pag.h"
+#include "gpu/opengl/GLProgramBinaryCache.h"
 
 namespace pag {
 
@@ -25,4 +26,8 @@ static const char sdkVersion[] = "4.0.0.1";
 std::string PAG::SDKVersion() {
   return sdkVersion;
 }
+
+void PAG::SetProgramCacheDirectory(const std::string& directory) {
+  GLProgramBinaryCache::SetDirectory(directory);
+}
 }  // namespace pag
@@ -34,8 +34,8 @@ std::shared_ptr<PAGFile> PAGFile::Load(const void* bytes, size_t length,
   return MakeFrom(file);
 }
 
-std::shared_ptr<PAGFile> PAGFile::Load(const std::string& filePath) {
-  auto file = File::Load(filePath);
+std::shared_ptr<PAGFile> PAGFile::Load(const std::string& filePath, bool mapFile) {
+  auto file = File::Load(filePath, mapFile);
   return MakeFrom(file);
 }
 
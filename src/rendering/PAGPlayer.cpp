@@ -21,9 +21,11 @@
 #include "pag/file.h"
 #include "pag/pag.h"
 #include "rendering/FileReporter.h"
+#include "rendering/caches/FrameCache.h"
 #include "rendering/caches/RenderCache.h"
 #include "rendering/layers/PAGStage.h"
 #include "rendering/utils/ApplyScaleMode.h"
+#include "rendering/utils/DamageTracker.h"
 #include "rendering/utils/LockGuard.h"
 #include "rendering/utils/ScopedLock.h"
 
@@ -39,6 +41,7 @@ PAGPlayer::~PAGPlayer() {
   setSurface(nullptr);
   stage->removeAllLayers();
   delete reporter;
+  delete damageTracker;
 }
 
 std::shared_ptr<PAGComposition> PAGPlayer::getComposition() {
@@ -66,6 +69,7 @@ void PAGPlayer::setComposition(std::shared_ptr<PAGComposition> newComposition) {
     reporter = FileReporter::Make(pagComposition).release();
     updateScaleModeIfNeed();
   }
+  resetDamage();
 }
 
 std::shared_ptr<PAGSurface> PAGPlayer::getSurface() {
@@ -100,6 +104,7 @@ void PAGPlayer::setSurfaceInternal(std::shared_ptr<PAGSurface> newSurface) {
   } else {
     stage->setContentSizeInternal(0, 0);
   }
+  resetDamage();
 }
 
 bool PAGPlayer::videoEnabled() {
@@ -110,6 +115,8 @@ bool PAGPlayer::videoEnabled() {
 void PAGPlayer::setVideoEnabled(bool value) {
   LockGuard autoLock(rootLocker);
   renderCache->setVideoEnabled(value);
+  stage->setVideoEnabled(value);
+  resetDamage();
 }
 
 bool PAGPlayer::cacheEnabled() {
@@ -122,6 +129,16 @@ void PAGPlayer::setCacheEnabled(bool value) {
   renderCache->setSnapshotEnabled(value);
 }
 
+bool PAGPlayer::sharedCacheEnabled() {
+  LockGuard autoLock(rootLocker);
+  return renderCache->sharedSnapshotEnabled();
+}
+
+void PAGPlayer::setSharedCacheEnabled(bool value) {
+  LockGuard autoLock(rootLocker);
+  renderCache->setSharedSnapshotEnabled(value);
+}
+
 float PAGPlayer::cacheScale() {
   LockGuard autoLock(rootLocker);
   return stage->cacheScale();
@@ -130,6 +147,7 @@ float PAGPlayer::cacheScale() {
 void PAGPlayer::setCacheScale(float value) {
   LockGuard autoLock(rootLocker);
   stage->setCacheScale(value);
+  resetDamage();
 }
 
 float PAGPlayer::maxFrameRate() {
@@ -234,6 +252,31 @@ void PAGPlayer::setAutoClear(bool value) {
   }
   _autoClear = value;
   stage->notifyModified(true);
+  resetDamage();
+}
+
+bool PAGPlayer::partialRedraw() {
+  LockGuard autoLock(rootLocker);
+  return damageTracker != nullptr;
+}
+
+void PAGPlayer::setPartialRedraw(bool value) {
+  LockGuard autoLock(rootLocker);
+  if ((damageTracker != nullptr) == value) {
+    return;
+  }
+  if (value) {
+    damageTracker = new DamageTracker();
+  } else {
+    delete damageTracker;
+    damageTracker = nullptr;
+  }
+  pendingDamage.setEmpty();
+}
+
+Rect PAGPlayer::damageRect() {
+  LockGuard autoLock(rootLocker);
+  return lastDamage;
 }
 
 bool PAGPlayer::wait(const BackendSemaphore& waitSemaphore) {
@@ -258,6 +301,8 @@ bool PAGPlayer::flushInternal(BackendSemaphore* signalSemaphore) {
   if (pagSurface == nullptr) {
     return false;
   }
+  // Keeps the frame caches handed out during this flush alive until it finishes.
+  FrameCachePass framePass = {};
   updateStageSize();
 #ifndef PAG_BUILD_FOR_WEB
   // must be called before content comparing, otherwise decoders can not be prepared.
@@ -269,14 +314,28 @@ bool PAGPlayer::flushInternal(BackendSemaphore* signalSemaphore) {
     Recorder recorder = {};
     stage->draw(&recorder);
     lastGraphic = recorder.makeGraphic();
+    lastCulledLayerCount = recorder.culledLayerCount();
+    if (damageTracker) {
+      pendingDamage.join(damageTracker->update(stage.get()));
+    }
   }
   auto presentingStart = GetTimer();
   if (lastGraphic) {
-    lastGraphic->prepare(renderCache);
+    lastGraphic->prepare(renderCache, Matrix::I());
   }
-  if (!pagSurface->draw(renderCache, lastGraphic, signalSemaphore, _autoClear)) {
+  // A new surface or a cleared one has nothing to keep, it is always redrawn as a whole.
+  auto fullRedraw = damageTracker == nullptr || !_autoClear || pagSurface->surface == nullptr ||
+                    pagSurface->contentVersion == 0;
+  auto damage = fullRedraw ? Rect::MakeWH(static_cast<float>(stage->widthInternal()),
+                                          static_cast<float>(stage->heightInternal()))
+                           : pendingDamage;
+  lastDamage.setEmpty();
+  if (!pagSurface->draw(renderCache, lastGraphic, signalSemaphore, _autoClear,
+                        fullRedraw ? nullptr : &damage)) {
     return false;
   }
+  lastDamage = damage;
+  pendingDamage.setEmpty();
   auto finishTime = GetTimer();
   renderCache->renderingTime = presentingStart - renderingStart;
   renderCache->presentingTime = finishTime - presentingStart;
@@ -285,6 +344,7 @@ bool PAGPlayer::flushInternal(BackendSemaphore* signalSemaphore) {
       renderCache->programCompilingTime + renderCache->hardwareDecodingTime +
       renderCache->softwareDecodingTime;
   renderCache->totalTime = finishTime - renderingStart;
+  renderCache->culledLayerCount = lastCulledLayerCount;
   //  auto composition = stage->getRootComposition();
   //  if (composition) {
   //    renderCache->printPerformance(composition->currentFrameInternal());
@@ -300,6 +360,7 @@ Rect PAGPlayer::getBounds(std::shared_ptr<PAGLayer> pagLayer) {
     return Rect::MakeEmpty();
   }
   LockGuard autoLock(rootLocker);
+  FrameCachePass framePass = {};
   updateStageSize();
   Rect bounds = {};
   pagLayer->measureBounds(&bounds);
@@ -323,6 +384,7 @@ Rect PAGPlayer::getBounds(std::shared_ptr<PAGLayer> pagLayer) {
 std::vector<std::shared_ptr<PAGLayer>> PAGPlayer::getLayersUnderPoint(float surfaceX,
                                                                       float surfaceY) {
   LockGuard autoLock(rootLocker);
+  FrameCachePass framePass = {};
   updateStageSize();
   std::vector<std::shared_ptr<PAGLayer>> results;
   stage->getLayersUnderPointInternal(surfaceX, surfaceY, &results);
@@ -332,6 +394,7 @@ std::vector<std::shared_ptr<PAGLayer>> PAGPlayer::getLayersUnderPoint(float surf
 bool PAGPlayer::hitTestPoint(std::shared_ptr<PAGLayer> pagLayer, float surfaceX, float surfaceY,
                              bool pixelHitTest) {
   LockGuard autoLock(rootLocker);
+  FrameCachePass framePass = {};
   updateStageSize();
   auto local = pagLayer->globalToLocalPoint(surfaceX, surfaceY);
   if (!pixelHitTest) {
@@ -349,6 +412,19 @@ bool PAGPlayer::hitTestPoint(std::shared_ptr<PAGLayer> pagLayer, float surfaceX,
   return pagSurface->hitTest(renderCache, graphic, local.x, local.y);
 }
 
+bool PAGPlayer::prewarm(std::shared_ptr<PAGComposition> composition) {
+  LockGuard autoLock(rootLocker);
+  if (composition == nullptr || pagSurface == nullptr) {
+    return false;
+  }
+  // The composition has its own locker until it is added to this player.
+  auto compositionLocker =
+      composition->rootLocker != rootLocker ? composition->rootLocker : nullptr;
+  LockGuard compositionLock(compositionLocker);
+  FrameCachePass framePass = {};
+  return pagSurface->prewarm(renderCache, composition.get());
+}
+
 int64_t PAGPlayer::getTimeStampInternal() {
   auto pagComposition = stage->getRootComposition();
   if (pagComposition == nullptr) {
@@ -381,6 +457,32 @@ int64_t PAGPlayer::graphicsMemory() {
   return renderCache->memoryUsage();
 }
 
+int PAGPlayer::drawCallCount() {
+  LockGuard autoLock(rootLocker);
+  return renderCache->drawCallCount;
+}
+
+int PAGPlayer::mergedDrawCount() {
+  LockGuard autoLock(rootLocker);
+  return renderCache->mergedDrawCount;
+}
+
+int PAGPlayer::culledLayerCount() {
+  LockGuard autoLock(rootLocker);
+  return renderCache->culledLayerCount;
+}
+
+PAGCacheStats PAGPlayer::cacheStats() {
+  LockGuard autoLock(rootLocker);
+  return renderCache->cacheStats;
+}
+
+void PAGPlayer::resetDamage() {
+  if (damageTracker) {
+    damageTracker->reset();
+  }
+}
+
 void PAGPlayer::updateStageSize() {
   if (pagSurface == nullptr) {
     return;
@@ -24,6 +24,7 @@
 #include "rendering/Drawable.h"
 #include "rendering/caches/RenderCache.h"
 #include "rendering/graphics/Recorder.h"
+#include "rendering/utils/AsyncPixelReader.h"
 #include "rendering/utils/LockGuard.h"
 
 namespace pag {
@@ -79,6 +80,19 @@ PAGSurface::PAGSurface(std::shared_ptr<Drawable> drawable) : drawable(std::move(
   rootLocker = std::make_shared<std::mutex>();
 }
 
+PAGSurface::~PAGSurface() {
+  finishReadPixels();
+  if (pixelReader != nullptr) {
+    // The reads that can not be finished without a context still get their callbacks called.
+    std::vector<PixelReadResult> results = {};
+    pixelReader->abandon(&results);
+    delete pixelReader;
+    for (auto& result : results) {
+      result.callback(result.frame, nullptr, 0);
+    }
+  }
+}
+
 int PAGSurface::width() {
   LockGuard autoLock(rootLocker);
   return drawable->width();
@@ -90,6 +104,8 @@ int PAGSurface::height() {
 }
 
 void PAGSurface::updateSize() {
+  // The pending reads belong to the old surface, hands them out before it is released.
+  finishReadPixels();
   LockGuard autoLock(rootLocker);
   surface = nullptr;
   device = nullptr;
@@ -97,6 +113,7 @@ void PAGSurface::updateSize() {
 }
 
 void PAGSurface::freeCache() {
+  finishReadPixels();
   LockGuard autoLock(rootLocker);
   if (pagPlayer) {
     pagPlayer->renderCache->releaseAll();
@@ -152,8 +169,54 @@ bool PAGSurface::readPixels(ColorType colorType, AlphaType alphaType, void* dstP
   return result;
 }
 
+bool PAGSurface::readPixelsAsync(int64_t frame, ColorType colorType, AlphaType alphaType,
+                                 ReadPixelsCallback callback) {
+  std::vector<PixelReadResult> results = {};
+  auto success = false;
+  {
+    LockGuard autoLock(rootLocker);
+    auto context = lockContext();
+    if (!context) {
+      return false;
+    }
+    if (surface != nullptr) {
+      if (pixelReader == nullptr) {
+        pixelReader = new AsyncPixelReader();
+      }
+      auto info = ImageInfo::Make(surface->width(), surface->height(), colorType, alphaType);
+      success = pixelReader->read(surface.get(), info, frame, std::move(callback), &results);
+    }
+    unlockContext();
+  }
+  // The callbacks are called outside the locks, so the encoding of the pixels does not block the
+  // rendering on other threads.
+  for (auto& result : results) {
+    result.callback(result.frame, result.pixels.get(), result.rowBytes);
+  }
+  return success;
+}
+
+void PAGSurface::finishReadPixels() {
+  std::vector<PixelReadResult> results = {};
+  {
+    LockGuard autoLock(rootLocker);
+    if (pixelReader == nullptr || !pixelReader->hasPendingReads()) {
+      return;
+    }
+    auto context = lockContext();
+    if (!context) {
+      return;
+    }
+    pixelReader->finish(context, &results);
+    unlockContext();
+  }
+  for (auto& result : results) {
+    result.callback(result.frame, result.pixels.get(), result.rowBytes);
+  }
+}
+
 bool PAGSurface::draw(RenderCache* cache, std::shared_ptr<Graphic> graphic,
-                      BackendSemaphore* signalSemaphore, bool autoClear) {
+                      BackendSemaphore* signalSemaphore, bool autoClear, const Rect* damageRect) {
   if (device == nullptr) {
     device = drawable->getDevice();
   }
@@ -175,11 +238,26 @@ bool PAGSurface::draw(RenderCache* cache, std::shared_ptr<Graphic> graphic,
   contentVersion = cache->getContentVersion();
   cache->attachToContext(context);
   auto canvas = surface->getCanvas();
-  if (autoClear) {
-    canvas->clear();
-  }
-  if (graphic) {
-    graphic->draw(canvas, cache);
+  if (damageRect == nullptr) {
+    if (autoClear) {
+      canvas->clear();
+    }
+    if (graphic) {
+      graphic->draw(canvas, cache);
+    }
+  } else if (!damageRect->isEmpty()) {
+    // The damage rect is pixel aligned, so the clip is done by the scissor test.
+    canvas->save();
+    Path clip = {};
+    clip.addRect(*damageRect);
+    canvas->clipPath(clip);
+    if (autoClear) {
+      canvas->clearRect(*damageRect);
+    }
+    if (graphic) {
+      graphic->draw(canvas, cache);
+    }
+    canvas->restore();
   }
   surface->flush(signalSemaphore);
   cache->detachFromContext();
@@ -227,6 +305,23 @@ bool PAGSurface::hitTest(RenderCache* cache, std::shared_ptr<Graphic> graphic, f
   return result;
 }
 
+bool PAGSurface::prewarm(RenderCache* cache, PAGComposition* composition) {
+  if (device == nullptr) {
+    device = drawable->getDevice();
+  }
+  auto context = lockContext();
+  if (!context) {
+    return false;
+  }
+  // Attaches the cache in the same way as hit testing, which leaves the caches used by the last
+  // frame untouched.
+  cache->attachToContext(context, true);
+  cache->prewarm(composition);
+  cache->detachFromContext();
+  unlockContext();
+  return true;
+}
+
 Context* PAGSurface::lockContext() {
   if (device == nullptr) {
     return nullptr;
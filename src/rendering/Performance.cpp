@@ -24,13 +24,13 @@ std::string Performance::getPerformanceString() const {
   char buffer[300];
   sprintf(buffer,
           "%6.1fms[Render] %6.1fms[Image] %6.1fms[Video]"
-          " %6.1fms[Texture] %6.1fms[Program] %6.1fms[Present] ",
+          " %6.1fms[Texture] %6.1fms[Program] %6.1fms[Present] %2d[Rescale] %3d[DrawCall] ",
           static_cast<double>(renderingTime) / 1000.0,
           static_cast<double>(imageDecodingTime) / 1000.0,
           static_cast<double>(softwareDecodingTime + hardwareDecodingTime) / 1000.0,
           static_cast<double>(textureUploadingTime) / 1000.0,
           static_cast<double>(programCompilingTime) / 1000.0,
-          static_cast<double>(presentingTime) / 1000.0);
+          static_cast<double>(presentingTime) / 1000.0, snapshotRescalingCount, drawCallCount);
   return buffer;
 }
 
@@ -52,5 +52,10 @@ void Performance::resetPerformance() {
   hardwareDecodingInitialTime = 0;
   softwareDecodingInitialTime = 0;
   totalTime = 0;
+  snapshotRescalingCount = 0;
+  drawCallCount = 0;
+  mergedDrawCount = 0;
+  culledLayerCount = 0;
+  cacheStats = {};
 }
 }  // namespace pag
\ No newline at end of file
@@ -20,7 +20,7 @@
 
 #include "base/utils/GetTimer.h"
 #include "base/utils/Log.h"
-#include "pag/types.h"
+#include "pag/pag.h"
 
 namespace pag {
 class Performance {
@@ -39,6 +39,15 @@ class Performance {
   int64_t hardwareDecodingInitialTime = 0;
   int64_t softwareDecodingInitialTime = 0;
   int64_t totalTime = 0;
+  // 因缩放值变化而重新光栅化的 Snapshot 数量。
+  int snapshotRescalingCount = 0;
+  // 提交给 GPU 的 draw call 数量。
+  int drawCallCount = 0;
+  // 合并到其他 draw call 中的绘制数量。
+  int mergedDrawCount = 0;
+  // 被上方不透明图层完全遮挡而跳过绘制的图层数量。
+  int culledLayerCount = 0;
+  PAGCacheStats cacheStats = {};
 
   /**
    * Returns the formatted  string which contains the performance data.
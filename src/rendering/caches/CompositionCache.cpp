@@ -41,12 +41,13 @@ std::shared_ptr<Graphic> CompositionCache::getContent(Frame contentFrame) {
     contentFrame = 0;
   }
   std::lock_guard<std::mutex> autoLock(locker);
-  auto cache = frames[contentFrame];
-  if (cache == nullptr) {
-    cache = createContent(contentFrame);
-    frames[contentFrame] = cache;
+  auto result = frames.find(contentFrame);
+  if (result != nullptr) {
+    return *result;
   }
-  return cache;
+  auto graphic = createContent(contentFrame);
+  frames.insert(contentFrame, graphic, graphic ? graphic->memoryUsage() : 0);
+  return graphic;
 }
 
 std::shared_ptr<Graphic> CompositionCache::createContent(Frame compositionFrame) {
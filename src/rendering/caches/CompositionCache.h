@@ -18,8 +18,7 @@
 
 #pragma once
 
-#include <unordered_map>
-#include "pag/file.h"
+#include "FrameCache.h"
 #include "rendering/graphics/Graphic.h"
 
 namespace pag {
@@ -35,7 +34,7 @@ class CompositionCache : public Cache {
  private:
   std::mutex locker = {};
   Composition* composition = nullptr;
-  std::unordered_map<Frame, std::shared_ptr<Graphic>> frames;
+  FrameEntries<std::shared_ptr<Graphic>> frames{&locker};
 
   explicit CompositionCache(Composition* composition);
 };
@@ -53,6 +53,7 @@ class ContentCache : public FrameCache<Content> {
   bool _contentStatic = false;
 
   Content* createCache(Frame layerFrame) override;
+  size_t memoryUsage(const Content* content) const override;
 
   virtual ID getCacheID() const {
     return layer->uniqueID;
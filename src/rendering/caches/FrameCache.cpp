@@ -0,0 +1,133 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "FrameCache.h"
+#include <atomic>
+#include <unordered_set>
+#include <vector>
+#include "pag/pag.h"
+
+namespace pag {
+// 64 MB
+#define DEFAULT_FRAME_CACHE_LIMIT 67108864
+
+static std::atomic_size_t frameCacheLimit = {DEFAULT_FRAME_CACHE_LIMIT};
+static std::atomic_size_t frameCacheMemory = {0};
+static std::atomic<uint64_t> accessClock = {0};
+static std::mutex registryLocker = {};
+static std::unordered_set<FrameEntriesBase*> registry = {};
+
+struct PinnedObjects {
+  int passDepth = 0;
+  std::vector<std::shared_ptr<void>> objects = {};
+};
+
+static thread_local PinnedObjects pinnedObjects = {};
+
+void PAG::SetFrameCacheLimit(size_t maxMemory) {
+  frameCacheLimit = maxMemory;
+}
+
+void FrameCacheMemory::Add(size_t bytes) {
+  frameCacheMemory += bytes;
+}
+
+void FrameCacheMemory::Remove(size_t bytes) {
+  frameCacheMemory -= bytes;
+}
+
+size_t FrameCacheMemory::Limit() {
+  return frameCacheLimit;
+}
+
+bool FrameCacheMemory::Exceeded() {
+  return frameCacheMemory > frameCacheLimit;
+}
+
+void FrameCacheMemory::Purge(FrameEntriesBase* current) {
+  // Released after the registry is unlocked, their destructors may create or destroy caches.
+  std::vector<std::shared_ptr<void>> evicted = {};
+  std::lock_guard<std::mutex> autoLock(registryLocker);
+  std::vector<std::pair<uint64_t, FrameEntriesBase*>> candidates = {};
+  candidates.reserve(registry.size());
+  for (auto entries : registry) {
+    candidates.emplace_back(entries->lastAccess.load(std::memory_order_relaxed), entries);
+  }
+  std::sort(candidates.begin(), candidates.end());
+  for (auto& candidate : candidates) {
+    if (!Exceeded()) {
+      break;
+    }
+    auto entries = candidate.second;
+    if (entries == current) {
+      while (Exceeded() && entries->evictOne(true, &evicted)) {
+      }
+      continue;
+    }
+    // The entries being used by another thread are skipped, waiting for them may deadlock.
+    if (entries->locker == nullptr || !entries->locker->try_lock()) {
+      continue;
+    }
+    while (Exceeded() && entries->evictOne(false, &evicted)) {
+    }
+    entries->locker->unlock();
+  }
+}
+
+void FrameCacheMemory::Pin(std::shared_ptr<void> object) {
+  auto& pinned = pinnedObjects;
+  // Nothing is kept outside of a pass, otherwise the evicted objects would stay alive uncounted
+  // until the thread opens another pass, which may never happen.
+  if (pinned.passDepth > 0) {
+    pinned.objects.push_back(std::move(object));
+  }
+}
+
+void FrameCacheMemory::Register(FrameEntriesBase* entries) {
+  std::lock_guard<std::mutex> autoLock(registryLocker);
+  registry.insert(entries);
+}
+
+void FrameCacheMemory::Unregister(FrameEntriesBase* entries) {
+  std::lock_guard<std::mutex> autoLock(registryLocker);
+  registry.erase(entries);
+}
+
+CacheCounters& FrameCacheMemory::ThreadCounters() {
+  static thread_local CacheCounters counters = {};
+  return counters;
+}
+
+FrameCachePass::FrameCachePass() {
+  pinnedObjects.passDepth++;
+}
+
+FrameCachePass::~FrameCachePass() {
+  auto& pinned = pinnedObjects;
+  if (--pinned.passDepth > 0) {
+    return;
+  }
+  // The objects may pin others while being released, swaps them out first.
+  std::vector<std::shared_ptr<void>> objects = {};
+  objects.swap(pinned.objects);
+}
+
+void FrameEntriesBase::touch() {
+  lastAccess.store(++accessClock, std::memory_order_relaxed);
+}
+}  // namespace pag
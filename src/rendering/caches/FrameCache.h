@@ -18,10 +18,259 @@
 
 #pragma once
 
-#include <unordered_map>
+#include <atomic>
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
 #include "pag/file.h"
 
 namespace pag {
+// The number of most recently requested frames that a frame cache evicts last, so that seeking back
+// and forth between a few frames does not re-create them.
+#define FRAME_CACHE_PROTECTED_COUNT 4
+
+class FrameEntriesBase;
+
+/**
+ * Tracks the memory taken up by the per-frame contents of all frame caches in the process.
+ */
+class FrameCacheMemory {
+ public:
+  static void Add(size_t bytes);
+
+  static void Remove(size_t bytes);
+
+  /**
+   * Returns the limit set by PAG::SetFrameCacheLimit().
+   */
+  static size_t Limit();
+
+  /**
+   * Returns true if the per-frame contents take up more memory than the limit set by
+   * PAG::SetFrameCacheLimit().
+   */
+  static bool Exceeded();
+
+  /**
+   * Evicts entries from all frame caches in the process until the memory is back under the limit.
+   * The caches that have not been accessed for the longest time go first. The current cache must
+   * be locked by the caller, the others are skipped if they are in use by other threads.
+   */
+  static void Purge(FrameEntriesBase* current);
+
+  /**
+   * Keeps the object handed out by a frame cache alive until the current FrameCachePass ends on
+   * the calling thread, even if it is evicted by other threads in the meantime. Does nothing
+   * outside of any pass, the object is then only kept alive by the cache itself.
+   */
+  static void Pin(std::shared_ptr<void> object);
+
+  /**
+   * Returns the counters of all frame caches accessed by the calling thread, accumulated since the
+   * thread started.
+   */
+  static CacheCounters& ThreadCounters();
+
+ private:
+  static void Register(FrameEntriesBase* entries);
+
+  static void Unregister(FrameEntriesBase* entries);
+
+  friend class FrameEntriesBase;
+};
+
+/**
+ * The entries handed out by frame caches on the current thread stay alive until the outermost
+ * FrameCachePass is destroyed. Every public entry point that walks layer caches should be wrapped
+ * in one, since it keeps the raw pointers returned by FrameCache::getCache() until it finishes.
+ */
+class FrameCachePass {
+ public:
+  FrameCachePass();
+
+  ~FrameCachePass();
+};
+
+/**
+ * The type independent part of FrameEntries, which is registered to FrameCacheMemory so that the
+ * memory limit is enforced across all frame caches in the process.
+ */
+class FrameEntriesBase {
+ public:
+  /**
+   * Creates entries guarded by the specified locker, which allows other caches to evict from them.
+   * The entries can only evict from themselves if the locker is nullptr.
+   */
+  explicit FrameEntriesBase(std::mutex* locker) : locker(locker) {
+    FrameCacheMemory::Register(this);
+  }
+
+  virtual ~FrameEntriesBase() = default;
+
+ protected:
+  /**
+   * Must be called first in the destructor of subclasses, so that other caches stop evicting from
+   * the entries before they are destroyed.
+   */
+  void unregister() {
+    FrameCacheMemory::Unregister(this);
+  }
+
+  void touch();
+
+  /**
+   * Evicts the entry farthest away from the playhead and moves its value to evicted, so it can be
+   * released without holding any locks. The playhead itself is kept if keepPlayhead is true.
+   * Returns false if nothing can be evicted.
+   */
+  virtual bool evictOne(bool keepPlayhead, std::vector<std::shared_ptr<void>>* evicted) = 0;
+
+ private:
+  std::mutex* locker = nullptr;
+  std::atomic<uint64_t> lastAccess = {0};
+
+  friend class FrameCacheMemory;
+};
+
+/**
+ * The per-frame entries of a frame cache, keyed by content frames. Once the per-frame contents of
+ * all caches in the process exceed the memory limit, the caches that have not been accessed for the
+ * longest time are evicted first, and each cache evicts its entries that are farthest away from the
+ * playhead, which is the last requested frame. It is not thread safe, the owner must guard it with
+ * the locker passed to the constructor.
+ */
+template <typename V>
+class FrameEntries : public FrameEntriesBase {
+ public:
+  explicit FrameEntries(std::mutex* locker = nullptr) : FrameEntriesBase(locker) {
+  }
+
+  ~FrameEntries() override {
+    unregister();
+    FrameCacheMemory::Remove(totalMemory);
+  }
+
+  /**
+   * Returns the entry of the specified frame and moves the playhead to it, or nullptr if the
+   * frame is not cached.
+   */
+  V* find(Frame frame) {
+    touch();
+    markUsed(frame);
+    auto& counters = FrameCacheMemory::ThreadCounters();
+    auto result = entries.find(frame);
+    if (result == entries.end()) {
+      counters.misses++;
+      return nullptr;
+    }
+    counters.hits++;
+    return &result->second.value;
+  }
+
+  /**
+   * Adds an entry for the specified frame with the estimated memory in bytes, then evicts entries
+   * of all frame caches if the memory limit is exceeded.
+   */
+  void insert(Frame frame, V value, size_t memory) {
+    entries[frame] = {std::move(value), memory};
+    totalMemory += memory;
+    FrameCacheMemory::Add(memory);
+    FrameCacheMemory::ThreadCounters().allocatedBytes += static_cast<int64_t>(memory);
+    if (FrameCacheMemory::Exceeded()) {
+      FrameCacheMemory::Purge(this);
+    }
+  }
+
+  size_t memoryUsage() const {
+    return totalMemory;
+  }
+
+ protected:
+  bool evictOne(bool keepPlayhead, std::vector<std::shared_ptr<void>>* evicted) override {
+    // The entries farthest from the playhead are at either end of the map. The recently requested
+    // ones go last, and the playhead only goes if the entries are not the ones being filled.
+    auto victim = findVictim(recentCount);
+    if (victim == entries.end()) {
+      victim = findVictim(std::min(recentCount, static_cast<size_t>(1)));
+    }
+    if (victim == entries.end() && !keepPlayhead) {
+      victim = findVictim(0);
+    }
+    if (victim == entries.end()) {
+      return false;
+    }
+    totalMemory -= victim->second.memory;
+    FrameCacheMemory::Remove(victim->second.memory);
+    auto& counters = FrameCacheMemory::ThreadCounters();
+    counters.evictions++;
+    counters.evictedBytes += static_cast<int64_t>(victim->second.memory);
+    evicted->push_back(std::shared_ptr<void>(std::move(victim->second.value)));
+    entries.erase(victim);
+    return true;
+  }
+
+ private:
+  struct Entry {
+    V value;
+    size_t memory;
+  };
+
+  std::map<Frame, Entry> entries;
+  // The most recently requested frames, the first one is the playhead.
+  Frame recentFrames[FRAME_CACHE_PROTECTED_COUNT] = {};
+  size_t recentCount = 0;
+  size_t totalMemory = 0;
+
+  void markUsed(Frame frame) {
+    size_t index = 0;
+    while (index < recentCount && recentFrames[index] != frame) {
+      index++;
+    }
+    if (index == recentCount) {
+      if (recentCount < FRAME_CACHE_PROTECTED_COUNT) {
+        recentCount++;
+      } else {
+        index--;
+      }
+    }
+    for (; index > 0; index--) {
+      recentFrames[index] = recentFrames[index - 1];
+    }
+    recentFrames[0] = frame;
+  }
+
+  bool isProtected(Frame frame, size_t protectedCount) const {
+    for (size_t i = 0; i < protectedCount; i++) {
+      if (recentFrames[i] == frame) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  typename std::map<Frame, Entry>::iterator findVictim(size_t protectedCount) {
+    auto first = entries.begin();
+    while (first != entries.end() && isProtected(first->first, protectedCount)) {
+      first++;
+    }
+    if (first == entries.end()) {
+      return entries.end();
+    }
+    auto last = std::prev(entries.end());
+    while (isProtected(last->first, protectedCount)) {
+      last--;
+    }
+    if (recentCount == 0) {
+      return first;
+    }
+    auto playhead = recentFrames[0];
+    return std::abs(last->first - playhead) > std::abs(first->first - playhead) ? last : first;
+  }
+};
+
 template <typename T>
 class FrameCache : public Cache {
  public:
@@ -34,12 +283,11 @@ class FrameCache : public Cache {
     staticTimeRanges.push_back(range);
   }
 
-  ~FrameCache() override {
-    for (auto& item : frames) {
-      delete item.second;
-    }
-  }
-
+  /**
+   * Returns the cache of the specified frame, creating it if necessary. The returned cache is kept
+   * alive until the current FrameCachePass ends on the calling thread, callers should not keep it
+   * any longer than that.
+   */
   virtual T* getCache(Frame contentFrame) {
     contentFrame = ConvertFrameByStaticTimeRanges(staticTimeRanges, contentFrame);
     if (contentFrame >= duration) {
@@ -49,12 +297,16 @@ class FrameCache : public Cache {
       contentFrame = 0;
     }
     std::lock_guard<std::mutex> autoLock(locker);
-    auto cache = frames[contentFrame];
-    if (cache == nullptr) {
-      cache = createCache(contentFrame + startTime);
-      frames[contentFrame] = cache;
+    auto result = frames.find(contentFrame);
+    if (result != nullptr) {
+      FrameCacheMemory::Pin(*result);
+      return result->get();
     }
-    return cache;
+    auto cache = std::shared_ptr<T>(createCache(contentFrame + startTime));
+    // Pins it before inserting, the insertion may evict it right away.
+    FrameCacheMemory::Pin(cache);
+    frames.insert(contentFrame, cache, memoryUsage(cache.get()));
+    return cache.get();
   }
 
   const std::vector<TimeRange>* getStaticTimeRanges() const {
@@ -68,8 +320,15 @@ class FrameCache : public Cache {
 
   virtual T* createCache(Frame layerFrame) = 0;
 
+  /**
+   * Returns the estimated memory in bytes taken up by the specified cache.
+   */
+  virtual size_t memoryUsage(const T*) const {
+    return sizeof(T);
+  }
+
  private:
   std::mutex locker = {};
-  std::unordered_map<Frame, T*> frames;
+  FrameEntries<std::shared_ptr<T>> frames{&locker};
 };
 }  // namespace pag
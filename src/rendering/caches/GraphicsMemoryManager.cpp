@@ -0,0 +1,192 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "GraphicsMemoryManager.h"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "base/utils/GetTimer.h"
+#include "pag/pag.h"
+
+namespace pag {
+#define DEFAULT_MAX_GRAPHICS_MEMORY 314572800  // 300M
+
+struct CacheMemory {
+  int64_t lastActiveTime = 0;
+  size_t memoryUsage = 0;
+  size_t purgeRequest = 0;
+  uint32_t deviceID = 0;
+};
+
+static std::mutex locker = {};
+static std::unordered_map<RenderCache*, CacheMemory> caches = {};
+static std::unordered_map<uint32_t, size_t> recycledMemories = {};
+static std::atomic_size_t totalMemory = {0};
+static std::atomic_size_t maxGraphicsMemory = {DEFAULT_MAX_GRAPHICS_MEMORY};
+
+static void UpdatePurgeRequests() {
+  size_t maxMemory = maxGraphicsMemory;
+  size_t requested = 0;
+  std::vector<std::pair<int64_t, CacheMemory*>> candidates = {};
+  for (auto& item : caches) {
+    requested += item.second.purgeRequest;
+    candidates.emplace_back(item.second.lastActiveTime, &item.second);
+  }
+  if (totalMemory <= maxMemory + requested) {
+    return;
+  }
+  auto excess = totalMemory - maxMemory - requested;
+  // The caches that have been idle the longest release their memory first.
+  std::sort(candidates.begin(), candidates.end(),
+            [](const std::pair<int64_t, CacheMemory*>& a,
+               const std::pair<int64_t, CacheMemory*>& b) { return a.first < b.first; });
+  for (auto& candidate : candidates) {
+    auto cache = candidate.second;
+    auto releasable = cache->memoryUsage - std::min(cache->memoryUsage, cache->purgeRequest);
+    auto request = std::min(releasable, excess);
+    cache->purgeRequest += request;
+    excess -= request;
+    if (excess == 0) {
+      break;
+    }
+  }
+}
+
+void PAG::SetMaxGraphicsMemory(size_t maxMemory) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  maxGraphicsMemory = maxMemory;
+  // Requests the idle caches to release the memory above the new budget right away, instead of
+  // waiting for the next allocation.
+  UpdatePurgeRequests();
+}
+
+size_t PAG::GraphicsMemory() {
+  return totalMemory;
+}
+
+static void ReleaseDevice(uint32_t deviceID) {
+  auto result = recycledMemories.find(deviceID);
+  if (result == recycledMemories.end()) {
+    return;
+  }
+  for (auto& item : caches) {
+    if (item.second.deviceID == deviceID) {
+      return;
+    }
+  }
+  totalMemory -= result->second;
+  recycledMemories.erase(result);
+}
+
+static void SetCacheDevice(CacheMemory* memory, uint32_t deviceID) {
+  if (memory->deviceID == deviceID) {
+    return;
+  }
+  auto oldDeviceID = memory->deviceID;
+  memory->deviceID = deviceID;
+  ReleaseDevice(oldDeviceID);
+}
+
+void GraphicsMemoryManager::Register(RenderCache* cache) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  caches[cache].lastActiveTime = GetTimer();
+}
+
+void GraphicsMemoryManager::Unregister(RenderCache* cache) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  auto result = caches.find(cache);
+  if (result == caches.end()) {
+    return;
+  }
+  totalMemory -= result->second.memoryUsage;
+  auto deviceID = result->second.deviceID;
+  caches.erase(result);
+  ReleaseDevice(deviceID);
+}
+
+void GraphicsMemoryManager::MarkActive(RenderCache* cache) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  caches[cache].lastActiveTime = GetTimer();
+}
+
+void GraphicsMemoryManager::AddMemory(RenderCache* cache, size_t bytes) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  caches[cache].memoryUsage += bytes;
+  totalMemory += bytes;
+  UpdatePurgeRequests();
+}
+
+void GraphicsMemoryManager::RemoveMemory(RenderCache* cache, size_t bytes) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  auto& memory = caches[cache];
+  bytes = std::min(bytes, memory.memoryUsage);
+  memory.memoryUsage -= bytes;
+  memory.purgeRequest -= std::min(bytes, memory.purgeRequest);
+  totalMemory -= bytes;
+}
+
+void GraphicsMemoryManager::AddSharedMemory(size_t bytes) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  totalMemory += bytes;
+  UpdatePurgeRequests();
+}
+
+void GraphicsMemoryManager::RemoveSharedMemory(size_t bytes) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  totalMemory -= bytes;
+}
+
+void GraphicsMemoryManager::SetRecycledMemory(RenderCache* cache, uint32_t deviceID, size_t bytes) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  SetCacheDevice(&caches[cache], deviceID);
+  auto& recycledMemory = recycledMemories[deviceID];
+  totalMemory += bytes;
+  totalMemory -= recycledMemory;
+  recycledMemory = bytes;
+  UpdatePurgeRequests();
+}
+
+void GraphicsMemoryManager::DetachDevice(RenderCache* cache) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  auto result = caches.find(cache);
+  if (result != caches.end()) {
+    SetCacheDevice(&result->second, 0);
+  }
+}
+
+size_t GraphicsMemoryManager::MaxMemory() {
+  return maxGraphicsMemory;
+}
+
+bool GraphicsMemoryManager::BudgetExceeded() {
+  return totalMemory >= maxGraphicsMemory;
+}
+
+size_t GraphicsMemoryManager::TakePurgeRequest(RenderCache* cache) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  auto result = caches.find(cache);
+  if (result == caches.end()) {
+    return 0;
+  }
+  auto request = result->second.purgeRequest;
+  result->second.purgeRequest = 0;
+  return request;
+}
+}  // namespace pag
@@ -0,0 +1,87 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pag {
+class RenderCache;
+
+/**
+ * Coordinates the graphics memory of all RenderCaches in the process. Each RenderCache reports the
+ * memory of its caches here. Once the total exceeds the budget set by PAG::SetMaxGraphicsMemory(),
+ * the caches that have been idle the longest are requested to release the excess. RenderCaches
+ * can only free their GPU resources while their own device is locked, so each request is served
+ * the next time the cache attaches to its context, before anything new is allocated, and again
+ * when it detaches. All methods are thread safe.
+ */
+class GraphicsMemoryManager {
+ public:
+  static void Register(RenderCache* cache);
+
+  static void Unregister(RenderCache* cache);
+
+  /**
+   * Marks the specified cache as being used for rendering now.
+   */
+  static void MarkActive(RenderCache* cache);
+
+  static void AddMemory(RenderCache* cache, size_t bytes);
+
+  static void RemoveMemory(RenderCache* cache, size_t bytes);
+
+  /**
+   * Charges the memory of a texture shared by multiple caches, which is counted once in the total
+   * but not in the memory of any cache.
+   */
+  static void AddSharedMemory(size_t bytes);
+
+  static void RemoveSharedMemory(size_t bytes);
+
+  /**
+   * Reports the memory of the recycled resources kept by the context of the specified device, which
+   * the cache has just drawn with. The context may be shared by multiple caches, so the memory is
+   * charged once for each device, and released once no cache uses the device anymore.
+   */
+  static void SetRecycledMemory(RenderCache* cache, uint32_t deviceID, size_t bytes);
+
+  /**
+   * Marks the specified cache as no longer using the device it reported recycled memory for.
+   */
+  static void DetachDevice(RenderCache* cache);
+
+  /**
+   * Returns the budget set by PAG::SetMaxGraphicsMemory().
+   */
+  static size_t MaxMemory();
+
+  /**
+   * Returns true if the total graphics memory reaches the budget, new caches should not be created
+   * until some memory is released.
+   */
+  static bool BudgetExceeded();
+
+  /**
+   * Returns the number of bytes the specified cache is requested to release, and clears the
+   * request.
+   */
+  static size_t TakePurgeRequest(RenderCache* cache);
+};
+}  // namespace pag
@@ -106,6 +106,10 @@ bool LayerCache::checkFrameChanged(Frame contentFrame, Frame lastContentFrame) {
   return contentFrame != lastContentFrame;
 }
 
+Frame LayerCache::getStaticFrame(Frame contentFrame) const {
+  return ConvertFrameByStaticTimeRanges(staticTimeRanges, contentFrame);
+}
+
 bool LayerCache::contentVisible(Frame contentFrame) {
   if (contentFrame < 0 || contentFrame >= layer->duration) {
     return false;
@@ -114,6 +118,10 @@ bool LayerCache::contentVisible(Frame contentFrame) {
   return layerTransform->visible();
 }
 
+bool LayerCache::transformStatic() const {
+  return !HasVaryingTimeRange(transformCache->getStaticTimeRanges(), 0, layer->duration);
+}
+
 void LayerCache::updateStaticTimeRanges() {
   // layer->startTime is excluded from all time ranges.
   if (layer->type() == LayerType::PreCompose &&
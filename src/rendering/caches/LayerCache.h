@@ -41,8 +41,20 @@ class LayerCache : public Cache {
 
   bool checkFrameChanged(Frame contentFrame, Frame lastContentFrame);
 
+  /**
+   * Returns the first frame of the static time range that the contentFrame falls in, which draws
+   * the same content as the contentFrame.
+   */
+  Frame getStaticFrame(Frame contentFrame) const;
+
   bool contentVisible(Frame contentFrame);
 
+  /**
+   * Returns true if the transform of the layer, including the ones of its parents, never changes
+   * during the visible time range of the layer.
+   */
+  bool transformStatic() const;
+
   bool contentStatic() const {
     return contentCache->contentStatic();
   }
@@ -34,4 +34,9 @@ Path* MaskCache::createCache(Frame layerFrame) {
   RenderMasks(maskContent, layer->masks, layerFrame);
   return maskContent;
 }
+
+size_t MaskCache::memoryUsage(const Path* path) const {
+  return sizeof(Path) + static_cast<size_t>(path->countPoints()) * sizeof(Point) +
+         static_cast<size_t>(path->countVerbs());
+}
 }  // namespace pag
\ No newline at end of file
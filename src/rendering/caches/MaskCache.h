@@ -28,6 +28,7 @@ class MaskCache : public FrameCache<Path> {
 
  protected:
   Path* createCache(Frame layerFrame) override;
+  size_t memoryUsage(const Path* path) const override;
 
  private:
   Layer* layer = nullptr;
@@ -0,0 +1,141 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "PrefetchScheduler.h"
+#include <algorithm>
+#include "base/utils/GetTimer.h"
+#include "base/utils/Task.h"
+
+namespace pag {
+// 未知耗时的素材按 250ms 估算，即沿用原先提前 500ms 开始解码的策略。
+#define DEFAULT_PREFETCH_COST 250000
+// 默认硬解初始化耗时，距离可见时刻小于该值的视频先用软解。
+#define DEFAULT_HARDWARE_INITIAL_COST 100000
+// 预测的提前量是估算耗时的两倍，以抵消耗时的波动。
+#define PREFETCH_SAFETY_FACTOR 2
+#define MIN_PREFETCH_LEAD_TIME 50000
+#define MAX_PREFETCH_LEAD_TIME 2000000
+// 每次记录新的耗时后，历史峰值按该比例衰减。
+#define PREFETCH_COST_DECAY 0.9f
+// 尚未被取用的预测解码最多占用 32M 内存。
+#define MAX_PREFETCH_MEMORY 33554432
+// 两帧之间超过 1s 视为暂停或跳转，不参与播放速率的估算。
+#define MAX_PLAYBACK_INTERVAL 1000000
+#define MIN_PLAYBACK_RATE 0.1f
+#define MAX_PLAYBACK_RATE 10.0f
+
+void PrefetchScheduler::beginFrame(int64_t contentTime, int64_t hardwareInitialTime) {
+  for (auto& item : frameCosts) {
+    auto& cost = assetCosts[item.first];
+    // Keeps a decaying peak, the first frame of an asset usually costs the most.
+    auto decayedCost = static_cast<int64_t>(static_cast<float>(cost) * PREFETCH_COST_DECAY);
+    cost = std::max(item.second, decayedCost);
+  }
+  frameCosts = {};
+  prefetchedAssets = {};
+  if (hardwareInitialTime > 0) {
+    auto decayedCost =
+        static_cast<int64_t>(static_cast<float>(hardwareInitialCost) * PREFETCH_COST_DECAY);
+    hardwareInitialCost = std::max(hardwareInitialTime, decayedCost);
+  }
+  auto timestamp = GetTimer();
+  auto contentInterval = contentTime - lastContentTime;
+  auto interval = timestamp - lastTimestamp;
+  if (lastContentTime >= 0 && contentInterval > 0 && interval > 0 &&
+      interval < MAX_PLAYBACK_INTERVAL) {
+    auto rate = static_cast<float>(contentInterval) / static_cast<float>(interval);
+    rate = std::max(MIN_PLAYBACK_RATE, std::min(rate, MAX_PLAYBACK_RATE));
+    playbackRate = playbackRate * 0.8f + rate * 0.2f;
+  }
+  lastContentTime = contentTime;
+  lastTimestamp = timestamp;
+  queueLoad = Task::QueueLoad();
+}
+
+int64_t PrefetchScheduler::lookAheadTime() const {
+  auto maxCost = static_cast<int64_t>(DEFAULT_PREFETCH_COST);
+  for (auto& item : assetCosts) {
+    maxCost = std::max(maxCost, item.second);
+  }
+  return leadTime(maxCost);
+}
+
+bool PrefetchScheduler::shouldPrefetch(ID assetID, int64_t distance, size_t memory) {
+  if (distance > leadTime(getCost(assetID))) {
+    return false;
+  }
+  if (prefetchMemories.count(assetID) > 0) {
+    return true;
+  }
+  if (prefetchMemory > 0 && prefetchMemory + memory > MAX_PREFETCH_MEMORY) {
+    return false;
+  }
+  prefetchMemories[assetID] = memory;
+  prefetchMemory += memory;
+  return true;
+}
+
+bool PrefetchScheduler::needsSoftwareDecoding(int64_t distance) const {
+  auto initialCost = hardwareInitialCost > 0 ? hardwareInitialCost : DEFAULT_HARDWARE_INITIAL_COST;
+  return static_cast<float>(distance) < static_cast<float>(initialCost) * playbackRate;
+}
+
+void PrefetchScheduler::finishPrefetch(ID assetID) {
+  auto result = prefetchMemories.find(assetID);
+  if (result == prefetchMemories.end()) {
+    return;
+  }
+  prefetchMemory -= result->second;
+  prefetchMemories.erase(result);
+}
+
+void PrefetchScheduler::markPrefetched(ID assetID) {
+  prefetchedAssets.insert(assetID);
+}
+
+void PrefetchScheduler::recordCost(ID assetID, int64_t time) {
+  if (prefetchedAssets.count(assetID) > 0) {
+    return;
+  }
+  frameCosts[assetID] += time;
+}
+
+void PrefetchScheduler::removeAsset(ID assetID) {
+  finishPrefetch(assetID);
+  assetCosts.erase(assetID);
+  frameCosts.erase(assetID);
+  prefetchedAssets.erase(assetID);
+}
+
+int64_t PrefetchScheduler::leadTime(int64_t cost) const {
+  // The distances are in content time, a faster playback leaves less time to prefetch. The tasks
+  // waiting in the thread pool delay a new prefetch by roughly one task for each of them.
+  auto time = static_cast<float>(cost * PREFETCH_SAFETY_FACTOR) * (1.0f + queueLoad) * playbackRate;
+  auto leadTime = static_cast<int64_t>(time);
+  return std::max(static_cast<int64_t>(MIN_PREFETCH_LEAD_TIME),
+                  std::min(leadTime, static_cast<int64_t>(MAX_PREFETCH_LEAD_TIME)));
+}
+
+int64_t PrefetchScheduler::getCost(ID assetID) const {
+  auto result = assetCosts.find(assetID);
+  if (result == assetCosts.end()) {
+    return DEFAULT_PREFETCH_COST;
+  }
+  return result->second;
+}
+}  // namespace pag
@@ -0,0 +1,98 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <unordered_map>
+#include <unordered_set>
+#include "pag/types.h"
+
+namespace pag {
+/**
+ * Decides when the assets that are about to become visible, such as images and sequences, start
+ * decoding. It learns how long each asset takes to decode and upload, then starts its prefetch
+ * just early enough to be ready in time, given the playback rate and how busy the thread pool is.
+ * The memory of the prefetches that have not been consumed yet is capped. It is not thread safe,
+ * the owner must guard it with a lock.
+ */
+class PrefetchScheduler {
+ public:
+  /**
+   * Called at the beginning of each frame with the current time of the content in microseconds
+   * and the initialization time of the hardware decoders during the previous frame.
+   */
+  void beginFrame(int64_t contentTime, int64_t hardwareInitialTime);
+
+  /**
+   * Returns the maximum time distance in microseconds of the assets that may need to start
+   * prefetching in the current frame, which is decided by the most expensive asset that is still
+   * on the stage.
+   */
+  int64_t lookAheadTime() const;
+
+  /**
+   * Returns true if the specified asset, which becomes visible after the time distance in
+   * microseconds, should start prefetching now. If it returns true, the memory is counted as in
+   * flight until finishPrefetch() is called with the same asset.
+   */
+  bool shouldPrefetch(ID assetID, int64_t distance, size_t memory);
+
+  /**
+   * Returns true if a sequence that becomes visible after the time distance in microseconds does
+   * not have enough time to initialize a hardware decoder, and should start with a software one.
+   */
+  bool needsSoftwareDecoding(int64_t distance) const;
+
+  /**
+   * Marks the prefetch of the specified asset as consumed or dropped, releasing its memory.
+   */
+  void finishPrefetch(ID assetID);
+
+  /**
+   * Marks the specified asset as served by a prefetch in the current frame. The costs recorded for
+   * it on the rendering thread are skipped until the next frame, they do not include the decoding
+   * which has been done in advance.
+   */
+  void markPrefetched(ID assetID);
+
+  /**
+   * Records the time in microseconds spent on decoding or uploading the specified asset.
+   */
+  void recordCost(ID assetID, int64_t time);
+
+  /**
+   * Forgets the specified asset, which has been removed from the stage.
+   */
+  void removeAsset(ID assetID);
+
+ private:
+  std::unordered_map<ID, int64_t> assetCosts = {};
+  std::unordered_map<ID, int64_t> frameCosts = {};
+  std::unordered_set<ID> prefetchedAssets = {};
+  std::unordered_map<ID, size_t> prefetchMemories = {};
+  size_t prefetchMemory = 0;
+  int64_t lastContentTime = -1;
+  int64_t lastTimestamp = 0;
+  int64_t hardwareInitialCost = 0;
+  float playbackRate = 1.0f;
+  float queueLoad = 0.0f;
+
+  int64_t leadTime(int64_t cost) const;
+  int64_t getCost(ID assetID) const;
+};
+}  // namespace pag
@@ -22,18 +22,60 @@
 #include "base/utils/TimeUtil.h"
 #include "base/utils/USE.h"
 #include "base/utils/UniqueID.h"
+#include "gpu/GradientShader.h"
+#include "rendering/caches/FrameCache.h"
+#include "rendering/caches/GraphicsMemoryManager.h"
 #include "rendering/caches/ImageContentCache.h"
 #include "rendering/caches/LayerCache.h"
+#include "rendering/caches/SharedSnapshotCache.h"
 #include "rendering/renderers/FilterRenderer.h"
+#include "rendering/renderers/ShapeRenderer.h"
 
 namespace pag {
-// 300M设置的大一些用于兜底，通常在大于20M时就开始随时清理。
-#define MAX_GRAPHICS_MEMORY 314572800
+// 总显存上限由 GraphicsMemoryManager 统一管理，单个缓存通常在大于20M时就开始随时清理。
 #define PURGEABLE_GRAPHICS_MEMORY 20971520  // 20M
 #define PURGEABLE_EXPIRED_FRAME 10
-#define SCALE_FACTOR_PRECISION 0.001f
-#define DECODING_VISIBLE_DISTANCE 500000  // 提前 500ms 秒开始解码。
-#define MIN_HARDWARE_PREPARE_TIME 100000  // 距离当前时刻小于100ms的视频启动软解转硬解优化。
+#define MIN_SCALE_FACTOR 0.001f
+// Snapshot 的缩放值按 √2 的整数次幂分档，缩放动画过程中相邻的缩放值可以复用同一个 Snapshot。
+#define SCALE_BUCKETS_PER_OCTAVE 2
+#define SCALE_BUCKET_TOLERANCE 0.001f
+
+/**
+ * Returns the smallest scale bucket whose scale factor is not less than the specified one.
+ */
+static int ScaleFactorToBucket(float scaleFactor) {
+  auto bucket = log2f(scaleFactor) * SCALE_BUCKETS_PER_OCTAVE;
+  return static_cast<int>(ceilf(bucket - SCALE_BUCKET_TOLERANCE));
+}
+
+static float BucketToScaleFactor(int scaleBucket) {
+  return exp2f(static_cast<float>(scaleBucket) / SCALE_BUCKETS_PER_OCTAVE);
+}
+
+/**
+ * A snapshot can be reused if it is in the requested bucket or in the next larger one, scaling it
+ * down by at most √2 keeps the content sharp. The larger one takes up twice the pixels, it is only
+ * kept for PURGEABLE_EXPIRED_FRAME frames if the content stays in the smaller bucket.
+ */
+static bool ScaleBucketMatches(int snapshotBucket, int scaleBucket) {
+  return snapshotBucket == scaleBucket || snapshotBucket == scaleBucket + 1;
+}
+
+/**
+ * Returns the graphics memory of a sequence reader, which holds the texture of the current frame.
+ */
+static size_t SequenceMemory(const Sequence* sequence) {
+  return static_cast<size_t>(sequence->width) * static_cast<size_t>(sequence->height) * 4;
+}
+
+static void AddCounters(CacheCounters* total, const CacheCounters& current,
+                        const CacheCounters& base) {
+  total->hits += current.hits - base.hits;
+  total->misses += current.misses - base.misses;
+  total->evictions += current.evictions - base.evictions;
+  total->allocatedBytes += current.allocatedBytes - base.allocatedBytes;
+  total->evictedBytes += current.evictedBytes - base.evictedBytes;
+}
 
 class ImageTask : public Executor {
  public:
@@ -51,23 +93,47 @@ class ImageTask : public Executor {
     return buffer;
   }
 
+  int64_t getDecodingTime() const {
+    return decodingTime;
+  }
+
  private:
   std::shared_ptr<TextureBuffer> buffer = {};
+  int64_t decodingTime = 0;
   std::shared_ptr<Image> image = nullptr;
 
   explicit ImageTask(std::shared_ptr<Image> image) : image(std::move(image)) {
   }
 
   void execute() override {
+    auto startTime = GetTimer();
     buffer = image->makeBuffer();
+    decodingTime = GetTimer() - startTime;
   }
 };
 
 RenderCache::RenderCache(PAGStage* stage) : _uniqueID(UniqueID::Next()), stage(stage) {
+  GraphicsMemoryManager::Register(this);
 }
 
 RenderCache::~RenderCache() {
   releaseAll();
+  GraphicsMemoryManager::Unregister(this);
+}
+
+void RenderCache::preparePathMask(const Path& path, const Matrix& matrix) {
+  auto pendingMask = PendingPathMask::Make(path, matrix);
+  if (pendingMask == nullptr) {
+    return;
+  }
+  auto& key = pendingMask->key();
+  auto prepared = preparedPathMasks.count(key) > 0 || lastPreparedPathMasks.count(key) > 0;
+  preparedPathMasks.insert(key);
+  if (prepared) {
+    return;
+  }
+  pendingMask->run();
+  pendingPathMasks.push_back(std::move(pendingMask));
 }
 
 uint32_t RenderCache::getContentVersion() const {
@@ -93,7 +159,7 @@ bool RenderCache::initFilter(Filter* filter) {
   return result;
 }
 
-void RenderCache::preparePreComposeLayer(PreComposeLayer* layer, DecodingPolicy policy) {
+void RenderCache::preparePreComposeLayer(PreComposeLayer* layer, int64_t distance) {
   auto composition = layer->composition;
   if (composition->type() != CompositionType::Video &&
       composition->type() != CompositionType::Bitmap) {
@@ -109,29 +175,51 @@ void RenderCache::preparePreComposeLayer(PreComposeLayer* layer, DecodingPolicy
   }
   auto sequence = Sequence::Get(composition);
   auto sequenceFrame = sequence->toSequenceFrame(compositionFrame);
-  if (prepareSequenceReader(sequence, sequenceFrame, policy)) {
-    return;
-  }
   auto result = sequenceCaches.find(composition->uniqueID);
   if (result != sequenceCaches.end()) {
+    usedAssets.insert(composition->uniqueID);
     // 循环预测
     result->second->prepareAsync(sequenceFrame);
+    return;
+  }
+  if (!prefetchScheduler.shouldPrefetch(composition->uniqueID, distance,
+                                       SequenceMemory(sequence))) {
+    return;
+  }
+  auto policy = prefetchScheduler.needsSoftwareDecoding(distance)
+                    ? DecodingPolicy::SoftwareToHardware
+                    : DecodingPolicy::Hardware;
+  if (!prepareSequenceReader(sequence, sequenceFrame, policy)) {
+    prefetchScheduler.finishPrefetch(composition->uniqueID);
   }
 }
 
-void RenderCache::prepareImageLayer(PAGImageLayer* pagLayer) {
+void RenderCache::prepareImageLayer(PAGImageLayer* pagLayer, int64_t distance) {
+  ID assetID = 0;
+  std::shared_ptr<Image> image = nullptr;
   auto pagImage = static_cast<PAGImageLayer*>(pagLayer)->getPAGImage();
   if (pagImage == nullptr) {
     auto imageBytes = static_cast<ImageLayer*>(pagLayer->layer)->imageBytes;
-    auto image = ImageContentCache::GetImage(imageBytes);
-    if (image) {
-      prepareImage(imageBytes->uniqueID, image);
-    }
+    assetID = imageBytes->uniqueID;
+    image = ImageContentCache::GetImage(imageBytes);
+  } else {
+    assetID = pagImage->uniqueID();
+    image = pagImage->getImage();
+  }
+  if (image == nullptr) {
     return;
   }
-  auto image = pagImage->getImage();
-  if (image) {
-    prepareImage(pagImage->uniqueID(), image);
+  if (imageTasks.count(assetID) != 0 || snapshotCaches.count(assetID) != 0) {
+    usedAssets.insert(assetID);
+    return;
+  }
+  auto memory = static_cast<size_t>(image->width()) * static_cast<size_t>(image->height()) * 4;
+  if (!prefetchScheduler.shouldPrefetch(assetID, distance, memory)) {
+    return;
+  }
+  prepareImage(assetID, image);
+  if (imageTasks.count(assetID) == 0) {
+    prefetchScheduler.finishPrefetch(assetID);
   }
 }
 
@@ -159,18 +247,30 @@ void RenderCache::setSnapshotEnabled(bool value) {
   clearAllSnapshots();
 }
 
+bool RenderCache::sharedSnapshotEnabled() const {
+  return _sharedSnapshotEnabled;
+}
+
+void RenderCache::setSharedSnapshotEnabled(bool value) {
+  _sharedSnapshotEnabled = value;
+}
+
 void RenderCache::prepareFrame() {
   usedAssets = {};
+  auto root = stage->getRootComposition();
+  auto contentTime = root ? root->currentTimeInternal() : 0;
+  prefetchScheduler.beginFrame(contentTime, hardwareDecodingInitialTime);
   resetPerformance();
-  auto layerDistances = stage->findNearlyVisibleLayersIn(DECODING_VISIBLE_DISTANCE);
+  contentCountersBase = FrameCacheMemory::ThreadCounters();
+  GraphicsMemoryManager::MarkActive(this);
+  // The nearest layers come first, they take the prefetch memory before the farther ones.
+  auto layerDistances = stage->findNearlyVisibleLayersIn(prefetchScheduler.lookAheadTime());
   for (auto& item : layerDistances) {
     for (auto pagLayer : item.second) {
       if (pagLayer->layerType() == LayerType::PreCompose) {
-        auto policy = item.first < MIN_HARDWARE_PREPARE_TIME ? DecodingPolicy::SoftwareToHardware
-                                                             : DecodingPolicy::Hardware;
-        preparePreComposeLayer(static_cast<PreComposeLayer*>(pagLayer->layer), policy);
+        preparePreComposeLayer(static_cast<PreComposeLayer*>(pagLayer->layer), item.first);
       } else if (pagLayer->layerType() == LayerType::Image) {
-        prepareImageLayer(static_cast<PAGImageLayer*>(pagLayer));
+        prepareImageLayer(static_cast<PAGImageLayer*>(pagLayer), item.first);
       }
     }
   }
@@ -185,28 +285,53 @@ void RenderCache::attachToContext(Context* current, bool forHitTest) {
   context = current;
   deviceID = context->getDevice()->uniqueID();
   hitTestOnly = forHitTest;
+  // The memory requested by other caches is released before this frame allocates anything new.
+  servePurgeRequest();
   if (hitTestOnly) {
     return;
   }
+  programCountersBase = context->programCounters();
+  resourceCountersBase = context->resourceCounters();
+  gradientCountersBase = context->gradientCounters();
+  pathMaskCountersBase = context->pathMaskCounters();
+  glyphCountersBase = context->glyphCounters();
+  drawCallCountBase = context->drawCallCount();
+  mergedDrawCountBase = context->mergedDrawCount();
+  for (auto& pendingMask : pendingPathMasks) {
+    context->addPendingPathMask(pendingMask);
+  }
+  pendingPathMasks.clear();
   auto removedAssets = stage->getRemovedAssets();
   for (auto assetID : removedAssets) {
     removeSnapshot(assetID);
     imageTasks.erase(assetID);
+    prefetchScheduler.removeAsset(assetID);
     clearSequenceCache(assetID);
     clearFilterCache(assetID);
   }
+  for (auto assetID : prewarmedFilters) {
+    if (!stage->hasReference(assetID)) {
+      clearFilterCache(assetID);
+    }
+  }
+  prewarmedFilters.clear();
+  updateFilterMemory();
 }
 
 void RenderCache::releaseAll() {
   clearAllSnapshots();
-  graphicsMemory = 0;
   clearAllSequenceCaches();
   for (auto& item : filterCaches) {
     delete item.second;
   }
   filterCaches.clear();
+  prewarmedFilters.clear();
   delete motionBlurFilter;
   motionBlurFilter = nullptr;
+  updateFilterMemory();
+  GraphicsMemoryManager::DetachDevice(this);
+  preparedPathMasks.clear();
+  lastPreparedPathMasks.clear();
   deviceID = 0;
 }
 
@@ -218,9 +343,24 @@ void RenderCache::detachFromContext() {
   clearExpiredSequences();
   clearExpiredBitmaps();
   clearExpiredSnapshots();
+  context->clearPendingPathMasks();
+  lastPreparedPathMasks = std::move(preparedPathMasks);
+  preparedPathMasks = {};
+  updateFilterMemory();
   auto currentTimestamp = GetTimer();
   context->purgeResourcesNotUsedIn(currentTimestamp - lastTimestamp);
   lastTimestamp = currentTimestamp;
+  updateRecycledMemory();
+  servePurgeRequest();
+  AddCounters(&cacheStats.programs, context->programCounters(), programCountersBase);
+  AddCounters(&cacheStats.recycledResources, context->resourceCounters(), resourceCountersBase);
+  AddCounters(&cacheStats.gradients, context->gradientCounters(), gradientCountersBase);
+  AddCounters(&cacheStats.pathMasks, context->pathMaskCounters(), pathMaskCountersBase);
+  AddCounters(&cacheStats.glyphs, context->glyphCounters(), glyphCountersBase);
+  AddCounters(&cacheStats.contents, FrameCacheMemory::ThreadCounters(), contentCountersBase);
+  contentCountersBase = FrameCacheMemory::ThreadCounters();
+  drawCallCount += static_cast<int>(context->drawCallCount() - drawCallCountBase);
+  mergedDrawCount += static_cast<int>(context->mergedDrawCount() - mergedDrawCountBase);
   context = nullptr;
 }
 
@@ -239,16 +379,40 @@ Snapshot* RenderCache::getSnapshot(const Picture* image) {
   if (!_snapshotEnabled) {
     return nullptr;
   }
-  usedAssets.insert(image->assetID);
+  auto firstUse = usedAssets.insert(image->assetID).second;
   auto maxScaleFactor = stage->getAssetMaxScale(image->assetID);
   auto scaleFactor = image->getScaleFactor(maxScaleFactor);
+  if (scaleFactor < MIN_SCALE_FACTOR) {
+    return nullptr;
+  }
+  auto scaleBucket = ScaleFactorToBucket(scaleFactor);
   auto snapshot = getSnapshot(image->assetID);
-  if (snapshot && (snapshot->makerKey != image->uniqueKey ||
-                   fabsf(snapshot->scaleFactor() - scaleFactor) > SCALE_FACTOR_PRECISION)) {
+  if (snapshot && snapshot->makerKey != image->uniqueKey) {
     removeSnapshot(image->assetID);
     snapshot = nullptr;
   }
+  bool rescaling = false;
+  if (snapshot && !ScaleBucketMatches(snapshot->scaleBucket, scaleBucket)) {
+    // The snapshot of the previous bucket is kept alive for a while, the scale animations usually
+    // go back and forth between two adjacent buckets.
+    snapshot = switchSnapshotBucket(image->assetID, scaleBucket);
+    rescaling = snapshot == nullptr;
+  }
+  if (snapshot && snapshot->scaleBucket != scaleBucket) {
+    if (firstUse) {
+      snapshot->downscaledFrames++;
+    }
+    if (snapshot->downscaledFrames >= PURGEABLE_EXPIRED_FRAME) {
+      // Switches to the requested bucket, the larger snapshot is kept as the transition one and
+      // released once it stays idle.
+      snapshot = switchSnapshotBucket(image->assetID, scaleBucket);
+      rescaling = snapshot == nullptr;
+    }
+  } else if (snapshot) {
+    snapshot->downscaledFrames = 0;
+  }
   if (snapshot) {
+    cacheStats.snapshots.hits++;
     snapshot->idleFrames = 0;
     auto position = std::find(snapshotLRU.begin(), snapshotLRU.end(), snapshot);
     if (position != snapshotLRU.end()) {
@@ -257,23 +421,88 @@ Snapshot* RenderCache::getSnapshot(const Picture* image) {
     snapshotLRU.push_front(snapshot);
     return snapshot;
   }
-  if (scaleFactor < SCALE_FACTOR_PRECISION || graphicsMemory >= MAX_GRAPHICS_MEMORY) {
+  cacheStats.snapshots.misses++;
+  // The idle players may not release their caches in time, make room from the snapshots of this
+  // cache that are not used by the current frame first.
+  while (GraphicsMemoryManager::BudgetExceeded() && !snapshotLRU.empty() &&
+         usedAssets.count(snapshotLRU.back()->assetID) == 0) {
+    removeSnapshot(snapshotLRU.back()->assetID);
+  }
+  if (GraphicsMemoryManager::BudgetExceeded()) {
     return nullptr;
   }
-  auto newSnapshot = image->makeSnapshot(this, scaleFactor);
+  auto newSnapshot = makeSnapshot(image, scaleBucket);
   if (newSnapshot == nullptr) {
     return nullptr;
   }
+  if (rescaling) {
+    snapshotRescalingCount++;
+  }
   snapshot = newSnapshot.release();
   snapshot->assetID = image->assetID;
   snapshot->makerKey = image->uniqueKey;
-  graphicsMemory += snapshot->memoryUsage();
+  snapshot->scaleBucket = scaleBucket;
+  cacheStats.snapshots.allocatedBytes += static_cast<int64_t>(snapshot->memoryUsage());
+  if (!snapshot->shared) {
+    addGraphicsMemory(snapshot->memoryUsage());
+  }
   snapshotLRU.push_front(snapshot);
   snapshotCaches[image->assetID] = snapshot;
   return snapshot;
 }
 
+Snapshot* RenderCache::switchSnapshotBucket(ID assetID, int scaleBucket) {
+  auto current = snapshotCaches[assetID];
+  auto position = std::find(snapshotLRU.begin(), snapshotLRU.end(), current);
+  if (position != snapshotLRU.end()) {
+    snapshotLRU.erase(position);
+  }
+  snapshotCaches.erase(assetID);
+  Snapshot* previous = nullptr;
+  auto result = transitionSnapshots.find(assetID);
+  if (result != transitionSnapshots.end()) {
+    previous = result->second;
+    transitionSnapshots.erase(result);
+  }
+  if (previous != nullptr && !ScaleBucketMatches(previous->scaleBucket, scaleBucket)) {
+    freeSnapshot(previous);
+    previous = nullptr;
+  }
+  current->idleFrames = 0;
+  current->downscaledFrames = 0;
+  transitionSnapshots[assetID] = current;
+  if (previous != nullptr) {
+    snapshotLRU.push_front(previous);
+    snapshotCaches[assetID] = previous;
+  }
+  return previous;
+}
+
+std::unique_ptr<Snapshot> RenderCache::makeSnapshot(const Picture* image, int scaleBucket) {
+  auto scaleFactor = BucketToScaleFactor(scaleBucket);
+  if (!_sharedSnapshotEnabled) {
+    return image->makeSnapshot(this, scaleFactor);
+  }
+  auto snapshot =
+      SharedSnapshotCache::Find(deviceID, image->assetID, image->uniqueKey, scaleBucket);
+  if (snapshot != nullptr) {
+    snapshot->shared = true;
+    return snapshot;
+  }
+  snapshot = image->makeSnapshot(this, scaleFactor);
+  if (snapshot != nullptr) {
+    snapshot->shared = SharedSnapshotCache::Add(deviceID, image->assetID, image->uniqueKey,
+                                                scaleBucket, snapshot.get());
+  }
+  return snapshot;
+}
+
 void RenderCache::removeSnapshot(ID assetID) {
+  auto transition = transitionSnapshots.find(assetID);
+  if (transition != transitionSnapshots.end()) {
+    freeSnapshot(transition->second);
+    transitionSnapshots.erase(transition);
+  }
   auto snapshot = snapshotCaches.find(assetID);
   if (snapshot == snapshotCaches.end()) {
     return;
@@ -282,21 +511,52 @@ void RenderCache::removeSnapshot(ID assetID) {
   if (position != snapshotLRU.end()) {
     snapshotLRU.erase(position);
   }
-  graphicsMemory -= snapshot->second->memoryUsage();
-  delete snapshot->second;
+  freeSnapshot(snapshot->second);
   snapshotCaches.erase(assetID);
 }
 
+void RenderCache::freeSnapshot(Snapshot* snapshot) {
+  cacheStats.snapshots.evictions++;
+  cacheStats.snapshots.evictedBytes += static_cast<int64_t>(snapshot->memoryUsage());
+  if (snapshot->shared) {
+    // The memory of a shared texture is charged by the SharedSnapshotCache.
+    SharedSnapshotCache::Release(deviceID, snapshot->assetID, snapshot->makerKey,
+                                 snapshot->scaleBucket);
+  } else {
+    removeGraphicsMemory(snapshot->memoryUsage());
+  }
+  delete snapshot;
+}
+
 void RenderCache::clearAllSnapshots() {
   for (auto& item : snapshotCaches) {
-    graphicsMemory -= item.second->memoryUsage();
-    delete item.second;
+    freeSnapshot(item.second);
   }
   snapshotCaches.clear();
   snapshotLRU.clear();
+  clearTransitionSnapshots();
+}
+
+void RenderCache::clearTransitionSnapshots() {
+  for (auto& item : transitionSnapshots) {
+    freeSnapshot(item.second);
+  }
+  transitionSnapshots.clear();
 }
 
 void RenderCache::clearExpiredSnapshots() {
+  std::vector<ID> expiredSnapshots = {};
+  for (auto& item : transitionSnapshots) {
+    item.second->idleFrames++;
+    if (item.second->idleFrames >= PURGEABLE_EXPIRED_FRAME ||
+        graphicsMemory >= PURGEABLE_GRAPHICS_MEMORY) {
+      expiredSnapshots.push_back(item.first);
+    }
+  }
+  for (auto& assetID : expiredSnapshots) {
+    freeSnapshot(transitionSnapshots[assetID]);
+    transitionSnapshots.erase(assetID);
+  }
   while (!snapshotLRU.empty()) {
     auto snapshot = snapshotLRU.back();
     // 只有 Snapshot 数量可能会比较多，使用 LRU
@@ -314,6 +574,96 @@ void RenderCache::clearExpiredSnapshots() {
   }
 }
 
+void RenderCache::addGraphicsMemory(size_t bytes) {
+  if (bytes == 0) {
+    return;
+  }
+  graphicsMemory += bytes;
+  GraphicsMemoryManager::AddMemory(this, bytes);
+}
+
+void RenderCache::removeGraphicsMemory(size_t bytes) {
+  bytes = std::min(bytes, graphicsMemory);
+  if (bytes == 0) {
+    return;
+  }
+  graphicsMemory -= bytes;
+  GraphicsMemoryManager::RemoveMemory(this, bytes);
+}
+
+void RenderCache::updateFilterMemory() {
+  // The intermediate buffers of the filters are resized while drawing, the total is re-evaluated
+  // instead of being tracked for each filter.
+  size_t currentMemory = motionBlurFilter ? motionBlurFilter->memoryUsage() : 0;
+  for (auto& item : filterCaches) {
+    currentMemory += item.second->memoryUsage();
+  }
+  if (currentMemory > filterMemory) {
+    addGraphicsMemory(currentMemory - filterMemory);
+  } else {
+    removeGraphicsMemory(filterMemory - currentMemory);
+  }
+  filterMemory = currentMemory;
+}
+
+void RenderCache::updateRecycledMemory() {
+  GraphicsMemoryManager::SetRecycledMemory(this, deviceID, context->recycledResourceMemory());
+}
+
+void RenderCache::servePurgeRequest() {
+  auto purgeRequest = GraphicsMemoryManager::TakePurgeRequest(this);
+  if (purgeRequest > 0) {
+    purgeGraphicsMemory(purgeRequest);
+  }
+}
+
+void RenderCache::purgeGraphicsMemory(size_t bytes) {
+  auto targetMemory = graphicsMemory > bytes ? graphicsMemory - bytes : 0;
+  // The recycled resources of the context are released first, they are not used by anyone. Then
+  // the snapshots kept for scale transitions, then the other snapshots from the least recently used
+  // ones, then the sequence readers and filters that are not used by the last frame. The snapshots
+  // used by the last frame are the last resort, they will be created again by the next frame.
+  context->purgeResourcesNotUsedIn(0);
+  updateRecycledMemory();
+  if (graphicsMemory <= targetMemory) {
+    return;
+  }
+  clearTransitionSnapshots();
+  std::vector<ID> usedSnapshots = {};
+  for (auto snapshot = snapshotLRU.rbegin(); snapshot != snapshotLRU.rend(); snapshot++) {
+    if (usedAssets.count((*snapshot)->assetID) > 0) {
+      usedSnapshots.push_back((*snapshot)->assetID);
+    }
+  }
+  while (!snapshotLRU.empty() && graphicsMemory > targetMemory) {
+    auto snapshot = snapshotLRU.back();
+    if (usedAssets.count(snapshot->assetID) > 0) {
+      break;
+    }
+    removeSnapshot(snapshot->assetID);
+  }
+  if (graphicsMemory <= targetMemory) {
+    return;
+  }
+  clearExpiredSequences();
+  std::vector<ID> expiredFilters = {};
+  for (auto& item : filterCaches) {
+    if (usedAssets.count(item.first) == 0) {
+      expiredFilters.push_back(item.first);
+    }
+  }
+  for (auto& filterID : expiredFilters) {
+    clearFilterCache(filterID);
+  }
+  updateFilterMemory();
+  for (auto& assetID : usedSnapshots) {
+    if (graphicsMemory <= targetMemory) {
+      break;
+    }
+    removeSnapshot(assetID);
+  }
+}
+
 void RenderCache::prepareImage(ID assetID, std::shared_ptr<Image> image) {
   usedAssets.insert(assetID);
   if (imageTasks.count(assetID) != 0 || snapshotCaches.count(assetID) != 0) {
@@ -331,10 +681,16 @@ std::shared_ptr<TextureBuffer> RenderCache::getImageBuffer(ID assetID) {
   if (result != imageTasks.end()) {
     auto executor = result->second->wait();
     auto buffer = static_cast<ImageTask*>(executor)->getBuffer();
+    // The decoding has been done on the task pool, only its own cost is learned.
+    prefetchScheduler.recordCost(assetID, static_cast<ImageTask*>(executor)->getDecodingTime());
+    prefetchScheduler.markPrefetched(assetID);
+    prefetchScheduler.finishPrefetch(assetID);
     // 预测生成的 Bitmap 取了一次就应该销毁，上层会进行缓存。
     imageTasks.erase(result);
+    cacheStats.images.hits++;
     return buffer;
   }
+  cacheStats.images.misses++;
   return {};
 }
 
@@ -347,12 +703,16 @@ void RenderCache::clearExpiredBitmaps() {
   }
   for (auto& bitmapID : expiredBitmaps) {
     imageTasks.erase(bitmapID);
+    prefetchScheduler.finishPrefetch(bitmapID);
   }
+  cacheStats.images.evictions += static_cast<int64_t>(expiredBitmaps.size());
 }
 
 static std::shared_ptr<SequenceReader> MakeSequenceReader(std::shared_ptr<File> file,
                                                           Sequence* sequence,
                                                           DecodingPolicy policy) {
+  // The frames of a lazily decoded file are materialized the first time a reader needs them.
+  sequence->decodeFrames();
   std::shared_ptr<SequenceReader> reader = nullptr;
   if (sequence->composition->type() == CompositionType::Video) {
     if (sequence->composition->staticContent()) {
@@ -389,7 +749,7 @@ bool RenderCache::prepareSequenceReader(Sequence* sequence, Frame targetFrame,
   }
   auto file = stage->getSequenceFile(sequence);
   auto reader = MakeSequenceReader(file, sequence, policy);
-  sequenceCaches[composition->uniqueID] = reader;
+  addSequenceCache(composition->uniqueID, reader);
   reader->prepareAsync(targetFrame);
   return true;
 }
@@ -404,6 +764,7 @@ std::shared_ptr<SequenceReader> RenderCache::getSequenceReader(Sequence* sequenc
   }
   auto compositionID = composition->uniqueID;
   usedAssets.insert(compositionID);
+  prefetchScheduler.finishPrefetch(compositionID);
   auto staticComposition = sequence->composition->staticContent();
   std::shared_ptr<SequenceReader> reader = nullptr;
   auto result = sequenceCaches.find(compositionID);
@@ -414,33 +775,56 @@ std::shared_ptr<SequenceReader> RenderCache::getSequenceReader(Sequence* sequenc
       reader = nullptr;
     } else if (staticComposition) {
       // 完全静态的序列帧是预测生成的，第一次访问时就可以移除，上层会进行缓存。
-      sequenceCaches.erase(result);
+      removeSequenceCache(compositionID);
     }
   }
-  if (reader == nullptr) {
+  if (reader != nullptr) {
+    cacheStats.sequenceReaders.hits++;
+    // The reader has been decoding ahead, reading from it does not tell how long it takes to start.
+    prefetchScheduler.markPrefetched(compositionID);
+  } else {
+    cacheStats.sequenceReaders.misses++;
     auto file = stage->getSequenceFile(sequence);
     reader = MakeSequenceReader(file, sequence, DecodingPolicy::SoftwareToHardware);
     if (reader && !staticComposition) {
       // 完全静态的序列帧不用缓存。
-      sequenceCaches[compositionID] = reader;
+      addSequenceCache(compositionID, reader);
     }
   }
   return reader;
 }
 
+void RenderCache::addSequenceCache(ID uniqueID, std::shared_ptr<SequenceReader> reader) {
+  removeSequenceCache(uniqueID);
+  addGraphicsMemory(SequenceMemory(reader->getSequence()));
+  sequenceCaches[uniqueID] = std::move(reader);
+}
+
+void RenderCache::removeSequenceCache(ID uniqueID) {
+  auto result = sequenceCaches.find(uniqueID);
+  if (result != sequenceCaches.end()) {
+    removeGraphicsMemory(SequenceMemory(result->second->getSequence()));
+    sequenceCaches.erase(result);
+  }
+}
+
 void RenderCache::clearAllSequenceCaches() {
   for (auto& item : sequenceCaches) {
     removeSnapshot(item.first);
+    prefetchScheduler.finishPrefetch(item.first);
+    removeGraphicsMemory(SequenceMemory(item.second->getSequence()));
   }
   sequenceCaches.clear();
 }
 
 void RenderCache::clearSequenceCache(ID uniqueID) {
-  auto result = sequenceCaches.find(uniqueID);
-  if (result != sequenceCaches.end()) {
-    removeSnapshot(result->first);
-    sequenceCaches.erase(result);
+  if (sequenceCaches.count(uniqueID) == 0) {
+    return;
   }
+  cacheStats.sequenceReaders.evictions++;
+  prefetchScheduler.finishPrefetch(uniqueID);
+  removeSnapshot(uniqueID);
+  removeSequenceCache(uniqueID);
 }
 
 //===================================== filter caches =====================================
@@ -458,9 +842,11 @@ LayerFilter* RenderCache::getFilterCache(Effect* effect) {
 
 LayerFilter* RenderCache::getLayerFilterCache(ID uniqueID,
                                               const std::function<LayerFilter*()>& makeFilter) {
+  usedAssets.insert(uniqueID);
   LayerFilter* filter = nullptr;
   auto result = filterCaches.find(uniqueID);
   if (result == filterCaches.end()) {
+    cacheStats.filters.misses++;
     filter = makeFilter();
     if (filter && !initFilter(filter)) {
       delete filter;
@@ -470,6 +856,7 @@ LayerFilter* RenderCache::getLayerFilterCache(ID uniqueID,
       filterCaches.insert(std::make_pair(uniqueID, filter));
     }
   } else {
+    cacheStats.filters.hits++;
     filter = static_cast<LayerFilter*>(result->second);
   }
   return filter;
@@ -487,9 +874,11 @@ MotionBlurFilter* RenderCache::getMotionBlurFilter() {
 }
 
 LayerStylesFilter* RenderCache::getLayerStylesFilter(Layer* layer) {
+  usedAssets.insert(layer->uniqueID);
   LayerStylesFilter* filter = nullptr;
   auto result = filterCaches.find(layer->uniqueID);
   if (result == filterCaches.end()) {
+    cacheStats.filters.misses++;
     filter = new LayerStylesFilter(this);
     if (initFilter(filter)) {
       filterCaches.insert(std::make_pair(layer->uniqueID, filter));
@@ -498,6 +887,7 @@ LayerStylesFilter* RenderCache::getLayerStylesFilter(Layer* layer) {
       filter = nullptr;
     }
   } else {
+    cacheStats.filters.hits++;
     filter = static_cast<LayerStylesFilter*>(result->second);
   }
   return filter;
@@ -506,11 +896,102 @@ LayerStylesFilter* RenderCache::getLayerStylesFilter(Layer* layer) {
 void RenderCache::clearFilterCache(ID uniqueID) {
   auto result = filterCaches.find(uniqueID);
   if (result != filterCaches.end()) {
+    cacheStats.filters.evictions++;
     delete result->second;
     filterCaches.erase(result);
   }
 }
 
+//===================================== prewarm =====================================
+
+void RenderCache::prewarm(PAGLayer* pagLayer) {
+  prewarmLayer(pagLayer->layer);
+  if (pagLayer->_trackMatteLayer != nullptr) {
+    prewarm(pagLayer->_trackMatteLayer.get());
+  }
+  if (pagLayer->layerType() == LayerType::PreCompose) {
+    for (auto& childLayer : static_cast<PAGComposition*>(pagLayer)->layers) {
+      prewarm(childLayer.get());
+    }
+  }
+}
+
+static void CollectGradientColors(const std::vector<ShapeElement*>& elements,
+                                  std::vector<Property<GradientColorHandle>*>* gradientColors) {
+  for (auto& element : elements) {
+    switch (element->type()) {
+      case ShapeType::ShapeGroup:
+        CollectGradientColors(static_cast<ShapeGroupElement*>(element)->elements, gradientColors);
+        break;
+      case ShapeType::GradientFill:
+        gradientColors->push_back(static_cast<GradientFillElement*>(element)->colors);
+        break;
+      case ShapeType::GradientStroke:
+        gradientColors->push_back(static_cast<GradientStrokeElement*>(element)->colors);
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+void RenderCache::prewarmLayer(Layer* layer) {
+  // Builds the same filters as FilterRenderer::DrawWithFilter() does, regardless of whether they
+  // are visible at the current frame.
+  for (auto& effect : layer->effects) {
+    getFilterCache(effect);
+    prewarmedFilters.insert(effect->uniqueID);
+  }
+  if (layer->motionBlur) {
+    getMotionBlurFilter();
+  }
+  if (!layer->layerStyles.empty()) {
+    getLayerStylesFilter(layer);
+    prewarmedFilters.insert(layer->uniqueID);
+    for (auto& layerStyle : layer->layerStyles) {
+      getFilterCache(layerStyle);
+      prewarmedFilters.insert(layerStyle->uniqueID);
+    }
+  }
+  if (layer->type() == LayerType::Shape) {
+    std::vector<Property<GradientColorHandle>*> gradientColors = {};
+    CollectGradientColors(static_cast<ShapeLayer*>(layer)->contents, &gradientColors);
+    for (auto colors : gradientColors) {
+      prewarmGradient(colors);
+    }
+  }
+}
+
+void RenderCache::prewarmGradient(Property<GradientColorHandle>* colors) {
+  // The colors between two keyframes are interpolated every frame, so only the colors at the
+  // keyframes can be known in advance.
+  std::vector<GradientColorHandle> values = {};
+  if (colors->animatable()) {
+    auto property = static_cast<AnimatableProperty<GradientColorHandle>*>(colors);
+    for (auto& keyframe : property->keyframes) {
+      values.push_back(keyframe->startValue);
+      values.push_back(keyframe->endValue);
+    }
+  } else {
+    values.push_back(colors->getValueAt(0));
+  }
+  for (auto& value : values) {
+    if (value == nullptr || value->colorStops.empty() || value->alphaStops.empty()) {
+      continue;
+    }
+    // The gradient texture only depends on the colors and positions, any non-degenerate points can
+    // be used here.
+    auto gradient = MakeGradientPaint(GradientFillType::Linear, Point::Zero(), Point::Make(1, 0),
+                                      value, Matrix::I());
+    auto shader = GradientShader::MakeFrom(gradient);
+    shader->asFragmentProcessor(FPArgs(context, Matrix::I()));
+  }
+}
+
+void RenderCache::recordPrefetchCost(ID assetID, int64_t time) {
+  prefetchScheduler.recordCost(assetID, time);
+}
+
 void RenderCache::recordImageDecodingTime(int64_t decodingTime) {
   imageDecodingTime += decodingTime;
 }
@@ -21,9 +21,11 @@
 #include <memory>
 #include <unordered_set>
 #include "gpu/Device.h"
+#include "gpu/PathMaskCache.h"
 #include "pag/file.h"
 #include "pag/pag.h"
 #include "rendering/Performance.h"
+#include "rendering/caches/PrefetchScheduler.h"
 #include "rendering/filters/LayerFilter.h"
 #include "rendering/filters/LayerStylesFilter.h"
 #include "rendering/filters/MotionBlurFilter.h"
@@ -51,7 +53,10 @@ class RenderCache : public Performance {
   void detachFromContext();
 
   /**
-   * Returns the total memory usage of this cache.
+   * Returns the total graphics memory of this cache, including the snapshots, the sequence readers
+   * and the filters, which is also reported to the GraphicsMemoryManager. The recycled resources of
+   * the context are reported for each device instead, since the context may be shared. The shared
+   * snapshots are charged once by the SharedSnapshotCache.
    */
   size_t memoryUsage() const {
     return graphicsMemory;
@@ -74,6 +79,17 @@ class RenderCache : public Performance {
    */
   void setSnapshotEnabled(bool value);
 
+  /**
+   * If set to true, the snapshots of this cache are shared with other RenderCaches on the same
+   * device, which have also enabled this property. The default value is false.
+   */
+  bool sharedSnapshotEnabled() const;
+
+  /**
+   * Set the value of sharedSnapshotEnabled property.
+   */
+  void setSharedSnapshotEnabled(bool value);
+
   /**
    * Returns true if there is snapshot cache available for specified asset ID.
    */
@@ -110,6 +126,13 @@ class RenderCache : public Performance {
    */
   std::shared_ptr<TextureBuffer> getImageBuffer(ID assetID);
 
+  /**
+   * Starts rasterizing the mask of the path on the task pool, which is going to be drawn with the
+   * specified matrix. Does nothing if the path does not need a mask or the same mask has been
+   * prepared in the last frame, which is most likely cached by the context already.
+   */
+  void preparePathMask(const Path& path, const Matrix& matrix);
+
   uint32_t getContentVersion() const;
 
   bool videoEnabled() const;
@@ -128,6 +151,20 @@ class RenderCache : public Performance {
 
   LayerStylesFilter* getLayerStylesFilter(Layer* layer);
 
+  /**
+   * Builds the filter programs and the gradient textures that the layer and its children can use,
+   * so that they are not created while playing. The cache must be attached to a context. The
+   * filters are released on the next attachToContext() unless the layer is on the stage by then.
+   */
+  void prewarm(PAGLayer* pagLayer);
+
+  /**
+   * Records the time in microseconds spent on decoding or uploading the specified image or sequence
+   * on the render thread, which decides how early it starts prefetching next time. The samples of
+   * the assets served by a prefetch in the current frame are skipped.
+   */
+  void recordPrefetchCost(ID assetID, int64_t time);
+
   void recordImageDecodingTime(int64_t decodingTime);
 
   void recordTextureUploadingTime(int64_t time);
@@ -144,15 +181,33 @@ class RenderCache : public Performance {
   int64_t lastTimestamp = 0;
   bool hitTestOnly = false;
   size_t graphicsMemory = 0;
+  size_t filterMemory = 0;
   bool _videoEnabled = true;
   bool _snapshotEnabled = true;
+  bool _sharedSnapshotEnabled = false;
   std::unordered_set<ID> usedAssets = {};
   std::unordered_map<ID, Snapshot*> snapshotCaches = {};
   std::list<Snapshot*> snapshotLRU = {};
+  std::unordered_map<ID, Snapshot*> transitionSnapshots = {};
   std::unordered_map<ID, std::shared_ptr<Task>> imageTasks;
   std::unordered_map<ID, std::shared_ptr<SequenceReader>> sequenceCaches;
   std::unordered_map<ID, Filter*> filterCaches;
+  // The filters built by prewarm(), which are released on the next attachToContext() if the stage
+  // does not reference them by then.
+  std::unordered_set<ID> prewarmedFilters = {};
   MotionBlurFilter* motionBlurFilter = nullptr;
+  std::vector<std::shared_ptr<PendingPathMask>> pendingPathMasks = {};
+  std::unordered_set<BytesKey, BytesHasher> preparedPathMasks = {};
+  std::unordered_set<BytesKey, BytesHasher> lastPreparedPathMasks = {};
+  PrefetchScheduler prefetchScheduler = {};
+  CacheCounters programCountersBase = {};
+  CacheCounters resourceCountersBase = {};
+  CacheCounters gradientCountersBase = {};
+  CacheCounters pathMaskCountersBase = {};
+  CacheCounters glyphCountersBase = {};
+  CacheCounters contentCountersBase = {};
+  int64_t drawCallCountBase = 0;
+  int64_t mergedDrawCountBase = 0;
 
   // bitmap caches:
   void clearExpiredBitmaps();
@@ -160,8 +215,22 @@ class RenderCache : public Performance {
   // snapshot caches:
   void clearAllSnapshots();
   void clearExpiredSnapshots();
+  void clearTransitionSnapshots();
+  void freeSnapshot(Snapshot* snapshot);
+  Snapshot* switchSnapshotBucket(ID assetID, int scaleBucket);
+  std::unique_ptr<Snapshot> makeSnapshot(const Picture* image, int scaleBucket);
+
+  // graphics memory:
+  void addGraphicsMemory(size_t bytes);
+  void removeGraphicsMemory(size_t bytes);
+  void updateFilterMemory();
+  void updateRecycledMemory();
+  void servePurgeRequest();
+  void purgeGraphicsMemory(size_t bytes);
 
   // sequence caches:
+  void addSequenceCache(ID uniqueID, std::shared_ptr<SequenceReader> reader);
+  void removeSequenceCache(ID uniqueID);
   void clearAllSequenceCaches();
   void clearSequenceCache(ID uniqueID);
   void clearExpiredSequences();
@@ -171,7 +240,9 @@ class RenderCache : public Performance {
   void clearFilterCache(ID uniqueID);
   bool initFilter(Filter* filter);
 
-  void preparePreComposeLayer(PreComposeLayer* layer, DecodingPolicy policy);
-  void prepareImageLayer(PAGImageLayer* layer);
+  void prewarmLayer(Layer* layer);
+  void prewarmGradient(Property<GradientColorHandle>* colors);
+  void preparePreComposeLayer(PreComposeLayer* layer, int64_t distance);
+  void prepareImageLayer(PAGImageLayer* layer, int64_t distance);
 };
 }  // namespace pag
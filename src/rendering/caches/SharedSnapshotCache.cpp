@@ -0,0 +1,101 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "SharedSnapshotCache.h"
+#include <mutex>
+#include <unordered_map>
+#include "rendering/caches/GraphicsMemoryManager.h"
+
+namespace pag {
+struct SnapshotKey {
+  uint32_t deviceID;
+  ID assetID;
+  uint64_t makerKey;
+  int scaleBucket;
+
+  bool operator==(const SnapshotKey& other) const {
+    return deviceID == other.deviceID && assetID == other.assetID && makerKey == other.makerKey &&
+           scaleBucket == other.scaleBucket;
+  }
+};
+
+struct SnapshotKeyHasher {
+  size_t operator()(const SnapshotKey& key) const {
+    size_t hash = 0;
+    uint64_t values[] = {key.deviceID, key.assetID, key.makerKey,
+                         static_cast<uint64_t>(key.scaleBucket)};
+    for (auto value : values) {
+      hash ^= std::hash<uint64_t>()(value) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    }
+    return hash;
+  }
+};
+
+struct SharedSnapshot {
+  std::weak_ptr<Texture> texture;
+  Matrix matrix;
+  size_t memoryUsage;
+  int references;
+};
+
+static std::mutex locker = {};
+static std::unordered_map<SnapshotKey, SharedSnapshot, SnapshotKeyHasher> snapshotMap = {};
+
+std::unique_ptr<Snapshot> SharedSnapshotCache::Find(uint32_t deviceID, ID assetID,
+                                                    uint64_t makerKey, int scaleBucket) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  auto result = snapshotMap.find({deviceID, assetID, makerKey, scaleBucket});
+  if (result == snapshotMap.end()) {
+    return nullptr;
+  }
+  // The texture is kept alive by the snapshots of the caches that reference it.
+  auto texture = result->second.texture.lock();
+  if (texture == nullptr) {
+    return nullptr;
+  }
+  result->second.references++;
+  return std::make_unique<Snapshot>(std::move(texture), result->second.matrix);
+}
+
+bool SharedSnapshotCache::Add(uint32_t deviceID, ID assetID, uint64_t makerKey, int scaleBucket,
+                              const Snapshot* snapshot) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  SnapshotKey key = {deviceID, assetID, makerKey, scaleBucket};
+  if (snapshotMap.count(key) > 0) {
+    return false;
+  }
+  auto memoryUsage = snapshot->memoryUsage();
+  snapshotMap[key] = {snapshot->texture, snapshot->matrix, memoryUsage, 1};
+  GraphicsMemoryManager::AddSharedMemory(memoryUsage);
+  return true;
+}
+
+void SharedSnapshotCache::Release(uint32_t deviceID, ID assetID, uint64_t makerKey,
+                                  int scaleBucket) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  auto result = snapshotMap.find({deviceID, assetID, makerKey, scaleBucket});
+  if (result == snapshotMap.end()) {
+    return;
+  }
+  if (--result->second.references > 0) {
+    return;
+  }
+  GraphicsMemoryManager::RemoveSharedMemory(result->second.memoryUsage);
+  snapshotMap.erase(result);
+}
+}  // namespace pag
@@ -0,0 +1,57 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <memory>
+#include "rendering/graphics/Snapshot.h"
+
+namespace pag {
+/**
+ * A process-wide registry of the snapshot textures created by the RenderCaches that enable
+ * snapshot sharing. It only keeps weak references and counts the RenderCaches using each texture,
+ * the texture is released once the last of them calls Release(). The memory of a shared texture is
+ * charged to the GraphicsMemoryManager once, instead of to every RenderCache using it. Snapshots
+ * are matched by the device they live on, the asset ID, the maker key of the Picture, and the
+ * scale bucket. All methods are thread safe.
+ */
+class SharedSnapshotCache {
+ public:
+  /**
+   * Returns a new Snapshot that shares the texture of a matching snapshot, or nullptr if there is
+   * no matching snapshot alive. The caller must call Release() once the returned snapshot is freed.
+   */
+  static std::unique_ptr<Snapshot> Find(uint32_t deviceID, ID assetID, uint64_t makerKey,
+                                        int scaleBucket);
+
+  /**
+   * Makes the texture of the specified snapshot available to other RenderCaches and charges its
+   * memory. Returns false if another texture has been added with the same key, in which case the
+   * snapshot is not shared and stays charged to the RenderCache that created it. The caller must
+   * call Release() once the snapshot is freed if true is returned.
+   */
+  static bool Add(uint32_t deviceID, ID assetID, uint64_t makerKey, int scaleBucket,
+                  const Snapshot* snapshot);
+
+  /**
+   * Drops a reference to the matching texture, which is no longer shared once no RenderCache
+   * references it.
+   */
+  static void Release(uint32_t deviceID, ID assetID, uint64_t makerKey, int scaleBucket);
+};
+}  // namespace pag
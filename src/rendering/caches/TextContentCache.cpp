@@ -64,4 +64,10 @@ GraphicContent* TextContentCache::createContent(Frame layerFrame) const {
   return content;
 }
 
+size_t TextContentCache::memoryUsage(const Content* content) const {
+  auto colorGlyphs = static_cast<const TextContent*>(content)->colorGlyphs;
+  return ContentCache::memoryUsage(content) + sizeof(TextContent) - sizeof(GraphicContent) +
+         (colorGlyphs ? colorGlyphs->memoryUsage() : 0);
+}
+
 }  // namespace pag
\ No newline at end of file
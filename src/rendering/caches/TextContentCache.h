@@ -30,6 +30,7 @@ class TextContentCache : public ContentCache {
   void excludeVaryingRanges(std::vector<TimeRange>* timeRanges) const override;
   ID getCacheID() const override;
   GraphicContent* createContent(Frame layerFrame) const override;
+  size_t memoryUsage(const Content* content) const override;
 
  private:
   ID cacheID = 0;
@@ -26,6 +26,10 @@ class TextReplacement {
   explicit TextReplacement(PAGTextLayer* textLayer);
   ~TextReplacement();
 
+  /**
+   * Returns the content of the replaced text at the specified frame. Like FrameCache::getCache(),
+   * the returned content is only kept alive until the current FrameCachePass ends.
+   */
   Content* getContent(Frame contentFrame);
 
   TextDocument* getTextDocument();
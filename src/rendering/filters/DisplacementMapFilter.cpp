@@ -118,6 +118,14 @@ void DisplacementMapFilter::updateMapTexture(RenderCache* cache, const Graphic*
   mapGraphic->draw(mapSurface->getCanvas(), cache);
 }
 
+size_t DisplacementMapFilter::memoryUsage() const {
+  if (mapSurface == nullptr) {
+    return 0;
+  }
+  auto texture = mapSurface->getTexture();
+  return texture ? texture->memoryUsage() : 0;
+}
+
 void DisplacementMapFilter::onUpdateParams(const GLInterface* gl, const Rect& contentBounds,
                                            const Point&) {
   auto* pagEffect = reinterpret_cast<const DisplacementMapEffect*>(effect);
@@ -30,6 +30,8 @@ class DisplacementMapFilter : public LayerFilter {
 
   void updateMapTexture(RenderCache* cache, const Graphic* mapGraphic, const Rect& bounds);
 
+  size_t memoryUsage() const override;
+
  protected:
   std::string onBuildFragmentShader() override;
 
@@ -94,5 +94,13 @@ class Filter {
   virtual bool needsMSAA() const {
     return false;
   }
+
+  /**
+   * Returns the graphics memory held by this filter between draws, such as the intermediate
+   * buffers. The programs are not included.
+   */
+  virtual size_t memoryUsage() const {
+    return 0;
+  }
 };
 }  // namespace pag
@@ -49,7 +49,7 @@ class FilterModifier : public Modifier {
     return true;
   }
 
-  void prepare(RenderCache*) const override {
+  void prepare(RenderCache*, const Matrix&) const override {
   }
 
   void applyToBounds(Rect* bounds) const override;
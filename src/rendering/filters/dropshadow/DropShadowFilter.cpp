@@ -36,6 +36,17 @@ DropShadowFilter::~DropShadowFilter() {
   delete spreadThickFilter;
 }
 
+size_t DropShadowFilter::memoryUsage() const {
+  size_t bytes = 0;
+  if (spreadFilterBuffer) {
+    bytes += spreadFilterBuffer->memoryUsage();
+  }
+  if (blurFilterBuffer) {
+    bytes += blurFilterBuffer->memoryUsage();
+  }
+  return bytes;
+}
+
 bool DropShadowFilter::initialize(Context* context) {
   if (!blurFilterV->initialize(context)) {
     return false;
@@ -34,6 +34,8 @@ class DropShadowFilter : public LayerFilter {
   void update(Frame frame, const Rect& contentBounds, const Rect& transformedBounds,
               const Point& filterScale) override;
 
+  size_t memoryUsage() const override;
+
   void draw(Context* context, const FilterSource* source, const FilterTarget* target) override;
 
  private:
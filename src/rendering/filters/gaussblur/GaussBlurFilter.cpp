@@ -31,6 +31,10 @@ GaussBlurFilter::~GaussBlurFilter() {
   delete blurFilterH;
 }
 
+size_t GaussBlurFilter::memoryUsage() const {
+  return blurFilterBuffer ? blurFilterBuffer->memoryUsage() : 0;
+}
+
 bool GaussBlurFilter::initialize(Context* context) {
   if (!blurFilterV->initialize(context)) {
     return false;
@@ -35,6 +35,8 @@ class GaussBlurFilter : public LayerFilter {
   void update(Frame frame, const Rect& contentBounds, const Rect& transformedBounds,
               const Point& filterScale) override;
 
+  size_t memoryUsage() const override;
+
  private:
   Effect* effect = nullptr;
 
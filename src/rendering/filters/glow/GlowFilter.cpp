@@ -33,6 +33,17 @@ GlowFilter::~GlowFilter() {
   delete targetFilter;
 }
 
+size_t GlowFilter::memoryUsage() const {
+  size_t bytes = 0;
+  if (blurFilterBufferH) {
+    bytes += blurFilterBufferH->memoryUsage();
+  }
+  if (blurFilterBufferV) {
+    bytes += blurFilterBufferV->memoryUsage();
+  }
+  return bytes;
+}
+
 bool GlowFilter::initialize(Context* context) {
   if (!blurFilterH->initialize(context)) {
     return false;
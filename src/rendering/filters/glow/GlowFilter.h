@@ -36,6 +36,8 @@ class GlowFilter : public LayerFilter {
   void update(Frame frame, const Rect& contentBounds, const Rect& transformedBounds,
               const Point& filterScale) override;
 
+  size_t memoryUsage() const override;
+
  private:
   Effect* effect = nullptr;
 
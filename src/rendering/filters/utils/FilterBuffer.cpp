@@ -35,6 +35,15 @@ std::shared_ptr<FilterBuffer> FilterBuffer::Make(Context* context, int width, in
   return std::shared_ptr<FilterBuffer>(buffer);
 }
 
+size_t FilterBuffer::memoryUsage() const {
+  auto colorBytes = texture->memoryUsage();
+  if (!renderTarget->usesMSAA()) {
+    return colorBytes;
+  }
+  // The multisampled render buffer holds a color for each sample.
+  return colorBytes + colorBytes * static_cast<size_t>(renderTarget->sampleCount());
+}
+
 void FilterBuffer::resolve(Context* context) {
   renderTarget->resolve(context);
 }
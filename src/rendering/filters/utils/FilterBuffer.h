@@ -57,6 +57,11 @@ class FilterBuffer {
 
   void resolve(Context* context);
 
+  /**
+   * Returns the graphics memory held by the texture and the render target of this buffer.
+   */
+  size_t memoryUsage() const;
+
  private:
   std::shared_ptr<GLRenderTarget> renderTarget = nullptr;
   std::shared_ptr<GLTexture> texture = nullptr;
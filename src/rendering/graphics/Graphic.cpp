@@ -46,8 +46,9 @@ class MatrixGraphic : public ComposeGraphic {
   void measureBounds(Rect* bounds) const override;
   bool hitTest(RenderCache* cache, float x, float y) override;
   bool getPath(Path* path) const override;
-  void prepare(RenderCache* cache) const override;
+  void prepare(RenderCache* cache, const Matrix& matrix) const override;
   void draw(Canvas* canvas, RenderCache* cache) const override;
+  size_t memoryUsage() const override;
   std::shared_ptr<Graphic> mergeWith(const Matrix& matrix) const override;
 
  protected:
@@ -95,8 +96,10 @@ bool MatrixGraphic::getPath(Path* path) const {
   return true;
 }
 
-void MatrixGraphic::prepare(RenderCache* cache) const {
-  graphic->prepare(cache);
+void MatrixGraphic::prepare(RenderCache* cache, const Matrix& parentMatrix) const {
+  auto totalMatrix = parentMatrix;
+  totalMatrix.preConcat(matrix);
+  graphic->prepare(cache, totalMatrix);
 }
 
 void MatrixGraphic::draw(Canvas* canvas, RenderCache* cache) const {
@@ -106,6 +109,10 @@ void MatrixGraphic::draw(Canvas* canvas, RenderCache* cache) const {
   canvas->restore();
 }
 
+size_t MatrixGraphic::memoryUsage() const {
+  return sizeof(MatrixGraphic) + graphic->memoryUsage();
+}
+
 std::shared_ptr<Graphic> MatrixGraphic::mergeWith(const Matrix& m) const {
   auto totalMatrix = matrix;
   totalMatrix.postConcat(m);
@@ -126,8 +133,9 @@ class LayerGraphic : public ComposeGraphic {
   void measureBounds(Rect* bounds) const override;
   bool hitTest(RenderCache* cache, float x, float y) override;
   bool getPath(Path* path) const override;
-  void prepare(RenderCache* cache) const override;
+  void prepare(RenderCache* cache, const Matrix& matrix) const override;
   void draw(Canvas* canvas, RenderCache* cache) const override;
+  size_t memoryUsage() const override;
   std::shared_ptr<Graphic> mergeWith(const Matrix& matrix) const override;
 
  private:
@@ -179,9 +187,9 @@ bool LayerGraphic::getPath(Path* path) const {
   return true;
 }
 
-void LayerGraphic::prepare(RenderCache* cache) const {
+void LayerGraphic::prepare(RenderCache* cache, const Matrix& matrix) const {
   for (auto& content : contents) {
-    content->prepare(cache);
+    content->prepare(cache, matrix);
   }
 }
 
@@ -193,6 +201,14 @@ void LayerGraphic::draw(Canvas* canvas, RenderCache* cache) const {
   }
 }
 
+size_t LayerGraphic::memoryUsage() const {
+  auto usage = sizeof(LayerGraphic) + contents.size() * sizeof(std::shared_ptr<Graphic>);
+  for (auto& content : contents) {
+    usage += content->memoryUsage();
+  }
+  return usage;
+}
+
 std::shared_ptr<Graphic> LayerGraphic::mergeWith(const Matrix& m) const {
   std::vector<std::shared_ptr<Graphic>> newContents = {};
   for (auto& graphic : contents) {
@@ -219,8 +235,9 @@ class ModifierGraphic : public ComposeGraphic {
   void measureBounds(Rect* bounds) const override;
   bool hitTest(RenderCache* cache, float x, float y) override;
   bool getPath(Path* path) const override;
-  void prepare(RenderCache* cache) const override;
+  void prepare(RenderCache* cache, const Matrix& matrix) const override;
   void draw(Canvas* canvas, RenderCache* cache) const override;
+  size_t memoryUsage() const override;
   std::shared_ptr<Graphic> mergeWith(const Modifier* target) const override;
 
  private:
@@ -269,9 +286,9 @@ bool ModifierGraphic::getPath(Path* path) const {
   return true;
 }
 
-void ModifierGraphic::prepare(RenderCache* cache) const {
-  modifier->prepare(cache);
-  graphic->prepare(cache);
+void ModifierGraphic::prepare(RenderCache* cache, const Matrix& matrix) const {
+  modifier->prepare(cache, matrix);
+  graphic->prepare(cache, matrix);
 }
 
 void ModifierGraphic::draw(Canvas* canvas, RenderCache* cache) const {
@@ -280,6 +297,10 @@ void ModifierGraphic::draw(Canvas* canvas, RenderCache* cache) const {
   canvas->restore();
 }
 
+size_t ModifierGraphic::memoryUsage() const {
+  return sizeof(ModifierGraphic) + graphic->memoryUsage();
+}
+
 std::shared_ptr<Graphic> ModifierGraphic::mergeWith(const Modifier* target) const {
   if (target == nullptr || modifier->type() != target->type()) {
     return nullptr;
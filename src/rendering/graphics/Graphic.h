@@ -80,6 +80,12 @@ class Graphic {
    */
   virtual GraphicType type() const = 0;
 
+  /**
+   * Returns the estimated memory in bytes taken by this Graphic on the CPU side, such as paths and
+   * glyphs. GPU resources created for drawing it are not included.
+   */
+  virtual size_t memoryUsage() const = 0;
+
   /**
    * Gets a Path which is the filled equivalent of the Graphic contents. Returns false and
    * leaves the path unchanged if the Graphic contents are not opaque or can not be converted to
@@ -89,9 +95,9 @@ class Graphic {
 
   /**
    * Prepares this graphic for next draw() call. It collects all CPU tasks in this Graphic and run
-   * them in parallel immediately.
+   * them in parallel immediately. The matrix is the one this graphic is going to be drawn with.
    */
-  virtual void prepare(RenderCache* cache) const = 0;
+  virtual void prepare(RenderCache* cache, const Matrix& matrix) const = 0;
 
   /**
    * Draw this Graphic into specified Canvas.
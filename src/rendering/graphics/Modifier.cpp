@@ -38,7 +38,7 @@ class BlendModifier : public Modifier {
 
   bool hitTest(RenderCache* cache, float x, float y) const override;
 
-  void prepare(RenderCache*) const override {
+  void prepare(RenderCache*, const Matrix&) const override {
   }
 
   void applyToBounds(Rect*) const override{};
@@ -75,7 +75,7 @@ class ClipModifier : public Modifier {
     return clip.contains(x, y);
   }
 
-  void prepare(RenderCache*) const override {
+  void prepare(RenderCache*, const Matrix&) const override {
   }
 
   void applyToBounds(Rect* bounds) const override;
@@ -108,7 +108,7 @@ class MaskModifier : public Modifier {
 
   bool hitTest(RenderCache* cache, float x, float y) const override;
 
-  void prepare(RenderCache* cache) const override;
+  void prepare(RenderCache* cache, const Matrix& matrix) const override;
 
   void applyToBounds(Rect* bounds) const override;
 
@@ -221,9 +221,9 @@ bool MaskModifier::hitTest(RenderCache* cache, float x, float y) const {
   return result != inverted;
 }
 
-void MaskModifier::prepare(RenderCache* cache) const {
+void MaskModifier::prepare(RenderCache* cache, const Matrix& matrix) const {
   if (mask) {
-    mask->prepare(cache);
+    mask->prepare(cache, matrix);
   }
 }
 
@@ -53,9 +53,10 @@ class Modifier {
 
   /**
    * Prepares this modifier for next applyToGraphic() call. It collects all CPU tasks in this
-   * modifier and run them in parallel immediately.
+   * modifier and run them in parallel immediately. The matrix is the one the modified graphic is
+   * going to be drawn with.
    */
-  virtual void prepare(RenderCache* cache) const = 0;
+  virtual void prepare(RenderCache* cache, const Matrix& matrix) const = 0;
 
   /**
    * Applies the modification to content bounds.
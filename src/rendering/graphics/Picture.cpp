@@ -100,6 +100,11 @@ class TextureProxyPicture : public Picture {
     delete proxy;
   }
 
+  size_t memoryUsage() const override {
+    // Only the wrapper is counted, the pixels belong to the image or to the GPU caches.
+    return sizeof(TextureProxyPicture);
+  }
+
   void measureBounds(Rect* bounds) const override {
     bounds->setWH(static_cast<float>(proxy->width()), static_cast<float>(proxy->height()));
   }
@@ -128,7 +133,7 @@ class TextureProxyPicture : public Picture {
     return false;
   }
 
-  void prepare(RenderCache* cache) const override {
+  void prepare(RenderCache* cache, const Matrix&) const override {
     proxy->prepare(cache);
   }
 
@@ -195,6 +200,11 @@ class RGBAAAPicture : public Picture {
     delete proxy;
   }
 
+  size_t memoryUsage() const override {
+    // Only the wrapper is counted, the pixels belong to the image or to the GPU caches.
+    return sizeof(RGBAAAPicture);
+  }
+
   void measureBounds(Rect* bounds) const override {
     bounds->setWH(static_cast<float>(layout.width), static_cast<float>(layout.height));
   }
@@ -221,7 +231,7 @@ class RGBAAAPicture : public Picture {
     return false;
   }
 
-  void prepare(RenderCache* cache) const override {
+  void prepare(RenderCache* cache, const Matrix&) const override {
     proxy->prepare(cache);
   }
 
@@ -286,6 +296,10 @@ class SnapshotPicture : public Picture {
       : Picture(assetID), graphic(std::move(graphic)) {
   }
 
+  size_t memoryUsage() const override {
+    return sizeof(SnapshotPicture) + graphic->memoryUsage();
+  }
+
   void measureBounds(Rect* bounds) const override {
     graphic->measureBounds(bounds);
   }
@@ -303,8 +317,8 @@ class SnapshotPicture : public Picture {
     return graphic->getPath(path);
   }
 
-  void prepare(RenderCache* cache) const override {
-    graphic->prepare(cache);
+  void prepare(RenderCache* cache, const Matrix& matrix) const override {
+    graphic->prepare(cache, matrix);
   }
 
   void draw(Canvas* canvas, RenderCache* cache) const override {
@@ -399,13 +413,16 @@ class ImageTextureProxy : public TextureProxy {
     if (buffer == nullptr) {
       buffer = image->makeBuffer();
     }
-    cache->recordImageDecodingTime(GetTimer() - startTime);
+    auto decodingTime = GetTimer() - startTime;
+    cache->recordImageDecodingTime(decodingTime);
     if (buffer == nullptr) {
       return nullptr;
     }
     startTime = GetTimer();
     auto texture = buffer->makeTexture(cache->getContext());
-    cache->recordTextureUploadingTime(GetTimer() - startTime);
+    auto uploadingTime = GetTimer() - startTime;
+    cache->recordTextureUploadingTime(uploadingTime);
+    cache->recordPrefetchCost(assetID, decodingTime + uploadingTime);
     return texture;
   }
 
@@ -38,8 +38,9 @@ class Record {
 class LayerRecord : public Record {
  public:
   LayerRecord(const Matrix& matrix, std::shared_ptr<Modifier> modifier,
-              std::vector<std::shared_ptr<Graphic>> contents)
-      : Record(matrix), modifier(std::move(modifier)), oldNodes(std::move(contents)) {
+              std::vector<std::shared_ptr<Graphic>> contents, Opacity alpha, Enum blendMode)
+      : Record(matrix), modifier(std::move(modifier)), oldNodes(std::move(contents)),
+        alpha(alpha), blendMode(blendMode) {
   }
 
   RecordType type() const override {
@@ -48,6 +49,8 @@ class LayerRecord : public Record {
 
   std::shared_ptr<Modifier> modifier = nullptr;
   std::vector<std::shared_ptr<Graphic>> oldNodes = {};
+  Opacity alpha = Opaque;
+  Enum blendMode = BlendMode::Normal;
 };
 
 Matrix Recorder::getMatrix() const {
@@ -61,6 +64,14 @@ Matrix Recorder::getMatrix() const {
   return totalMatrix;
 }
 
+Opacity Recorder::getAlpha() const {
+  return totalAlpha;
+}
+
+Enum Recorder::getBlendMode() const {
+  return totalBlendMode;
+}
+
 void Recorder::setMatrix(const Matrix& m) {
   matrix = m;
   auto count = static_cast<int>(records.size());
@@ -96,6 +107,11 @@ void Recorder::saveClip(const Path& path) {
 void Recorder::saveLayer(Opacity alpha, Enum blendMode) {
   auto modifier = Modifier::MakeBlend(alpha, blendMode);
   saveLayer(modifier);
+  // The BlendModifier is applied to each graphic in the layer rather than to the layer as a whole.
+  totalAlpha = OpacityConcat(totalAlpha, alpha);
+  if (blendMode != BlendMode::Normal) {
+    totalBlendMode = blendMode;
+  }
 }
 
 void Recorder::saveLayer(std::shared_ptr<Modifier> modifier) {
@@ -103,7 +119,8 @@ void Recorder::saveLayer(std::shared_ptr<Modifier> modifier) {
     save();
     return;
   }
-  auto record = std::make_shared<LayerRecord>(matrix, modifier, layerContents);
+  auto record =
+      std::make_shared<LayerRecord>(matrix, modifier, layerContents, totalAlpha, totalBlendMode);
   records.push_back(record);
   matrix = Matrix::I();
   layerContents = {};
@@ -125,6 +142,8 @@ void Recorder::restore() {
   if (record->type() == RecordType::Layer) {
     layerIndex--;
     auto layerRecord = std::static_pointer_cast<LayerRecord>(record);
+    totalAlpha = layerRecord->alpha;
+    totalBlendMode = layerRecord->blendMode;
     auto layerGraphic = Graphic::MakeCompose(layerContents);
     layerGraphic = Graphic::MakeCompose(layerGraphic, layerRecord->modifier);
     layerContents = layerRecord->oldNodes;
@@ -164,4 +183,12 @@ void Recorder::drawGraphic(std::shared_ptr<Graphic> graphic) {
 std::shared_ptr<Graphic> Recorder::makeGraphic() {
   return Graphic::MakeCompose(rootContents);
 }
+
+int Recorder::culledLayerCount() const {
+  return _culledLayerCount;
+}
+
+void Recorder::addCulledLayers(int count) {
+  _culledLayerCount += count;
+}
 }  // namespace pag
\ No newline at end of file
@@ -34,6 +34,18 @@ class Recorder {
    */
   Matrix getMatrix() const;
 
+  /**
+   * Returns the total alpha that the layers saved by saveLayer() apply to each graphic drawn from
+   * now on.
+   */
+  Opacity getAlpha() const;
+
+  /**
+   * Returns the blend mode that the layers saved by saveLayer() apply to each graphic drawn from
+   * now on, which is BlendMode::Normal if none of them has a blend mode.
+   */
+  Enum getBlendMode() const;
+
   /**
    * Replaces transformation with specified matrix. Unlike concat(), any prior matrix state is
    * overwritten.
@@ -121,11 +133,26 @@ class Recorder {
    */
   std::shared_ptr<Graphic> makeGraphic();
 
+  /**
+   * Returns the number of layers skipped by the recorder because they are completely hidden by
+   * opaque layers above them.
+   */
+  int culledLayerCount() const;
+
+  /**
+   * Records that the specified number of layers are skipped because they are completely hidden by
+   * opaque layers above them.
+   */
+  void addCulledLayers(int count);
+
  private:
   std::vector<std::shared_ptr<Graphic>> rootContents = {};
   int layerIndex = 0;
   Matrix matrix = Matrix::I();
+  Opacity totalAlpha = Opaque;
+  Enum totalBlendMode = BlendMode::Normal;
   std::vector<std::shared_ptr<Graphic>> layerContents = {};
   std::vector<std::shared_ptr<Record>> records = {};
+  int _culledLayerCount = 0;
 };
 }  // namespace pag
@@ -18,6 +18,7 @@
 
 #include "Shape.h"
 #include "core/Canvas.h"
+#include "rendering/caches/RenderCache.h"
 #include "pag/file.h"
 
 namespace pag {
@@ -62,7 +63,8 @@ bool Shape::getPath(Path* result) const {
   return true;
 }
 
-void Shape::prepare(RenderCache*) const {
+void Shape::prepare(RenderCache* cache, const Matrix& matrix) const {
+  cache->preparePathMask(path, matrix);
 }
 
 void Shape::draw(Canvas* canvas, RenderCache*) const {
@@ -76,4 +78,17 @@ void Shape::draw(Canvas* canvas, RenderCache*) const {
   }
 }
 
+size_t Shape::memoryUsage() const {
+  auto usage = sizeof(Shape) + static_cast<size_t>(path.countPoints()) * sizeof(Point) +
+               static_cast<size_t>(path.countVerbs());
+  if (fill->type() == ShapeFillType::Gradient) {
+    auto& gradient = static_cast<GradientFill*>(fill)->gradient;
+    usage += sizeof(GradientFill) + gradient.colors.size() * sizeof(Color) +
+             gradient.alphas.size() * sizeof(Opacity) + gradient.positions.size() * sizeof(float);
+  } else {
+    usage += sizeof(SolidFill);
+  }
+  return usage;
+}
+
 }  // namespace pag
\ No newline at end of file
@@ -69,8 +69,9 @@ class Shape : public Graphic {
   void measureBounds(Rect* bounds) const override;
   bool hitTest(RenderCache* cache, float x, float y) override;
   bool getPath(Path* result) const override;
-  void prepare(RenderCache* cache) const override;
+  void prepare(RenderCache* cache, const Matrix& matrix) const override;
   void draw(Canvas* canvas, RenderCache* cache) const override;
+  size_t memoryUsage() const override;
 
  private:
   Path path = {};
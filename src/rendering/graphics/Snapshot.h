@@ -70,8 +70,14 @@ class Snapshot {
   Matrix matrix = Matrix::I();
   ID assetID = 0;
   uint64_t makerKey = 0;
+  int scaleBucket = 0;
   Frame idleFrames = 0;
+  // The number of consecutive frames the snapshot is drawn for the next smaller bucket.
+  Frame downscaledFrames = 0;
+  bool shared = false;
 
   friend class RenderCache;
+
+  friend class SharedSnapshotCache;
 };
 }  // namespace pag
@@ -20,8 +20,11 @@
 
 #include "Text.h"
 #include "core/Canvas.h"
+#include "gpu/GlyphAtlas.h"
 #include "pag/file.h"
 #include "raster/PathEffect.h"
+#include "raster/TextBlob.h"
+#include "rendering/caches/RenderCache.h"
 
 namespace pag {
 static std::unique_ptr<Paint> CreateFillPaint(const Glyph* glyph) {
@@ -233,7 +236,26 @@ bool Text::getPath(Path* path) const {
   return true;
 }
 
-void Text::prepare(RenderCache*) const {
+// The filled glyphs that fit in the glyph atlas are drawn from it instead of the glyph paths, they
+// stay cached however the glyphs move, which suits the text animators.
+static bool UseGlyphAtlas(const TextRun* textRun, const Paint* paint, const Matrix& matrix) {
+  return paint != nullptr && paint->getStyle() == PaintStyle::Fill &&
+         GlyphAtlas::CanUseAtlas(textRun->textFont, matrix);
+}
+
+void Text::prepare(RenderCache* cache, const Matrix& matrix) const {
+  auto& paths = getGlyphPaths();
+  size_t index = 0;
+  for (auto& textRun : textRuns) {
+    auto runMatrix = matrix;
+    runMatrix.preConcat(textRun->matrix);
+    for (int i = 0; i < 2; i++) {
+      auto& path = paths[index++];
+      if (path != nullptr && !UseGlyphAtlas(textRun, textRun->paints[i], runMatrix)) {
+        cache->preparePathMask(*path, runMatrix);
+      }
+    }
+  }
 }
 
 void Text::draw(Canvas* canvas, RenderCache*) const {
@@ -241,15 +263,78 @@ void Text::draw(Canvas* canvas, RenderCache*) const {
   drawTextRuns(static_cast<Canvas*>(canvas), 1);
 }
 
+size_t Text::memoryUsage() const {
+  auto usage = sizeof(Text);
+  for (auto& textRun : textRuns) {
+    usage += sizeof(TextRun) + textRun->glyphIDs.size() * sizeof(GlyphID) +
+             textRun->positions.size() * sizeof(Point);
+    for (auto& paint : textRun->paints) {
+      if (paint != nullptr) {
+        usage += sizeof(Paint);
+      }
+    }
+  }
+  // The glyph paths are built by the first drawing anyway, build them now to count them in.
+  for (auto& path : getGlyphPaths()) {
+    if (path != nullptr) {
+      usage += sizeof(Path) + static_cast<size_t>(path->countPoints()) * sizeof(Point) +
+               static_cast<size_t>(path->countVerbs());
+    }
+  }
+  return usage;
+}
+
+// Builds the same path as Canvas::drawGlyphs() does, so that the glyphs are drawn as a path whose
+// mask can be prepared ahead and cached across frames.
+static std::unique_ptr<Path> MakeGlyphPath(const TextRun* textRun, const Paint* paint) {
+  auto& textFont = textRun->textFont;
+  if (paint == nullptr || textRun->glyphIDs.empty() || textFont.getTypeface()->hasColor()) {
+    return nullptr;
+  }
+  auto textBlob = TextBlob::MakeFrom(&textRun->glyphIDs[0], &textRun->positions[0],
+                                     textRun->glyphIDs.size(), textFont);
+  if (textBlob == nullptr) {
+    return nullptr;
+  }
+  auto stroke = paint->getStyle() == PaintStyle::Stroke ? paint->getStroke() : nullptr;
+  auto path = std::make_unique<Path>();
+  if (!textBlob->getPath(path.get(), stroke)) {
+    return nullptr;
+  }
+  return path;
+}
+
+const std::vector<std::unique_ptr<Path>>& Text::getGlyphPaths() const {
+  std::call_once(glyphPathsFlag, [this]() {
+    for (auto& textRun : textRuns) {
+      for (auto& paint : textRun->paints) {
+        glyphPaths.push_back(MakeGlyphPath(textRun, paint));
+      }
+    }
+  });
+  return glyphPaths;
+}
+
 void Text::drawTextRuns(Canvas* canvas, int paintIndex) const {
+  auto& paths = getGlyphPaths();
   auto totalMatrix = canvas->getMatrix();
+  size_t index = 0;
   for (auto& textRun : textRuns) {
+    auto& glyphPath = paths[index * 2 + paintIndex];
+    index++;
     auto textPaint = textRun->paints[paintIndex];
     if (!textPaint) {
       continue;
     }
     canvas->setMatrix(totalMatrix);
     canvas->concat(textRun->matrix);
+    if (glyphPath != nullptr && !UseGlyphAtlas(textRun, textPaint, canvas->getMatrix())) {
+      canvas->save();
+      canvas->concatAlpha(textPaint->getAlpha());
+      canvas->drawPath(*glyphPath, textPaint->getColor());
+      canvas->restore();
+      continue;
+    }
     auto glyphs = &textRun->glyphIDs[0];
     auto positions = &textRun->positions[0];
     canvas->drawGlyphs(glyphs, positions, textRun->glyphIDs.size(), textRun->textFont, *textPaint);
@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <mutex>
 #include "core/Paint.h"
 #include "rendering/graphics/Graphic.h"
 
@@ -54,15 +55,21 @@ class Text : public Graphic {
   void measureBounds(Rect* rect) const override;
   bool hitTest(RenderCache* cache, float x, float y) override;
   bool getPath(Path* path) const override;
-  void prepare(RenderCache* cache) const override;
+  void prepare(RenderCache* cache, const Matrix& matrix) const override;
   void draw(Canvas* canvas, RenderCache* cache) const override;
+  size_t memoryUsage() const override;
 
  private:
   std::vector<TextRun*> textRuns;
   Rect bounds = Rect::MakeEmpty();
   bool hasAlpha = false;
+  mutable std::once_flag glyphPathsFlag;
+  // Two paths for each text run, one for each paint. A path is nullptr if the paint is absent or
+  // the glyphs have no outlines.
+  mutable std::vector<std::unique_ptr<Path>> glyphPaths = {};
 
   explicit Text(const std::vector<TextRun*>& textRuns, const Rect& bounds, bool hasAlpha);
+  const std::vector<std::unique_ptr<Path>>& getGlyphPaths() const;
   void drawTextRuns(Canvas* canvas, int paintIndex) const;
 };
 }  // namespace pag
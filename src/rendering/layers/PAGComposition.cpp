@@ -20,12 +20,14 @@
 #include "base/utils/TimeUtil.h"
 #include "pag/pag.h"
 #include "rendering/caches/CompositionCache.h"
+#include "rendering/caches/FrameCache.h"
 #include "rendering/caches/LayerCache.h"
 #include "rendering/caches/RenderCache.h"
 #include "rendering/graphics/Recorder.h"
 #include "rendering/layers/PAGStage.h"
 #include "rendering/renderers/LayerRenderer.h"
 #include "rendering/utils/LockGuard.h"
+#include "rendering/utils/OcclusionCuller.h"
 #include "rendering/utils/ScopedLock.h"
 
 namespace pag {
@@ -419,14 +421,23 @@ void PAGComposition::draw(Recorder* recorder) {
   if (hasClip()) {
     recorder->saveClip(0, 0, static_cast<float>(_width), static_cast<float>(_height));
   }
+  auto occludedLayers = OcclusionCuller::FindOccludedLayers(
+      this, recorder->getMatrix(), recorder->getAlpha(), recorder->getBlendMode());
+  int culledCount = 0;
   auto count = static_cast<int>(layers.size());
   for (int i = 0; i < count; i++) {
     auto& childLayer = layers[i];
     if (!childLayer->layerVisible) {
       continue;
     }
+    if (occludedLayers[i]) {
+      // 被上方不透明图层完全遮挡的图层无需绘制，也就不会触发解码。
+      culledCount++;
+      continue;
+    }
     DrawChildLayer(recorder, childLayer.get());
   }
+  recorder->addCulledLayers(culledCount);
   if (hasClip()) {
     recorder->restore();
   }
@@ -502,6 +513,7 @@ std::vector<std::shared_ptr<PAGLayer>> PAGComposition::getLayersByName(
 std::vector<std::shared_ptr<PAGLayer>> PAGComposition::getLayersUnderPoint(float localX,
                                                                            float localY) {
   LockGuard autoLock(rootLocker);
+  FrameCachePass framePass = {};
   std::vector<std::shared_ptr<PAGLayer>> results;
   getLayersUnderPointInternal(localX, localY, &results);
   return results;
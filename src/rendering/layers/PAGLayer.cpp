@@ -20,6 +20,7 @@
 #include "base/utils/TimeUtil.h"
 #include "base/utils/UniqueID.h"
 #include "pag/pag.h"
+#include "rendering/caches/FrameCache.h"
 #include "rendering/caches/LayerCache.h"
 #include "rendering/caches/RenderCache.h"
 #include "rendering/layers/PAGStage.h"
@@ -113,6 +114,7 @@ void PAGLayer::setVisibleInternal(bool value) {
 
 Rect PAGLayer::getBounds() {
   LockGuard autoLock(rootLocker);
+  FrameCachePass framePass = {};
   Rect bounds = {};
   measureBounds(&bounds);
   return bounds;
@@ -27,6 +27,7 @@
 #include "rendering/readers/SequenceReader.h"
 #include "rendering/renderers/CompositionRenderer.h"
 #include "rendering/utils/LockGuard.h"
+#include "rendering/utils/OcclusionCuller.h"
 
 namespace pag {
 std::shared_ptr<PAGStage> PAGStage::Make(int width, int height) {
@@ -54,6 +55,16 @@ void PAGStage::setCacheScale(float value) {
   _cacheScale = value;
 }
 
+void PAGStage::setVideoEnabled(bool value) {
+  if (_videoEnabled == value) {
+    return;
+  }
+  _videoEnabled = value;
+  // 视频帧能否遮挡下方图层发生了变化，需要重新录制和预测。
+  rootVersion = -1;
+  notifyModified(true);
+}
+
 std::shared_ptr<PAGComposition> PAGStage::getRootComposition() {
   if (layers.empty()) {
     return nullptr;
@@ -255,12 +266,26 @@ void PAGStage::updateLayerStartTime(PAGLayer* pagLayer) {
 }
 
 void PAGStage::updateChildLayerStartTime(PAGComposition* pagComposition) {
-  for (auto& childLayer : pagComposition->layers) {
+  std::vector<PAGLayer*> occluders = {};
+  auto& layers = pagComposition->layers;
+  for (auto i = static_cast<int>(layers.size()) - 1; i >= 0; i--) {
+    auto childLayer = layers[i].get();
     if (!childLayer->layerVisible || childLayer->_excludedFromTimeline) {
       // 不可见和脱离时间轴的图层不需要预测。
       continue;
     }
-    updateLayerStartTime(childLayer.get());
+    auto occluded =
+        std::any_of(occluders.begin(), occluders.end(), [childLayer](PAGLayer* occluder) {
+          return OcclusionCuller::CoversTimeRange(occluder, childLayer);
+        });
+    if (occluded) {
+      // 整个可见时间段内都被上方全屏不透明图层遮挡的图层永远不会被绘制，也不需要预测。
+      continue;
+    }
+    if (OcclusionCuller::IsFullFrameOccluder(pagComposition, childLayer)) {
+      occluders.push_back(childLayer);
+    }
+    updateLayerStartTime(childLayer);
   }
 }
 
@@ -278,6 +303,10 @@ std::unordered_set<ID> PAGStage::getRemovedAssets() {
   return removedAssets;
 }
 
+bool PAGStage::hasReference(ID referenceID) const {
+  return layerReferenceMap.count(referenceID) > 0;
+}
+
 float PAGStage::getAssetMaxScale(ID referenceID) {
   return getMaxScaleFactor(referenceID) * _cacheScale;
 }
@@ -52,6 +52,20 @@ class PAGStage : public PAGComposition {
    */
   void setCacheScale(float value);
 
+  /**
+   * Returns true if the video compositions are drawn. It is kept in sync with the videoEnabled
+   * property of the PAGPlayer, the opaque video frames can not hide the layers below them when
+   * they are not drawn.
+   */
+  bool videoEnabled() const {
+    return _videoEnabled;
+  }
+
+  /**
+   * Set the value of videoEnabled property.
+   */
+  void setVideoEnabled(bool value);
+
   /**
    * Returns the first root composition.
    */
@@ -93,6 +107,11 @@ class PAGStage : public PAGComposition {
 
   std::unordered_set<ID> getRemovedAssets();
 
+  /**
+   * Returns true if any layer on this stage references the asset.
+   */
+  bool hasReference(ID referenceID) const;
+
   float getAssetMaxScale(ID referenceID);
 
  protected:
@@ -106,6 +125,7 @@ class PAGStage : public PAGComposition {
 
  private:
   float _cacheScale = 1.0f;
+  bool _videoEnabled = true;
   int64_t rootVersion = -1;
   std::unordered_map<PAGLayer*, Frame> layerStartTimeMap = {};
   std::unordered_map<ID, std::vector<PAGLayer*>> layerReferenceMap = {};
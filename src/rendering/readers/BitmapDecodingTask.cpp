@@ -19,15 +19,38 @@
 #include "BitmapDecodingTask.h"
 
 namespace pag {
+std::shared_ptr<Task> BitmapRectDecodingTask::MakeAndRun(std::shared_ptr<Image> image,
+                                                         const ImageInfo& dstInfo, void* dstPixels,
+                                                         TaskPriority priority) {
+  auto executor = new BitmapRectDecodingTask(std::move(image), dstInfo, dstPixels);
+  auto task = Task::Make(std::unique_ptr<BitmapRectDecodingTask>(executor));
+  task->run(priority);
+  return task;
+}
+
+BitmapRectDecodingTask::BitmapRectDecodingTask(std::shared_ptr<Image> image,
+                                               const ImageInfo& dstInfo, void* dstPixels)
+    : image(std::move(image)), dstInfo(dstInfo), dstPixels(dstPixels) {
+}
+
+void BitmapRectDecodingTask::execute() {
+  _executed = true;
+  image->readPixels(dstInfo, dstPixels);
+}
+
 std::shared_ptr<Task> BitmapDecodingTask::MakeAndRun(BitmapSequenceReader* reader,
-                                                     Frame targetFrame) {
+                                                     Frame targetFrame, TaskPriority priority) {
   if (reader == nullptr) {
     return nullptr;
   }
-  auto executor = new BitmapDecodingTask(reader, targetFrame);
-  auto task = Task::Make(std::unique_ptr<BitmapDecodingTask>(executor));
-  task->run();
-  return task;
+  auto executor = std::unique_ptr<BitmapDecodingTask>(new BitmapDecodingTask(reader, targetFrame));
+  auto rectTasks = reader->decodeRectsAsync(targetFrame, priority);
+  if (rectTasks.empty()) {
+    auto task = Task::Make(std::move(executor));
+    task->run(priority);
+    return task;
+  }
+  return Task::MakeAfter(rectTasks, std::move(executor), priority);
 }
 
 BitmapDecodingTask::BitmapDecodingTask(BitmapSequenceReader* reader, Frame targetFrame)
@@ -37,4 +60,4 @@ BitmapDecodingTask::BitmapDecodingTask(BitmapSequenceReader* reader, Frame targe
 void BitmapDecodingTask::execute() {
   reader->decodeFrame(targetFrame);
 }
-}  // namespace pag
\ No newline at end of file
+}  // namespace pag
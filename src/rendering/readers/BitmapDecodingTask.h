@@ -20,11 +20,45 @@
 
 #include "BitmapSequenceReader.h"
 #include "base/utils/Task.h"
+#include "image/Image.h"
 
 namespace pag {
+/**
+ * Decodes the image of one BitmapRect directly into its region of the sequence bitmap, so that the
+ * disjoint rects of a frame can be decoded in parallel.
+ */
+class BitmapRectDecodingTask : public Executor {
+ public:
+  static std::shared_ptr<Task> MakeAndRun(std::shared_ptr<Image> image, const ImageInfo& dstInfo,
+                                          void* dstPixels, TaskPriority priority);
+
+  /**
+   * Returns false if the task was cancelled before it was executed, in which case the region of
+   * the bitmap is left unchanged.
+   */
+  bool executed() const {
+    return _executed;
+  }
+
+ private:
+  std::shared_ptr<Image> image = nullptr;
+  ImageInfo dstInfo = {};
+  void* dstPixels = nullptr;
+  bool _executed = false;
+
+  BitmapRectDecodingTask(std::shared_ptr<Image> image, const ImageInfo& dstInfo, void* dstPixels);
+  void execute() override;
+};
+
 class BitmapDecodingTask : public Executor {
  public:
-  static std::shared_ptr<Task> MakeAndRun(BitmapSequenceReader* reader, Frame targetFrame);
+  /**
+   * Decodes the target frame into the bitmap of the reader. If the target frame has more than one
+   * bitmap rect to decode, they are decoded into the bitmap in parallel and then finished by a
+   * continuation task.
+   */
+  static std::shared_ptr<Task> MakeAndRun(BitmapSequenceReader* reader, Frame targetFrame,
+                                          TaskPriority priority);
 
  private:
   BitmapSequenceReader* reader = nullptr;
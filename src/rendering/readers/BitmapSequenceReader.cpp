@@ -18,6 +18,7 @@
 
 #include "BitmapSequenceReader.h"
 #include "BitmapDecodingTask.h"
+#include "core/Data.h"
 #include "rendering/caches/RenderCache.h"
 #include "rendering/graphics/Picture.h"
 
@@ -31,9 +32,28 @@ BitmapSequenceReader::BitmapSequenceReader(std::shared_ptr<File> file, BitmapSeq
     bitmap.eraseAll();
   }
 }
+
+BitmapSequenceReader::~BitmapSequenceReader() {
+  // Cancels the continuation first, it may be finishing the rect tasks right now. Then cancel the
+  // rect tasks before the bitmap is released, cancel() blocks until the executing ones finish.
+  lastTask = nullptr;
+  std::lock_guard<std::mutex> autoLock(locker);
+  for (auto& task : pendingRectTasks) {
+    task->cancel();
+  }
+  if (!pendingRectTasks.empty()) {
+    bitmap.unlockPixels();
+  }
+}
+
 void BitmapSequenceReader::decodeFrame(Frame targetFrame) {
   // decodeBitmap 这里需要立即加锁，防止异步解码时线程冲突。
   std::lock_guard<std::mutex> autoLock(locker);
+  finishRectTasks();
+  decodeFrameInternal(targetFrame);
+}
+
+void BitmapSequenceReader::decodeFrameInternal(Frame targetFrame) {
   if (lastDecodeFrame == targetFrame || bitmap.isEmpty()) {
     return;
   }
@@ -63,6 +83,80 @@ void BitmapSequenceReader::decodeFrame(Frame targetFrame) {
   }
 }
 
+std::vector<std::shared_ptr<Task>> BitmapSequenceReader::decodeRectsAsync(
+    Frame targetFrame, TaskPriority priority) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  finishRectTasks();
+  if (lastDecodeFrame == targetFrame || bitmap.isEmpty() ||
+      findStartFrame(targetFrame) != targetFrame) {
+    return {};
+  }
+  auto bitmapFrame = static_cast<BitmapSequence*>(sequence)->frames[targetFrame];
+  if (bitmapFrame->bitmaps.size() < 2) {
+    return {};
+  }
+  auto bitmapBounds = Rect::MakeWH(bitmap.width(), bitmap.height());
+  std::vector<std::shared_ptr<Image>> images = {};
+  std::vector<Rect> imageBounds = {};
+  for (auto bitmapRect : bitmapFrame->bitmaps) {
+    auto imageBytes =
+        Data::MakeWithoutCopy(bitmapRect->fileBytes->data(), bitmapRect->fileBytes->length());
+    auto image = Image::MakeFrom(imageBytes);
+    if (image == nullptr) {
+      continue;
+    }
+    auto bounds = Rect::MakeXYWH(bitmapRect->x, bitmapRect->y, image->width(), image->height());
+    // The rects are written into the bitmap concurrently, they must not overlap each other or
+    // cross the edges of the bitmap.
+    if (!bitmapBounds.contains(bounds)) {
+      return {};
+    }
+    for (auto& otherBounds : imageBounds) {
+      if (bounds.intersects(otherBounds)) {
+        return {};
+      }
+    }
+    images.push_back(image);
+    imageBounds.push_back(bounds);
+  }
+  if (images.size() < 2) {
+    return {};
+  }
+  auto pixels = bitmap.lockPixels();
+  // 关键帧不是全屏的时候要清屏，多个不重叠的区域不可能是全屏的。
+  if (bitmapFrame->isKeyframe) {
+    memset(pixels, 0, bitmap.byteSize());
+  }
+  auto& info = bitmap.info();
+  for (size_t i = 0; i < images.size(); i++) {
+    auto& bounds = imageBounds[i];
+    auto x = static_cast<int>(bounds.x());
+    auto y = static_cast<int>(bounds.y());
+    auto dstInfo = info.makeWH(images[i]->width(), images[i]->height());
+    auto task = BitmapRectDecodingTask::MakeAndRun(images[i], dstInfo,
+                                                   info.computeOffset(pixels, x, y), priority);
+    pendingRectTasks.push_back(task);
+  }
+  pendingRectFrame = targetFrame;
+  return pendingRectTasks;
+}
+
+void BitmapSequenceReader::finishRectTasks() {
+  if (pendingRectTasks.empty()) {
+    return;
+  }
+  auto executed = true;
+  for (auto& task : pendingRectTasks) {
+    auto executor = static_cast<BitmapRectDecodingTask*>(task->wait());
+    executed = executor->executed() && executed;
+  }
+  pendingRectTasks = {};
+  bitmap.unlockPixels();
+  // A cancelled task leaves its rect undecoded, start over from the key frame next time.
+  lastDecodeFrame = executed ? pendingRectFrame : -1;
+  pendingRectFrame = -1;
+}
+
 Frame BitmapSequenceReader::findStartFrame(Frame targetFrame) {
   Frame startFrame = 0;
   auto& bitmapFrames = static_cast<BitmapSequence*>(sequence)->frames;
@@ -81,7 +175,8 @@ void BitmapSequenceReader::prepareAsync(Frame targetFrame) {
       pendingFrame = targetFrame;
     }
   } else {
-    lastTask = BitmapDecodingTask::MakeAndRun(this, targetFrame);
+    lastTask = BitmapDecodingTask::MakeAndRun(this, targetFrame, TaskPriority::Prefetch);
+    lastTaskFrame = targetFrame;
   }
 }
 
@@ -90,6 +185,10 @@ std::shared_ptr<Texture> BitmapSequenceReader::readTexture(Frame targetFrame, Re
     return lastTexture;
   }
   auto startTime = GetTimer();
+  if (lastTask != nullptr && lastTaskFrame == targetFrame) {
+    // 异步任务正在解码目标帧，等待它完成比取消后重新同步解码更快。
+    lastTask->wait();
+  }
   // 必须提前置空，否则会出现对 Bitmap 写入的竞争导致内容不一致，或者死锁，析构会触发 cancel(),
   // 可能会阻塞当前线程。
   lastTask = nullptr;
@@ -107,7 +206,10 @@ std::shared_ptr<Texture> BitmapSequenceReader::readTexture(Frame targetFrame, Re
       pendingFrame = -1;
     }
     if (nextFrame < sequence->duration()) {
-      lastTask = BitmapDecodingTask::MakeAndRun(this, nextFrame);
+      // The next frame is most likely to be read in the next flush, don't put it behind the
+      // look-ahead tasks.
+      lastTask = BitmapDecodingTask::MakeAndRun(this, nextFrame, TaskPriority::Urgent);
+      lastTaskFrame = nextFrame;
     }
   }
   return lastTexture;
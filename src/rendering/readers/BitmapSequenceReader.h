@@ -28,8 +28,19 @@ class BitmapSequenceReader : public SequenceReader {
  public:
   BitmapSequenceReader(std::shared_ptr<File> file, BitmapSequence* sequence);
 
+  ~BitmapSequenceReader() override;
+
   void decodeFrame(Frame targetFrame);
 
+  /**
+   * Starts decoding the bitmap rects of the target frame directly into the bitmap in parallel, and
+   * returns the tasks decoding them. The pending tasks are finished by the next call to
+   * decodeFrame(). Returns an empty vector if the target frame has less than two rects, depends on
+   * other frames that are not decoded yet, or has overlapping rects, in which case it should be
+   * decoded by decodeFrame() directly.
+   */
+  std::vector<std::shared_ptr<Task>> decodeRectsAsync(Frame targetFrame, TaskPriority priority);
+
   void prepareAsync(Frame targetFrame) override;
 
   std::shared_ptr<Texture> readTexture(Frame frame, RenderCache* cache) override;
@@ -39,10 +50,16 @@ class BitmapSequenceReader : public SequenceReader {
   Frame lastDecodeFrame = -1;
   Frame lastTextureFrame = -1;
   Frame pendingFrame = -1;
+  Frame lastTaskFrame = -1;
   Bitmap bitmap = {};
   std::shared_ptr<Texture> lastTexture = nullptr;
   std::shared_ptr<Task> lastTask = nullptr;
+  // Guarded by the locker, the bitmap pixels are kept locked while the tasks are pending.
+  std::vector<std::shared_ptr<Task>> pendingRectTasks = {};
+  Frame pendingRectFrame = -1;
 
   Frame findStartFrame(Frame targetFrame);
+  void decodeFrameInternal(Frame targetFrame);
+  void finishRectTasks();
 };
 }  // namespace pag
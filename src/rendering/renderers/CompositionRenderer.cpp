@@ -18,6 +18,7 @@
 
 #include "CompositionRenderer.h"
 #include "LayerRenderer.h"
+#include "base/utils/GetTimer.h"
 #include "rendering/caches/LayerCache.h"
 #include "rendering/caches/RenderCache.h"
 #include "rendering/graphics/Picture.h"
@@ -41,11 +42,14 @@ class SequenceProxy : public TextureProxy {
   }
 
   std::shared_ptr<Texture> getTexture(RenderCache* cache) const override {
+    auto startTime = GetTimer();
     auto reader = static_cast<RenderCache*>(cache)->getSequenceReader(sequence);
-    if (reader) {
-      return reader->readTexture(frame, static_cast<RenderCache*>(cache));
+    if (reader == nullptr) {
+      return nullptr;
     }
-    return nullptr;
+    auto texture = reader->readTexture(frame, static_cast<RenderCache*>(cache));
+    cache->recordPrefetchCost(sequence->composition->uniqueID, GetTimer() - startTime);
+    return texture;
   }
 
  private:
@@ -23,4 +23,7 @@
 
 namespace pag {
 std::shared_ptr<Graphic> RenderShapes(const std::vector<ShapeElement*>& contents, Frame layerFrame);
+
+GradientPaint MakeGradientPaint(Enum fillType, Point startPoint, Point endPoint,
+                                const GradientColorHandle& gradientColor, const Matrix& matrix);
 }
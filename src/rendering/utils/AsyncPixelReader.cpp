@@ -0,0 +1,116 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "AsyncPixelReader.h"
+#include <algorithm>
+#include <new>
+#include "gpu/opengl/GLSurface.h"
+
+namespace pag {
+AsyncPixelReader::AsyncPixelReader(size_t maxPendingReads)
+    : maxPendingReads(std::max(maxPendingReads, static_cast<size_t>(1))) {
+}
+
+bool AsyncPixelReader::read(Surface* surface, const ImageInfo& dstInfo, int64_t frame,
+                            ReadPixelsCallback callback, std::vector<PixelReadResult>* results) {
+  if (surface == nullptr || dstInfo.isEmpty() || callback == nullptr) {
+    return false;
+  }
+  auto context = surface->getContext();
+  collect(context, false, results);
+  if (pendingReads.size() >= maxPendingReads) {
+    // The ring is full, waits for the oldest read to reuse its buffer.
+    results->push_back(MakeResult(context, &pendingReads.front()));
+    pendingReads.pop_front();
+  }
+  auto renderTarget = static_cast<GLSurface*>(surface)->getRenderTarget();
+  auto alphaOnly = renderTarget->getGLInfo().format == GL::R8;
+  auto pixelBuffer =
+      GLPixelBuffer::Make(context, renderTarget->width(), renderTarget->height(), alphaOnly);
+  if (pixelBuffer == nullptr) {
+    // Falls back to a blocking read if pixel buffers are not supported.
+    PixelReadResult result = {};
+    result.pixels = std::unique_ptr<uint8_t[]>(new (std::nothrow) uint8_t[dstInfo.byteSize()]);
+    if (result.pixels == nullptr || !surface->readPixels(dstInfo, result.pixels.get())) {
+      return false;
+    }
+    result.frame = frame;
+    result.callback = std::move(callback);
+    result.rowBytes = dstInfo.rowBytes();
+    results->push_back(std::move(result));
+    return true;
+  }
+  surface->getCanvas()->flush();
+  renderTarget->resolve(context);
+  if (!pixelBuffer->readPixels(context, renderTarget.get())) {
+    return false;
+  }
+  PendingRead pendingRead = {};
+  pendingRead.frame = frame;
+  pendingRead.dstInfo = dstInfo;
+  pendingRead.callback = std::move(callback);
+  pendingRead.pixelBuffer = pixelBuffer;
+  pendingReads.push_back(std::move(pendingRead));
+  return true;
+}
+
+void AsyncPixelReader::finish(Context* context, std::vector<PixelReadResult>* results) {
+  collect(context, true, results);
+}
+
+void AsyncPixelReader::abandon(std::vector<PixelReadResult>* results) {
+  // The pixel buffers are released by their context.
+  for (auto& pendingRead : pendingReads) {
+    PixelReadResult result = {};
+    result.frame = pendingRead.frame;
+    result.callback = std::move(pendingRead.callback);
+    results->push_back(std::move(result));
+  }
+  pendingReads.clear();
+}
+
+void AsyncPixelReader::collect(Context* context, bool wait,
+                               std::vector<PixelReadResult>* results) {
+  // Hands out the reads in the order they were started, a finished read waits for the ones
+  // before it.
+  while (!pendingReads.empty()) {
+    auto& pendingRead = pendingReads.front();
+    if (!pendingRead.pixelBuffer->isFinished(context, wait)) {
+      break;
+    }
+    results->push_back(MakeResult(context, &pendingRead));
+    pendingReads.pop_front();
+  }
+}
+
+PixelReadResult AsyncPixelReader::MakeResult(Context* context, PendingRead* pendingRead) {
+  PixelReadResult result = {};
+  result.frame = pendingRead->frame;
+  result.callback = std::move(pendingRead->callback);
+  auto& dstInfo = pendingRead->dstInfo;
+  result.pixels = std::unique_ptr<uint8_t[]>(new (std::nothrow) uint8_t[dstInfo.byteSize()]);
+  if (result.pixels != nullptr &&
+      pendingRead->pixelBuffer->getPixels(context, dstInfo, result.pixels.get())) {
+    result.rowBytes = dstInfo.rowBytes();
+  } else {
+    // The callback receives null pixels if the read failed.
+    result.pixels = nullptr;
+  }
+  return result;
+}
+}  // namespace pag
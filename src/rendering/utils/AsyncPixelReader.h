@@ -0,0 +1,89 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <deque>
+#include "gpu/Surface.h"
+#include "gpu/opengl/GLPixelBuffer.h"
+#include "pag/pag.h"
+
+namespace pag {
+/**
+ * The pixels of a finished read, which are handed to the callback once the render lock is released.
+ */
+struct PixelReadResult {
+  int64_t frame = 0;
+  ReadPixelsCallback callback = nullptr;
+  std::unique_ptr<uint8_t[]> pixels = nullptr;
+  size_t rowBytes = 0;
+};
+
+/**
+ * AsyncPixelReader copies the pixels of a surface into a ring of pixel buffers, so the GPU renders
+ * the next frames while the previous ones are transferred. It reads pixels synchronously if pixel
+ * buffers are not supported, such as on GL ES 2.0.
+ */
+class AsyncPixelReader {
+ public:
+  /**
+   * Creates a reader which keeps at most maxPendingReads copies in flight.
+   */
+  explicit AsyncPixelReader(size_t maxPendingReads = 3);
+
+  /**
+   * Starts copying all pixels of the surface with the specified ImageInfo. The reads that have
+   * finished, including this one if it is read synchronously, are appended to the results in the
+   * order they were started. Returns false if the copy can not be started.
+   */
+  bool read(Surface* surface, const ImageInfo& dstInfo, int64_t frame,
+            ReadPixelsCallback callback, std::vector<PixelReadResult>* results);
+
+  /**
+   * Waits for all pending reads and appends them to the results.
+   */
+  void finish(Context* context, std::vector<PixelReadResult>* results);
+
+  /**
+   * Drops all pending reads without waiting for them, which is used when no context is available.
+   * They are appended to the results with null pixels.
+   */
+  void abandon(std::vector<PixelReadResult>* results);
+
+  /**
+   * Returns true if there are reads that have not been handed out yet.
+   */
+  bool hasPendingReads() const {
+    return !pendingReads.empty();
+  }
+
+ private:
+  struct PendingRead {
+    int64_t frame = 0;
+    ImageInfo dstInfo = {};
+    ReadPixelsCallback callback = nullptr;
+    std::shared_ptr<GLPixelBuffer> pixelBuffer = nullptr;
+  };
+
+  size_t maxPendingReads = 3;
+  std::deque<PendingRead> pendingReads = {};
+
+  void collect(Context* context, bool wait, std::vector<PixelReadResult>* results);
+  static PixelReadResult MakeResult(Context* context, PendingRead* pendingRead);
+};
+}  // namespace pag
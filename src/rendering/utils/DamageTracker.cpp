@@ -0,0 +1,192 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "DamageTracker.h"
+#include "rendering/caches/LayerCache.h"
+#include "rendering/layers/PAGStage.h"
+
+namespace pag {
+static bool SameState(const LayerState& a, const LayerState& b) {
+  return a.frame == b.frame && a.version == b.version && a.matrix == b.matrix &&
+         a.alpha == b.alpha && a.trackMatteID == b.trackMatteID &&
+         a.trackMatteFrame == b.trackMatteFrame && a.trackMatteVersion == b.trackMatteVersion &&
+         a.trackMatteMatrix == b.trackMatteMatrix && a.trackMatteAlpha == b.trackMatteAlpha &&
+         a.bounds == b.bounds;
+}
+
+Rect DamageTracker::update(PAGStage* stage) {
+  auto stageBounds = Rect::MakeWH(static_cast<float>(stage->widthInternal()),
+                                  static_cast<float>(stage->heightInternal()));
+  auto oldStates = std::move(layerStates);
+  layerStates = {};
+  CollectLayerStates(stage, Matrix::I(), Opaque, stageBounds, &layerStates);
+  if (fullDamage) {
+    fullDamage = false;
+    return stageBounds;
+  }
+  auto damage = Rect::MakeEmpty();
+  std::vector<int> oldOrders(layerStates.size(), -1);
+  for (auto& item : layerStates) {
+    auto& state = item.second;
+    auto result = oldStates.find(item.first);
+    if (result == oldStates.end()) {
+      damage.join(state.bounds);
+      continue;
+    }
+    auto& oldState = result->second;
+    oldOrders[state.order] = static_cast<int>(oldState.order);
+    if (!SameState(state, oldState)) {
+      damage.join(state.bounds);
+      damage.join(oldState.bounds);
+    }
+  }
+  for (auto& item : oldStates) {
+    if (layerStates.count(item.first) == 0) {
+      damage.join(item.second.bounds);
+    }
+  }
+  // The layers drawn in both frames must keep their drawing order, otherwise the overlaps between
+  // them change.
+  int lastOrder = -1;
+  for (auto order : oldOrders) {
+    if (order < 0) {
+      continue;
+    }
+    if (order < lastOrder) {
+      return stageBounds;
+    }
+    lastOrder = order;
+  }
+  if (!damage.isEmpty()) {
+    damage.roundOut();
+    if (!damage.intersect(stageBounds)) {
+      damage.setEmpty();
+    }
+  }
+  return damage;
+}
+
+void DamageTracker::reset() {
+  fullDamage = true;
+  layerStates = {};
+}
+
+void DamageTracker::CollectLayerStates(PAGComposition* composition, const Matrix& matrix,
+                                       Opacity alpha, const Rect& clipBounds,
+                                       std::unordered_map<ID, LayerState>* states) {
+  for (auto& childLayer : composition->layers) {
+    auto pagLayer = childLayer.get();
+    if (!pagLayer->layerVisible) {
+      continue;
+    }
+    if (ShouldDrawAsWhole(pagLayer)) {
+      auto state = MakeLayerState(pagLayer, matrix, alpha, clipBounds);
+      if (!state.bounds.isEmpty()) {
+        state.order = states->size();
+        (*states)[pagLayer->_uniqueID] = state;
+      }
+      continue;
+    }
+    auto layerCache = pagLayer->layerCache;
+    auto contentFrame = pagLayer->contentFrame;
+    if (!layerCache->contentVisible(contentFrame)) {
+      continue;
+    }
+    Transform extraTransform = {pagLayer->layerMatrix, pagLayer->layerOpacity};
+    if (!extraTransform.visible()) {
+      continue;
+    }
+    auto layerTransform = layerCache->getTransform(contentFrame);
+    auto childMatrix = matrix;
+    childMatrix.preConcat(extraTransform.matrix);
+    childMatrix.preConcat(layerTransform->matrix);
+    auto childAlpha = OpacityConcat(alpha, OpacityConcat(layerTransform->opacity,
+                                                         extraTransform.opacity));
+    auto childComposition = static_cast<PAGComposition*>(pagLayer);
+    auto childClipBounds = clipBounds;
+    if (childComposition->hasClip()) {
+      auto bounds = Rect::MakeWH(static_cast<float>(childComposition->_width),
+                                 static_cast<float>(childComposition->_height));
+      childMatrix.mapRect(&bounds);
+      if (!childClipBounds.intersect(bounds)) {
+        continue;
+      }
+    }
+    CollectLayerStates(childComposition, childMatrix, childAlpha, childClipBounds, states);
+  }
+}
+
+bool DamageTracker::ShouldDrawAsWhole(PAGLayer* pagLayer) {
+  if (pagLayer->layerType() != LayerType::PreCompose || pagLayer->_trackMatteLayer != nullptr) {
+    return true;
+  }
+  auto layer = pagLayer->layer;
+  // The masks, filters and motion blur of a composition change the pixels outside the bounds of
+  // its children.
+  if (!layer->masks.empty() || !layer->effects.empty() || !layer->layerStyles.empty() ||
+      layer->motionBlur) {
+    return true;
+  }
+  auto composition = static_cast<PreComposeLayer*>(layer)->composition;
+  if (composition->type() != CompositionType::Vector) {
+    return true;
+  }
+  // A composition whose content is drawn from the cache does not draw its children.
+  return !pagLayer->contentModified() && pagLayer->layerCache->contentStatic();
+}
+
+Frame DamageTracker::GetStaticFrame(PAGLayer* pagLayer) {
+  auto type = pagLayer->layerType();
+  // The contents of modified texts and compositions may vary in the static time ranges of the file.
+  if (pagLayer->contentModified() && (type == LayerType::Text || type == LayerType::PreCompose)) {
+    return pagLayer->contentFrame;
+  }
+  return pagLayer->layerCache->getStaticFrame(pagLayer->contentFrame);
+}
+
+LayerState DamageTracker::MakeLayerState(PAGLayer* pagLayer, const Matrix& matrix, Opacity alpha,
+                                         const Rect& clipBounds) {
+  LayerState state = {};
+  state.frame = GetStaticFrame(pagLayer);
+  state.version = pagLayer->contentVersion;
+  state.matrix = matrix;
+  state.matrix.preConcat(pagLayer->layerMatrix);
+  state.alpha = OpacityConcat(alpha, pagLayer->layerOpacity);
+  PAGComposition::MeasureChildLayer(&state.bounds, pagLayer);
+  auto trackMatteLayer = pagLayer->_trackMatteLayer.get();
+  if (trackMatteLayer != nullptr) {
+    state.trackMatteID = trackMatteLayer->_uniqueID;
+    state.trackMatteFrame = GetStaticFrame(trackMatteLayer);
+    state.trackMatteVersion = trackMatteLayer->contentVersion;
+    state.trackMatteMatrix = trackMatteLayer->layerMatrix;
+    state.trackMatteAlpha = trackMatteLayer->layerOpacity;
+    // The color glyphs of a text track matte are drawn over the layer without being masked.
+    Rect trackMatteBounds = {};
+    PAGComposition::MeasureChildLayer(&trackMatteBounds, trackMatteLayer);
+    state.bounds.join(trackMatteBounds);
+  }
+  if (state.bounds.isEmpty()) {
+    return state;
+  }
+  matrix.mapRect(&state.bounds);
+  if (!state.bounds.intersect(clipBounds)) {
+    state.bounds.setEmpty();
+  }
+  return state;
+}
+}  // namespace pag
@@ -0,0 +1,79 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <unordered_map>
+#include "pag/file.h"
+#include "pag/pag.h"
+
+namespace pag {
+class PAGStage;
+
+/**
+ * The state of a layer drawn as a whole in one frame. Two frames draw the layer with the same
+ * pixels if all of the fields are equal.
+ */
+struct LayerState {
+  Frame frame = 0;
+  uint32_t version = 0;
+  Matrix matrix = Matrix::I();
+  Opacity alpha = Opaque;
+  ID trackMatteID = 0;
+  Frame trackMatteFrame = 0;
+  uint32_t trackMatteVersion = 0;
+  Matrix trackMatteMatrix = Matrix::I();
+  Opacity trackMatteAlpha = Opaque;
+  Rect bounds = Rect::MakeEmpty();
+  size_t order = 0;
+};
+
+/**
+ * DamageTracker finds out the area of a PAGStage that changed between two frames. It collects the
+ * state of every layer that is drawn as a whole, such as shapes, texts, images and compositions
+ * with masks or filters, and compares them with the ones of the last frame. Compositions that
+ * only transform their children are walked through, so a small layer animating inside a large
+ * composition only damages its own bounds.
+ */
+class DamageTracker {
+ public:
+  /**
+   * Collects the layer states of the stage and returns the area that changed since the last call,
+   * in the coordinates of the stage. Returns the whole stage bounds after a reset.
+   */
+  Rect update(PAGStage* stage);
+
+  /**
+   * Forgets the layer states of the last frame, which makes the next update() return the whole
+   * stage bounds.
+   */
+  void reset();
+
+ private:
+  bool fullDamage = true;
+  std::unordered_map<ID, LayerState> layerStates = {};
+
+  static void CollectLayerStates(PAGComposition* composition, const Matrix& matrix,
+                                 Opacity alpha, const Rect& clipBounds,
+                                 std::unordered_map<ID, LayerState>* states);
+  static bool ShouldDrawAsWhole(PAGLayer* pagLayer);
+  static Frame GetStaticFrame(PAGLayer* pagLayer);
+  static LayerState MakeLayerState(PAGLayer* pagLayer, const Matrix& matrix, Opacity alpha,
+                                   const Rect& clipBounds);
+};
+}  // namespace pag
@@ -17,6 +17,7 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "MemoryCalculator.h"
+#include "rendering/caches/FrameCache.h"
 #include "rendering/caches/LayerCache.h"
 
 namespace pag {
@@ -312,6 +313,7 @@ int64_t CalculateGraphicsMemory(std::shared_ptr<File> file) {
   if (file == nullptr) {
     return 0;
   }
+  FrameCachePass framePass = {};
   auto rootLayer = file->getRootLayer();
   std::unordered_map<void*, Point> resourcesMaxScaleMap;
   std::unordered_map<void*, std::vector<TimeRange>*> resourcesTimeRangesMap;
@@ -0,0 +1,229 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "OcclusionCuller.h"
+#include <cmath>
+#include <cstring>
+#include "image/Image.h"
+#include "rendering/caches/ImageContentCache.h"
+#include "rendering/caches/LayerCache.h"
+#include "rendering/layers/PAGStage.h"
+
+namespace pag {
+static bool IsJPEG(ByteData* fileBytes) {
+  constexpr uint8_t jpegSig[] = {0xFF, 0xD8, 0xFF};
+  if (fileBytes == nullptr || fileBytes->length() < sizeof(jpegSig)) {
+    return false;
+  }
+  return memcmp(fileBytes->data(), jpegSig, sizeof(jpegSig)) == 0;
+}
+
+static bool HasScaleAndTranslateOnly(const Matrix& matrix) {
+  return matrix.getSkewX() == 0 && matrix.getSkewY() == 0;
+}
+
+/**
+ * Shrinks the rect to the pixels it covers completely, the edges of it may be antialiased.
+ */
+static void RoundIn(Rect* rect) {
+  rect->setLTRB(ceilf(rect->left), ceilf(rect->top), floorf(rect->right), floorf(rect->bottom));
+}
+
+static bool IsCovered(const Rect& bounds, const std::vector<Rect>& opaqueRects) {
+  for (auto& opaqueRect : opaqueRects) {
+    if (opaqueRect.contains(bounds)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::vector<bool> OcclusionCuller::FindOccludedLayers(PAGComposition* composition,
+                                                      const Matrix& matrix, Opacity alpha,
+                                                      Enum blendMode) {
+  auto& layers = composition->layers;
+  std::vector<bool> occludedLayers(layers.size(), false);
+  // The alpha and the blend mode of the parent layers are applied to each child layer separately,
+  // so a translucent or blended child layer never hides the ones below it.
+  if (alpha != Opaque || blendMode != BlendMode::Normal || !HasScaleAndTranslateOnly(matrix)) {
+    return occludedLayers;
+  }
+  auto clipBounds = Rect::MakeEmpty();
+  if (composition->hasClip()) {
+    clipBounds = Rect::MakeWH(static_cast<float>(composition->_width),
+                              static_cast<float>(composition->_height));
+    matrix.mapRect(&clipBounds);
+    clipBounds.roundOut();
+  }
+  std::vector<Rect> opaqueRects = {};
+  bool fullyOccluded = false;
+  for (auto i = static_cast<int>(layers.size()) - 1; i >= 0; i--) {
+    auto pagLayer = layers[i].get();
+    if (!pagLayer->layerVisible) {
+      continue;
+    }
+    if (fullyOccluded) {
+      occludedLayers[i] = true;
+      continue;
+    }
+    if (!opaqueRects.empty()) {
+      Rect bounds = {};
+      PAGComposition::MeasureChildLayer(&bounds, pagLayer);
+      matrix.mapRect(&bounds);
+      bounds.roundOut();
+      if (!clipBounds.isEmpty() && !bounds.intersect(clipBounds)) {
+        bounds.setEmpty();
+      }
+      if (!bounds.isEmpty() && IsCovered(bounds, opaqueRects)) {
+        occludedLayers[i] = true;
+        continue;
+      }
+    }
+    Rect opaqueBounds = {};
+    if (!GetOpaqueBounds(pagLayer, pagLayer->contentFrame, &opaqueBounds)) {
+      continue;
+    }
+    matrix.mapRect(&opaqueBounds);
+    RoundIn(&opaqueBounds);
+    if (opaqueBounds.isEmpty()) {
+      continue;
+    }
+    fullyOccluded = !clipBounds.isEmpty() && opaqueBounds.contains(clipBounds);
+    opaqueRects.push_back(opaqueBounds);
+  }
+  return occludedLayers;
+}
+
+bool OcclusionCuller::IsFullFrameOccluder(PAGComposition* composition, PAGLayer* childLayer) {
+  if (!composition->hasClip() || childLayer->_excludedFromTimeline ||
+      !childLayer->layerCache->transformStatic() || !HasOpaqueParents(composition)) {
+    return false;
+  }
+  Rect opaqueBounds = {};
+  if (!GetOpaqueBounds(childLayer, 0, &opaqueBounds)) {
+    return false;
+  }
+  auto clipBounds = Rect::MakeWH(static_cast<float>(composition->_width),
+                                 static_cast<float>(composition->_height));
+  return opaqueBounds.contains(clipBounds);
+}
+
+bool OcclusionCuller::CoversTimeRange(PAGLayer* occluder, PAGLayer* pagLayer) {
+  auto startFrame = occluder->localFrameToGlobal(occluder->startFrame);
+  auto endFrame =
+      occluder->localFrameToGlobal(occluder->startFrame + occluder->stretchedFrameDuration());
+  auto layerStartFrame = pagLayer->localFrameToGlobal(pagLayer->startFrame);
+  auto layerEndFrame =
+      pagLayer->localFrameToGlobal(pagLayer->startFrame + pagLayer->stretchedFrameDuration());
+  return startFrame <= layerStartFrame && layerEndFrame <= endFrame;
+}
+
+bool OcclusionCuller::HasOpaqueParents(PAGComposition* composition) {
+  for (PAGLayer* pagLayer = composition; pagLayer != nullptr; pagLayer = pagLayer->_parent) {
+    auto layerCache = pagLayer->layerCache;
+    if (pagLayer->layer->blendMode != BlendMode::Normal || pagLayer->layerOpacity != Opaque ||
+        !layerCache->transformStatic() || layerCache->getTransform(0)->opacity != Opaque) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool OcclusionCuller::GetOpaqueBounds(PAGLayer* pagLayer, Frame contentFrame, Rect* bounds) {
+  auto layer = pagLayer->layer;
+  if (!pagLayer->layerVisible || !layer->isActive || pagLayer->_trackMatteLayer != nullptr) {
+    return false;
+  }
+  if (layer->blendMode != BlendMode::Normal || !layer->masks.empty() || !layer->effects.empty() ||
+      !layer->layerStyles.empty() || layer->motionBlur) {
+    return false;
+  }
+  auto layerCache = pagLayer->layerCache;
+  if (!layerCache->contentVisible(contentFrame)) {
+    return false;
+  }
+  auto layerTransform = layerCache->getTransform(contentFrame);
+  if (OpacityConcat(layerTransform->opacity, pagLayer->layerOpacity) != Opaque) {
+    return false;
+  }
+  auto matrix = pagLayer->layerMatrix;
+  matrix.preConcat(layerTransform->matrix);
+  if (!HasScaleAndTranslateOnly(matrix) || !GetOpaqueContentBounds(pagLayer, bounds)) {
+    return false;
+  }
+  matrix.mapRect(bounds);
+  return true;
+}
+
+bool OcclusionCuller::GetOpaqueContentBounds(PAGLayer* pagLayer, Rect* bounds) {
+  switch (pagLayer->layerType()) {
+    case LayerType::Solid: {
+      auto solidLayer = static_cast<SolidLayer*>(pagLayer->layer);
+      bounds->setWH(static_cast<float>(solidLayer->width), static_cast<float>(solidLayer->height));
+      return true;
+    }
+    case LayerType::Image: {
+      if (pagLayer->contentModified()) {
+        return false;
+      }
+      auto imageBytes = static_cast<ImageLayer*>(pagLayer->layer)->imageBytes;
+      // JPEG has no alpha channel, and the images with transparent borders are never stripped
+      // when they are JPEG.
+      if (imageBytes == nullptr || !IsJPEG(imageBytes->fileBytes) || imageBytes->anchorX != 0 ||
+          imageBytes->anchorY != 0) {
+        return false;
+      }
+      auto image = ImageContentCache::GetImage(imageBytes);
+      if (image == nullptr) {
+        return false;
+      }
+      bounds->setWH(static_cast<float>(image->width()) / imageBytes->scaleFactor,
+                    static_cast<float>(image->height()) / imageBytes->scaleFactor);
+      return true;
+    }
+    case LayerType::PreCompose: {
+      auto composition = static_cast<PreComposeLayer*>(pagLayer->layer)->composition;
+      if (composition->type() != CompositionType::Video || pagLayer->stage == nullptr ||
+          !pagLayer->stage->videoEnabled()) {
+        return false;
+      }
+      auto& sequences = static_cast<VideoComposition*>(composition)->sequences;
+      if (sequences.empty()) {
+        return false;
+      }
+      for (auto sequence : sequences) {
+        if (sequence->alphaStartX != 0 || sequence->alphaStartY != 0) {
+          return false;
+        }
+      }
+      // The video frames are always drawn to fill the whole composition.
+      bounds->setWH(static_cast<float>(composition->width),
+                    static_cast<float>(composition->height));
+      auto pagComposition = static_cast<PAGComposition*>(pagLayer);
+      if (pagComposition->hasClip()) {
+        auto clipBounds = Rect::MakeWH(static_cast<float>(pagComposition->_width),
+                                       static_cast<float>(pagComposition->_height));
+        return bounds->intersect(clipBounds);
+      }
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+}  // namespace pag
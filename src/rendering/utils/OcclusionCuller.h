@@ -0,0 +1,64 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <vector>
+#include "pag/file.h"
+#include "pag/pag.h"
+
+namespace pag {
+/**
+ * OcclusionCuller finds out the child layers of a composition that are completely hidden by opaque
+ * layers above them. Only solid layers, JPEG images and video compositions without alpha channels
+ * are taken as opaque, and only when they are drawn as axis-aligned rectangles without masks,
+ * filters, track mattes or blend modes.
+ */
+class OcclusionCuller {
+ public:
+  /**
+   * Returns a flag for each child layer of the composition, which is true if the child layer is
+   * hidden by the opaque layers above it at the current frame. The matrix maps the composition to
+   * the pixels of the target surface. The alpha and the blend mode are the ones applied to each
+   * child layer by the parent layers, nothing is hidden unless they are Opaque and Normal.
+   */
+  static std::vector<bool> FindOccludedLayers(PAGComposition* composition, const Matrix& matrix,
+                                              Opacity alpha, Enum blendMode);
+
+  /**
+   * Returns true if the child layer stays opaque and covers the whole bounds of the composition
+   * during its visible time range, and the parent layers never make it translucent or blended.
+   */
+  static bool IsFullFrameOccluder(PAGComposition* composition, PAGLayer* childLayer);
+
+  /**
+   * Returns true if the visible time range of the occluder contains the one of the pagLayer. The
+   * two layers must be the children of the same composition.
+   */
+  static bool CoversTimeRange(PAGLayer* occluder, PAGLayer* pagLayer);
+
+ private:
+  /**
+   * Returns true if the composition and its parents never make the child layers translucent or
+   * blended.
+   */
+  static bool HasOpaqueParents(PAGComposition* composition);
+  static bool GetOpaqueBounds(PAGLayer* pagLayer, Frame contentFrame, Rect* bounds);
+  static bool GetOpaqueContentBounds(PAGLayer* pagLayer, Rect* bounds);
+};
+}  // namespace pag
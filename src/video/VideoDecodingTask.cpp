@@ -19,13 +19,14 @@
 #include "VideoDecodingTask.h"
 
 namespace pag {
-std::shared_ptr<Task> VideoDecodingTask::MakeAndRun(VideoReader* reader, int64_t targetTime) {
+std::shared_ptr<Task> VideoDecodingTask::MakeAndRun(VideoReader* reader, int64_t targetTime,
+                                                    TaskPriority priority) {
   if (reader == nullptr) {
     return nullptr;
   }
   auto task =
       Task::Make(std::unique_ptr<VideoDecodingTask>(new VideoDecodingTask(reader, targetTime)));
-  task->run();
+  task->run(priority);
   return task;
 }
 
@@ -24,7 +24,8 @@
 namespace pag {
 class VideoDecodingTask : public Executor {
  public:
-  static std::shared_ptr<Task> MakeAndRun(VideoReader* reader, int64_t targetTime);
+  static std::shared_ptr<Task> MakeAndRun(VideoReader* reader, int64_t targetTime,
+                                          TaskPriority priority);
 
  private:
   VideoReader* reader = nullptr;
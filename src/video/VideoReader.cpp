@@ -50,6 +50,19 @@ class GPUDecoderTask : public Executor {
   }
 };
 
+class DecoderReadyTask : public Executor {
+ public:
+  explicit DecoderReadyTask(VideoReader* reader) : reader(reader) {
+  }
+
+ private:
+  VideoReader* reader = nullptr;
+
+  void execute() override {
+    reader->gpuDecoderReady = true;
+  }
+};
+
 VideoReader::VideoReader(VideoConfig config, std::unique_ptr<MediaDemuxer> demuxer,
                          DecodingPolicy policy)
     : videoConfig(std::move(config)), demuxer(demuxer.release()) {
@@ -71,6 +84,9 @@ VideoReader::VideoReader(VideoConfig config, std::unique_ptr<MediaDemuxer> demux
       if (VideoDecoder::HasExternalSoftwareDecoder() && VideoDecoder::HasHardwareDecoder()) {
         decoderTypeIndex = DECODER_TYPE_SOFTWARE;
         gpuDecoderTask = GPUDecoderTask::MakeAndRun(videoConfig);
+        // Only marks the hardware decoder as ready, the decoders are always switched and driven
+        // on the thread calling readSample().
+        decoderReadyTask = gpuDecoderTask->then(std::make_unique<DecoderReadyTask>(this));
       }
       break;
     default:
@@ -79,6 +95,8 @@ VideoReader::VideoReader(VideoConfig config, std::unique_ptr<MediaDemuxer> demux
 }
 
 VideoReader::~VideoReader() {
+  // Cancel the continuation first, it may be marking the hardware decoder as ready.
+  decoderReadyTask = nullptr;
   destroyVideoDecoder();
   delete demuxer;
 }
@@ -213,7 +231,7 @@ bool VideoReader::onDecodeFrame(int64_t sampleTime) {
 }
 
 void VideoReader::tryMakeVideoDecoder() {
-  if (gpuDecoderTask && !gpuDecoderTask->isRunning()) {
+  if (gpuDecoderTask && gpuDecoderReady) {
     if (switchToGPUDecoderOfTask()) {
       return;
     }
@@ -256,6 +274,7 @@ bool VideoReader::switchToGPUDecoderOfTask() {
   auto executor = gpuDecoderTask->wait();
   videoDecoder = static_cast<GPUDecoderTask*>(executor)->getDecoder().release();
   gpuDecoderTask = nullptr;
+  decoderReadyTask = nullptr;
   if (videoDecoder) {
     decoderTypeIndex = DECODER_TYPE_HARDWARE;
     return true;
@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <atomic>
 #include "DecodingPolicy.h"
 #include "MediaDemuxer.h"
 #include "VideoDecoder.h"
@@ -48,6 +49,8 @@ class VideoReader {
   VideoConfig videoConfig = {};
   MediaDemuxer* demuxer = nullptr;
   std::shared_ptr<Task> gpuDecoderTask = nullptr;
+  std::shared_ptr<Task> decoderReadyTask = nullptr;
+  std::atomic_bool gpuDecoderReady = {false};
   VideoDecoder* videoDecoder = nullptr;
   int decoderTypeIndex = 0;
 
@@ -78,5 +81,7 @@ class VideoReader {
   bool renderFrame(int64_t sampleTime);
 
   VideoDecoder* makeDecoder();
+
+  friend class DecoderReadyTask;
 };
 }  // namespace pag
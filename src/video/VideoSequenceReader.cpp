@@ -61,7 +61,7 @@ void VideoSequenceReader::prepareAsync(Frame targetFrame) {
       pendingTime = targetTime;
     }
   } else {
-    lastTask = VideoDecodingTask::MakeAndRun(reader.get(), targetTime);
+    lastTask = VideoDecodingTask::MakeAndRun(reader.get(), targetTime, TaskPriority::Prefetch);
   }
 }
 
@@ -95,7 +95,10 @@ std::shared_ptr<Texture> VideoSequenceReader::readTexture(Frame targetFrame, Ren
         pendingTime = -1;
       }
       if (nextSampleTime != INT64_MAX) {
-        lastTask = VideoDecodingTask::MakeAndRun(reader.get(), nextSampleTime);
+        // The next frame is most likely to be read in the next flush, don't put it behind the
+        // look-ahead tasks.
+        lastTask =
+            VideoDecodingTask::MakeAndRun(reader.get(), nextSampleTime, TaskPriority::Urgent);
       }
     }
   }
@@ -0,0 +1,183 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include <thread>
+#include "base/keyframes/SingleEaseKeyframe.h"
+#include "framework/pag_test.h"
+
+namespace pag {
+static std::unique_ptr<AnimatableProperty<float>> MakeLinearProperty(int keyframeCount) {
+  std::vector<Keyframe<float>*> keyframes = {};
+  for (int i = 0; i < keyframeCount; i++) {
+    auto keyframe = new SingleEaseKeyframe<float>();
+    keyframe->startTime = i * 10;
+    keyframe->endTime = (i + 1) * 10;
+    keyframe->startValue = static_cast<float>(i * 100);
+    keyframe->endValue = static_cast<float>((i + 1) * 100);
+    keyframe->interpolationType = KeyframeInterpolationType::Linear;
+    keyframes.push_back(keyframe);
+  }
+  return std::make_unique<AnimatableProperty<float>>(keyframes);
+}
+
+static std::unique_ptr<AnimatableProperty<Color>> MakeBezierColorProperty() {
+  std::vector<Keyframe<Color>*> keyframes = {};
+  Color colors[] = {{0, 0, 0}, {255, 128, 0}, {255, 128, 0}, {10, 200, 255}, {90, 30, 60}};
+  Enum types[] = {KeyframeInterpolationType::Bezier, KeyframeInterpolationType::Linear,
+                  KeyframeInterpolationType::Hold, KeyframeInterpolationType::Bezier};
+  for (int i = 0; i < 4; i++) {
+    // Hold keyframes are decoded as plain keyframes.
+    auto keyframe = types[i] == KeyframeInterpolationType::Hold ? new Keyframe<Color>()
+                                                                 : new SingleEaseKeyframe<Color>();
+    keyframe->startTime = i * 30;
+    keyframe->endTime = (i + 1) * 30;
+    keyframe->startValue = colors[i];
+    keyframe->endValue = colors[i + 1];
+    keyframe->interpolationType = types[i];
+    keyframe->bezierOut.push_back(Point::Make(0.4f, 0.0f));
+    keyframe->bezierIn.push_back(Point::Make(0.2f, 1.0f));
+    keyframes.push_back(keyframe);
+  }
+  return std::make_unique<AnimatableProperty<Color>>(keyframes);
+}
+
+/**
+ * 用例描述: 随机访问、顺序访问和带游标访问关键帧得到的结果一致
+ */
+PAG_TEST(AnimatablePropertyTest, KeyframeLookup) {
+  auto property = MakeLinearProperty(50);
+  EXPECT_EQ(property->getValueAt(-5), 0.0f);
+  EXPECT_EQ(property->getValueAt(600), 5000.0f);
+  size_t cursor = 0;
+  for (Frame frame = -10; frame < 520; frame++) {
+    auto expected = frame <= 0 ? 0.0f : std::min(static_cast<float>(frame * 10), 5000.0f);
+    EXPECT_NEAR(property->getValueAt(frame), expected, 0.001f);
+    EXPECT_NEAR(property->getValueAt(frame, &cursor), expected, 0.001f);
+  }
+  for (Frame frame = 499; frame >= 0; frame -= 7) {
+    EXPECT_NEAR(property->getValueAt(frame, &cursor), static_cast<float>(frame * 10), 0.001f);
+  }
+}
+
+/**
+ * 用例描述: 多个线程同时在不同时间点读取同一个属性时结果正确
+ */
+PAG_TEST(AnimatablePropertyTest, ConcurrentLookup) {
+  auto property = MakeLinearProperty(200);
+  std::vector<std::thread> threads = {};
+  std::atomic_int errorCount = {0};
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([&property, &errorCount, i]() {
+      for (int round = 0; round < 100; round++) {
+        for (Frame frame = i; frame < 2000; frame += 4) {
+          if (std::abs(property->getValueAt(frame) - static_cast<float>(frame * 10)) > 0.001f) {
+            errorCount++;
+          }
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(errorCount, 0);
+}
+
+/**
+ * 用例描述: 烘焙后的属性取值与烘焙前一致，静止的关键帧不参与采样
+ */
+PAG_TEST(AnimatablePropertyTest, BakeProperty) {
+  auto property = MakeLinearProperty(20);
+  auto bakedProperty = MakeLinearProperty(20);
+  EXPECT_EQ(bakedProperty->bake(), 200 * sizeof(float) + 20 * sizeof(int64_t));
+  for (Frame frame = -5; frame < 210; frame++) {
+    EXPECT_EQ(bakedProperty->getValueAt(frame), property->getValueAt(frame));
+  }
+
+  auto colorProperty = MakeBezierColorProperty();
+  auto bakedColorProperty = MakeBezierColorProperty();
+  // The second keyframe keeps the same value and the third one holds, they are not sampled.
+  EXPECT_EQ(bakedColorProperty->bake(), 60 * 3 * sizeof(float) + 4 * sizeof(int64_t));
+  size_t cursor = 0;
+  for (Frame frame = -5; frame < 125; frame++) {
+    auto expected = colorProperty->getValueAt(frame);
+    EXPECT_TRUE(bakedColorProperty->getValueAt(frame) == expected);
+    EXPECT_TRUE(bakedColorProperty->getValueAt(frame, &cursor) == expected);
+  }
+}
+
+template <typename T>
+static void ExpectSameValues(Property<T>* property, Property<T>* bakedProperty, Frame duration) {
+  if (property == nullptr || bakedProperty == nullptr) {
+    EXPECT_EQ(property, bakedProperty);
+    return;
+  }
+  for (Frame frame = 0; frame < duration; frame++) {
+    EXPECT_TRUE(bakedProperty->getValueAt(frame) == property->getValueAt(frame));
+  }
+}
+
+/**
+ * 用例描述: 开启属性烘焙解码真实的 PAG 文件，各图层 Transform 和遮罩属性的取值与未烘焙时一致
+ */
+PAG_TEST(AnimatablePropertyTest, BakeFile) {
+  auto filePath = "../resources/apitest/complex_test.pag";
+  Codec::SetPropertyBakingEnabled(false);
+  auto file = File::Load(filePath);
+  Codec::SetPropertyBakingEnabled(true);
+  auto bakedFile = File::Load(filePath);
+  Codec::SetPropertyBakingEnabled(false);
+  ASSERT_NE(file, nullptr);
+  ASSERT_NE(bakedFile, nullptr);
+  EXPECT_EQ(file->bakedMemory(), 0);
+  EXPECT_GT(bakedFile->bakedMemory(), 0);
+  ASSERT_EQ(file->compositions.size(), bakedFile->compositions.size());
+  for (size_t i = 0; i < file->compositions.size(); i++) {
+    if (file->compositions[i]->type() != CompositionType::Vector) {
+      continue;
+    }
+    auto& layers = static_cast<VectorComposition*>(file->compositions[i])->layers;
+    auto& bakedLayers = static_cast<VectorComposition*>(bakedFile->compositions[i])->layers;
+    ASSERT_EQ(layers.size(), bakedLayers.size());
+    for (size_t j = 0; j < layers.size(); j++) {
+      auto layer = layers[j];
+      auto bakedLayer = bakedLayers[j];
+      auto duration = layer->startTime + layer->duration;
+      auto transform = layer->transform;
+      auto bakedTransform = bakedLayer->transform;
+      if (transform != nullptr && bakedTransform != nullptr) {
+        ExpectSameValues(transform->anchorPoint, bakedTransform->anchorPoint, duration);
+        ExpectSameValues(transform->position, bakedTransform->position, duration);
+        ExpectSameValues(transform->xPosition, bakedTransform->xPosition, duration);
+        ExpectSameValues(transform->yPosition, bakedTransform->yPosition, duration);
+        ExpectSameValues(transform->scale, bakedTransform->scale, duration);
+        ExpectSameValues(transform->rotation, bakedTransform->rotation, duration);
+        ExpectSameValues(transform->opacity, bakedTransform->opacity, duration);
+      }
+      ASSERT_EQ(layer->masks.size(), bakedLayer->masks.size());
+      for (size_t k = 0; k < layer->masks.size(); k++) {
+        auto mask = layer->masks[k];
+        auto bakedMask = bakedLayer->masks[k];
+        ExpectSameValues(mask->maskOpacity, bakedMask->maskOpacity, duration);
+        ExpectSameValues(mask->maskExpansion, bakedMask->maskExpansion, duration);
+      }
+    }
+  }
+}
+}  // namespace pag
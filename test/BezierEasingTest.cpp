@@ -0,0 +1,89 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "base/keyframes/MultiDimensionPointKeyframe.h"
+#include "base/keyframes/SingleEaseKeyframe.h"
+#include "base/utils/BezierEasing.h"
+#include "framework/pag_test.h"
+
+namespace pag {
+static const Point EasingControls[][2] = {
+    {{0.5f, 0.0f}, {0.5f, 1.0f}},     {{0.333f, 0.0f}, {0.667f, 1.0f}},
+    {{0.9f, 0.0f}, {0.1f, 1.0f}},     {{1.0f, 0.0f}, {0.0f, 1.0f}},
+    {{0.0f, 1.0f}, {1.0f, 0.0f}},     {{0.42f, 0.0f}, {1.0f, 1.0f}},
+    {{0.0f, 0.0f}, {0.58f, 1.0f}},    {{0.17f, 0.67f}, {0.83f, 0.67f}},
+    {{0.68f, -0.55f}, {0.265f, 1.55f}}};
+
+/**
+ * 用例描述: BezierEasing 单个求值和批量求值的结果与 BezierPath 逐点求解一致
+ */
+PAG_TEST(BezierEasingTest, BatchInterpolation) {
+  std::vector<float> inputs = {};
+  for (int i = -10; i <= 1010; i++) {
+    inputs.push_back(static_cast<float>(i) / 1000);
+  }
+  std::vector<float> outputs(inputs.size());
+  for (auto& controls : EasingControls) {
+    auto bezierPath =
+        BezierPath::Build(Point::Zero(), controls[0], controls[1], Point::Make(1, 1), 0.005f);
+    BezierEasing easing(controls[0], controls[1]);
+    easing.getInterpolations(inputs.data(), outputs.data(), inputs.size());
+    for (size_t i = 0; i < inputs.size(); i++) {
+      auto input = inputs[i];
+      auto expected = input <= 0 ? 0.0f : (input >= 1 ? 1.0f : bezierPath->getY(input));
+      EXPECT_NEAR(easing.getInterpolation(input), expected, 1e-6f);
+      EXPECT_NEAR(outputs[i], expected, 1e-6f);
+    }
+  }
+}
+
+/**
+ * 用例描述: 关键帧批量取值与逐帧取值的结果一致
+ */
+PAG_TEST(BezierEasingTest, KeyframeBatchValues) {
+  auto keyframe = std::make_unique<MultiDimensionPointKeyframe>();
+  keyframe->startTime = 10;
+  keyframe->endTime = 70;
+  keyframe->startValue = Point::Make(-20, 100);
+  keyframe->endValue = Point::Make(300, -50);
+  keyframe->interpolationType = KeyframeInterpolationType::Bezier;
+  keyframe->bezierOut = {EasingControls[2][0], EasingControls[8][0]};
+  keyframe->bezierIn = {EasingControls[2][1], EasingControls[8][1]};
+  keyframe->initialize();
+  std::vector<Point> points(60);
+  keyframe->getValuesAt(10, points.size(), points.data());
+  for (size_t i = 0; i < points.size(); i++) {
+    EXPECT_TRUE(points[i] == keyframe->getValueAt(10 + static_cast<Frame>(i)));
+  }
+
+  auto floatKeyframe = std::make_unique<SingleEaseKeyframe<float>>();
+  floatKeyframe->startTime = 0;
+  floatKeyframe->endTime = 45;
+  floatKeyframe->startValue = 1.0f;
+  floatKeyframe->endValue = 0.25f;
+  floatKeyframe->interpolationType = KeyframeInterpolationType::Bezier;
+  floatKeyframe->bezierOut = {EasingControls[0][0]};
+  floatKeyframe->bezierIn = {EasingControls[0][1]};
+  floatKeyframe->initialize();
+  std::vector<float> values(45);
+  floatKeyframe->getValuesAt(0, values.size(), values.data());
+  for (size_t i = 0; i < values.size(); i++) {
+    EXPECT_EQ(values[i], floatKeyframe->getValueAt(static_cast<Frame>(i)));
+  }
+}
+}  // namespace pag
@@ -0,0 +1,164 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "framework/pag_test.h"
+#include "pag/pag.h"
+#include "rendering/caches/FrameCache.h"
+
+namespace pag {
+/**
+ * Sets the frame cache limit for the current scope, and restores the previous one when it ends.
+ */
+class ScopedFrameCacheLimit {
+ public:
+  explicit ScopedFrameCacheLimit(size_t maxMemory) : previousLimit(FrameCacheMemory::Limit()) {
+    PAG::SetFrameCacheLimit(maxMemory);
+  }
+
+  ~ScopedFrameCacheLimit() {
+    PAG::SetFrameCacheLimit(previousLimit);
+  }
+
+ private:
+  size_t previousLimit = 0;
+};
+
+/**
+ * 用例描述: 超出内存上限后，帧缓存优先淘汰离播放位置最远的帧，并保留最近访问的帧
+ */
+PAG_TEST(FrameCacheTest, EvictFarthestFrames) {
+  ScopedFrameCacheLimit frameCacheLimit(1000);
+  FrameEntries<std::unique_ptr<int>> frames;
+  for (Frame frame = 0; frame <= 10; frame++) {
+    EXPECT_TRUE(frames.find(frame) == nullptr);
+    frames.insert(frame, std::make_unique<int>(static_cast<int>(frame)), 100);
+    EXPECT_LE(frames.memoryUsage(), 1000u);
+  }
+  // Playing forward, the frame behind the playhead is released first.
+  EXPECT_TRUE(frames.find(0) == nullptr);
+  frames.insert(0, std::make_unique<int>(0), 100);
+  EXPECT_EQ(frames.memoryUsage(), 1000u);
+  // After seeking back to the start, the frames at the end are released first, except the
+  // recently requested ones.
+  EXPECT_TRUE(frames.find(7) == nullptr);
+  auto entry = frames.find(10);
+  ASSERT_TRUE(entry != nullptr);
+  EXPECT_EQ(**entry, 10);
+  EXPECT_TRUE(frames.find(1) != nullptr);
+}
+
+/**
+ * 用例描述: 帧缓存的命中、未命中和淘汰次数统计到当前线程的计数器上
+ */
+PAG_TEST(FrameCacheTest, ThreadCounters) {
+  ScopedFrameCacheLimit frameCacheLimit(250);
+  auto base = FrameCacheMemory::ThreadCounters();
+  FrameEntries<std::unique_ptr<int>> frames;
+  for (Frame frame = 0; frame < 10; frame++) {
+    EXPECT_TRUE(frames.find(frame) == nullptr);
+    frames.insert(frame, std::make_unique<int>(static_cast<int>(frame)), 100);
+  }
+  // The recently requested frames are evicted too if the limit is still exceeded, except the
+  // playhead of the cache being filled.
+  EXPECT_TRUE(frames.find(9) != nullptr);
+  EXPECT_EQ(frames.memoryUsage(), 200u);
+  auto& counters = FrameCacheMemory::ThreadCounters();
+  EXPECT_EQ(counters.hits - base.hits, 1);
+  EXPECT_EQ(counters.misses - base.misses, 10);
+  EXPECT_EQ(counters.evictions - base.evictions, 8);
+  EXPECT_EQ(counters.allocatedBytes - base.allocatedBytes, 1000);
+  EXPECT_EQ(counters.evictedBytes - base.evictedBytes, 800);
+}
+
+/**
+ * 用例描述: 内存上限对所有帧缓存生效，最久未访问的帧缓存优先被淘汰
+ */
+PAG_TEST(FrameCacheTest, EvictAcrossCaches) {
+  ScopedFrameCacheLimit frameCacheLimit(1000);
+  std::mutex idleLocker = {};
+  FrameEntries<std::unique_ptr<int>> idleFrames(&idleLocker);
+  FrameEntries<std::unique_ptr<int>> activeFrames;
+  for (Frame frame = 0; frame < 5; frame++) {
+    idleFrames.find(frame);
+    idleFrames.insert(frame, std::make_unique<int>(static_cast<int>(frame)), 100);
+  }
+  for (Frame frame = 0; frame < 8; frame++) {
+    activeFrames.find(frame);
+    activeFrames.insert(frame, std::make_unique<int>(static_cast<int>(frame)), 100);
+  }
+  EXPECT_EQ(activeFrames.memoryUsage(), 800u);
+  EXPECT_EQ(idleFrames.memoryUsage(), 200u);
+}
+
+struct TrackedFrame {
+  explicit TrackedFrame(int* aliveCount) : aliveCount(aliveCount) {
+    (*aliveCount)++;
+  }
+
+  ~TrackedFrame() {
+    (*aliveCount)--;
+  }
+
+  int* aliveCount = nullptr;
+};
+
+class TrackedFrameCache : public FrameCache<TrackedFrame> {
+ public:
+  explicit TrackedFrameCache(int* aliveCount) : FrameCache(0, 100), aliveCount(aliveCount) {
+    // Every frame has different content.
+    staticTimeRanges.clear();
+  }
+
+ protected:
+  TrackedFrame* createCache(Frame) override {
+    return new TrackedFrame(aliveCount);
+  }
+
+  size_t memoryUsage(const TrackedFrame*) const override {
+    return 100;
+  }
+
+ private:
+  int* aliveCount = nullptr;
+};
+
+/**
+ * 用例描述: 在 FrameCachePass 结束之前，getCache() 返回的缓存即使被淘汰也不会被释放
+ */
+PAG_TEST(FrameCacheTest, PinDuringPass) {
+  ScopedFrameCacheLimit frameCacheLimit(300);
+  int aliveCount = 0;
+  TrackedFrameCache cache(&aliveCount);
+  {
+    FrameCachePass framePass = {};
+    auto first = cache.getCache(0);
+    for (Frame frame = 1; frame < 10; frame++) {
+      cache.getCache(frame);
+    }
+    // All frames are still alive, the evicted ones are released when the pass ends.
+    EXPECT_EQ(aliveCount, 10);
+    EXPECT_EQ(first->aliveCount, &aliveCount);
+  }
+  EXPECT_EQ(aliveCount, 3);
+  // Nothing is kept alive outside of a pass.
+  for (Frame frame = 10; frame < 20; frame++) {
+    cache.getCache(frame);
+  }
+  EXPECT_EQ(aliveCount, 3);
+}
+}  // namespace pag
@@ -0,0 +1,79 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "framework/pag_test.h"
+#include "gpu/opengl/GLConvexPathOp.h"
+
+namespace pag {
+/**
+ * 用例描述: 凸路径转换为三角形绘制，凹路径、多轮廓、过细或过尖的路径回退到遮罩绘制
+ */
+PAG_TEST(GLConvexPathOpTest, Make) {
+  Path oval = {};
+  oval.addOval(Rect::MakeWH(100, 60));
+  EXPECT_NE(GLConvexPathOp::Make(oval, Matrix::I()), nullptr);
+  EXPECT_NE(GLConvexPathOp::Make(oval, Matrix::MakeScale(3, -2)), nullptr);
+
+  Path triangle = {};
+  triangle.moveTo(0, 0);
+  triangle.lineTo(0, 100);
+  triangle.lineTo(100, 100);
+  triangle.close();
+  EXPECT_NE(GLConvexPathOp::Make(triangle, Matrix::I()), nullptr);
+  triangle.toggleInverseFillType();
+  EXPECT_EQ(GLConvexPathOp::Make(triangle, Matrix::I()), nullptr);
+
+  Path star = {};
+  star.moveTo(50, 0);
+  star.lineTo(61, 35);
+  star.lineTo(98, 35);
+  star.lineTo(68, 57);
+  star.lineTo(79, 91);
+  star.lineTo(50, 70);
+  star.lineTo(21, 91);
+  star.lineTo(32, 57);
+  star.lineTo(2, 35);
+  star.lineTo(39, 35);
+  star.close();
+  EXPECT_EQ(GLConvexPathOp::Make(star, Matrix::I()), nullptr);
+
+  Path twoOvals = oval;
+  twoOvals.addOval(Rect::MakeXYWH(200, 0, 100, 60));
+  EXPECT_EQ(GLConvexPathOp::Make(twoOvals, Matrix::I()), nullptr);
+
+  Path thin = {};
+  thin.moveTo(0, 0);
+  thin.lineTo(100, 0);
+  thin.lineTo(100, 0.5f);
+  thin.lineTo(0, 0.5f);
+  thin.close();
+  EXPECT_EQ(GLConvexPathOp::Make(thin, Matrix::I()), nullptr);
+  EXPECT_NE(GLConvexPathOp::Make(thin, Matrix::MakeScale(10)), nullptr);
+
+  Path sharp = {};
+  sharp.moveTo(0, 0);
+  sharp.lineTo(100, 5);
+  sharp.lineTo(0, 10);
+  sharp.close();
+  EXPECT_EQ(GLConvexPathOp::Make(sharp, Matrix::I()), nullptr);
+
+  GLConvexPathOp::SetEnabled(false);
+  EXPECT_EQ(GLConvexPathOp::Make(oval, Matrix::I()), nullptr);
+  GLConvexPathOp::SetEnabled(true);
+}
+}  // namespace pag
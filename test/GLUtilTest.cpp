@@ -19,7 +19,10 @@
 #include "framework/pag_test.h"
 #include "framework/utils/PAGTestUtils.h"
 #include "gpu/opengl/GLCaps.h"
+#include "gpu/opengl/GLContext.h"
+#include "gpu/opengl/GLProgramBinaryCache.h"
 #include "gpu/opengl/GLUtil.h"
+#include "platform/NativeGLDevice.h"
 
 namespace pag {
 PAG_TEST_SUIT(GLUtilTest)
@@ -121,6 +124,8 @@ PAG_TEST_F(GLUtilTest, Caps_ID82991749) {
     EXPECT_EQ(caps.getSampleCount(10, PixelConfig::RGBA_8888), 1);
     EXPECT_EQ(caps.getSampleCount(0, PixelConfig::RGBA_8888), 1);
     EXPECT_EQ(caps.getSampleCount(5, PixelConfig::ALPHA_8), 1);
+    // 驱动未提供任何二进制格式时不启用程序二进制缓存
+    EXPECT_FALSE(caps.programBinarySupport);
   }
   {
     ++i;
@@ -133,4 +138,40 @@ PAG_TEST_F(GLUtilTest, Caps_ID82991749) {
     }
   }
 }
+
+/**
+ * 用例描述: 链接后的程序二进制写入缓存目录，之后可直接从缓存加载，关闭缓存后不再加载
+ */
+PAG_TEST(GLUtilTest, ProgramBinaryCache) {
+  auto device = NativeGLDevice::Make();
+  ASSERT_TRUE(device != nullptr);
+  auto context = device->lockContext();
+  ASSERT_TRUE(context != nullptr);
+  auto gl = GLContext::Unwrap(context);
+  if (!gl->caps->programBinarySupport) {
+    device->unlock();
+    return;
+  }
+  std::string vertex = "#version 100\n"
+                       "attribute vec2 aPosition;\n"
+                       "void main() {\n"
+                       "  gl_Position = vec4(aPosition, 0.0, 1.0);\n"
+                       "}\n";
+  std::string fragment = "#version 100\n"
+                         "precision mediump float;\n"
+                         "void main() {\n"
+                         "  gl_FragColor = vec4(0.25, 0.5, 0.75, 1.0);\n"
+                         "}\n";
+  GLProgramBinaryCache::SetDirectory("../test/out");
+  EXPECT_EQ(GLProgramBinaryCache::LoadProgram(gl, vertex, fragment + "\n"), 0u);
+  auto program = CreateProgram(gl, vertex, fragment);
+  ASSERT_NE(program, 0u);
+  gl->deleteProgram(program);
+  program = GLProgramBinaryCache::LoadProgram(gl, vertex, fragment);
+  EXPECT_NE(program, 0u);
+  gl->deleteProgram(program);
+  GLProgramBinaryCache::SetDirectory("");
+  EXPECT_EQ(GLProgramBinaryCache::LoadProgram(gl, vertex, fragment), 0u);
+  device->unlock();
+}
 }  // namespace pag
@@ -0,0 +1,84 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "framework/pag_test.h"
+#include "gpu/Context.h"
+#include "gpu/GlyphAtlas.h"
+#include "platform/NativeGLDevice.h"
+
+namespace pag {
+/**
+ * 用例描述: 字形缓存到图集后，整像素平移命中缓存，亚像素偏移和旋转矩阵按规则处理
+ */
+PAG_TEST(GlyphAtlasTest, MaskGlyph) {
+  auto typeface = Typeface::MakeFromPath("../resources/font/NotoSansSC-Regular.otf");
+  ASSERT_TRUE(typeface != nullptr);
+  Font font(typeface, 20);
+  auto glyphID = typeface->getGlyphID("A");
+  ASSERT_TRUE(glyphID != 0);
+  EXPECT_TRUE(GlyphAtlas::CanUseAtlas(font, Matrix::MakeScale(2)));
+  EXPECT_FALSE(GlyphAtlas::CanUseAtlas(font, Matrix::MakeScale(2, 1)));
+  EXPECT_FALSE(GlyphAtlas::CanUseAtlas(font, Matrix::MakeScale(20)));
+  auto rotation = Matrix::I();
+  rotation.setRotate(30);
+  EXPECT_FALSE(GlyphAtlas::CanUseAtlas(font, rotation));
+
+  auto device = NativeGLDevice::Make();
+  ASSERT_TRUE(device != nullptr);
+  auto context = device->lockContext();
+  ASSERT_TRUE(context != nullptr);
+  auto glyphAtlas = context->getGlyphAtlas();
+  auto misses = glyphAtlas->getCounters().misses;
+  AtlasGlyph glyph = {};
+  ASSERT_TRUE(glyphAtlas->getMaskGlyph(font, glyphID, Point::Make(10, 10), Matrix::I(), &glyph));
+  EXPECT_TRUE(glyph.texture != nullptr);
+  EXPECT_FALSE(glyph.location.isEmpty());
+  EXPECT_EQ(glyphAtlas->getCounters().misses, misses + 1);
+  AtlasGlyph movedGlyph = {};
+  ASSERT_TRUE(
+      glyphAtlas->getMaskGlyph(font, glyphID, Point::Make(10, 10), Matrix::MakeTrans(35, 7),
+                               &movedGlyph));
+  EXPECT_EQ(glyphAtlas->getCounters().misses, misses + 1);
+  EXPECT_EQ(movedGlyph.location, glyph.location);
+  EXPECT_EQ(movedGlyph.matrix.getTranslateX(), glyph.matrix.getTranslateX() + 35);
+  EXPECT_EQ(movedGlyph.matrix.getTranslateY(), glyph.matrix.getTranslateY() + 7);
+  ASSERT_TRUE(
+      glyphAtlas->getMaskGlyph(font, glyphID, Point::Make(10.5f, 10), Matrix::I(), &movedGlyph));
+  EXPECT_EQ(glyphAtlas->getCounters().misses, misses + 2);
+  EXPECT_NE(movedGlyph.location, glyph.location);
+
+  auto emojiTypeface = Typeface::MakeFromPath("../resources/font/NotoColorEmoji.ttf");
+  ASSERT_TRUE(emojiTypeface != nullptr);
+  Font emojiFont(emojiTypeface, 30);
+  auto emojiID = emojiTypeface->getGlyphID("👻");
+  ASSERT_TRUE(emojiID != 0);
+  ASSERT_TRUE(glyphAtlas->getColorGlyph(emojiFont, emojiID, Matrix::I(), &glyph));
+  EXPECT_EQ(glyphAtlas->getCounters().misses, misses + 3);
+  ASSERT_TRUE(glyphAtlas->getColorGlyph(emojiFont, emojiID, rotation, &movedGlyph));
+  EXPECT_EQ(glyphAtlas->getCounters().misses, misses + 3);
+  EXPECT_EQ(movedGlyph.location, glyph.location);
+  // A smaller font drawn at twice the scale shares the glyph image, but keeps its own size.
+  Font smallEmojiFont(emojiTypeface, 15);
+  ASSERT_TRUE(
+      glyphAtlas->getColorGlyph(smallEmojiFont, emojiID, Matrix::MakeScale(2), &movedGlyph));
+  EXPECT_EQ(glyphAtlas->getCounters().misses, misses + 3);
+  EXPECT_EQ(movedGlyph.location, glyph.location);
+  EXPECT_FLOAT_EQ(movedGlyph.matrix.getScaleX(), glyph.matrix.getScaleX() * 0.5f);
+  device->unlock();
+}
+}  // namespace pag
@@ -16,6 +16,7 @@
 //
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include "TestUtils.h"
 #include "base/utils/TimeUtil.h"
 #include "framework/pag_test.h"
 #include "framework/utils/PAGTestUtils.h"
@@ -765,4 +766,49 @@ PAG_TEST_F(PAGFileBaseTest, SetStartTime) {
   EXPECT_EQ(setStartTimeMD5.get<std::string>(), md5);
 #endif
 }
+
+static std::unique_ptr<ByteData> EncodeFile(const std::string& filePath, bool mapFile) {
+  std::shared_ptr<File> file = nullptr;
+  if (mapFile) {
+    file = File::Load(filePath, true);
+  } else {
+    auto byteData = ByteData::FromPath(filePath);
+    if (byteData != nullptr) {
+      file = File::Load(byteData->data(), byteData->length(), filePath);
+    }
+  }
+  if (file == nullptr) {
+    return nullptr;
+  }
+  return Codec::Encode(file);
+}
+
+/**
+ * 用例描述: 开启并行解码后，分别通过拷贝和内存映射方式加载 resources 目录下的 PAG 文件，
+ * 重新编码的结果与串行解码一致
+ */
+PAG_TEST(PAGFileParallelDecodingTest, EncodeEqual) {
+  std::vector<std::string> files;
+  for (auto& directory : {"../resources/apitest", "../resources/smoke", "../resources/AE",
+                          "../resources/filter", "../resources/timestretch", "../resources/md5"}) {
+    GetAllPAGFiles(directory, files);
+  }
+  ASSERT_FALSE(files.empty());
+  for (auto& filePath : files) {
+    Codec::SetParallelDecodingEnabled(false);
+    auto serialBytes = EncodeFile(filePath, false);
+    if (serialBytes == nullptr) {
+      continue;
+    }
+    Codec::SetParallelDecodingEnabled(true);
+    for (auto mapFile : {false, true}) {
+      auto parallelBytes = EncodeFile(filePath, mapFile);
+      ASSERT_NE(parallelBytes, nullptr) << filePath;
+      ASSERT_EQ(parallelBytes->length(), serialBytes->length()) << filePath;
+      EXPECT_EQ(memcmp(parallelBytes->data(), serialBytes->data(), serialBytes->length()), 0)
+          << filePath;
+    }
+  }
+  Codec::SetParallelDecodingEnabled(false);
+}
 }  // namespace pag
@@ -18,13 +18,22 @@
 
 #ifdef PERFORMANCE_TEST
 
+#include <cmath>
 #include <fstream>
+#include <thread>
 #include <vector>
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#elif defined(__linux__)
+#include <unistd.h>
+#endif
 #include "TestUtils.h"
 #include "base/utils/GetTimer.h"
+#include "base/utils/Task.h"
 #include "base/utils/TimeUtil.h"
 #include "framework/pag_test.h"
 #include "framework/utils/PAGTestUtils.h"
+#include "gpu/opengl/GLConvexPathOp.h"
 #include "nlohmann/json.hpp"
 
 namespace pag {
@@ -151,5 +160,197 @@ PAG_TEST(PerformanceTest, TestRender) {
   outGraphicsFile << std::setw(4) << graphicsJson << std::endl;
   outGraphicsFile.close();
 }
+
+class BusyExecutor : public Executor {
+ private:
+  void execute() override {
+    volatile double value = 0;
+    for (int i = 0; i < 1000; i++) {
+      value = value + std::sqrt(static_cast<double>(i));
+    }
+  }
+};
+
+/**
+ * 用例描述: 测试不同线程数下 TaskGroup 的任务吞吐量，多个线程同时提交任务，模拟多个 PAGPlayer 并发解码。
+ */
+PAG_TEST(PerformanceTest, TaskGroupThroughput) {
+  const int producerCount = 8;
+  const int tasksPerProducer = 20000;
+  for (int threadCount : {1, 2, 4, 8, 16, 24, 32, 48, 64}) {
+    PAG::SetTaskExecutor(TaskExecutor::MakeThreadPool(threadCount));
+    auto startTime = GetTimer();
+    std::vector<std::thread> producers = {};
+    for (int i = 0; i < producerCount; i++) {
+      producers.emplace_back([i]() {
+        std::vector<std::shared_ptr<Task>> tasks = {};
+        for (int j = 0; j < tasksPerProducer; j++) {
+          auto task = Task::Make(std::make_unique<BusyExecutor>());
+          task->run((i + j) % 4 == 0 ? TaskPriority::Urgent : TaskPriority::Prefetch);
+          tasks.push_back(task);
+        }
+        for (auto& task : tasks) {
+          task->wait();
+        }
+      });
+    }
+    for (auto& producer : producers) {
+      producer.join();
+    }
+    auto costTime = GetTimer() - startTime;
+    PAG::SetTaskExecutor(nullptr);
+    auto throughput = static_cast<double>(producerCount * tasksPerProducer) * 1000.0 /
+                      static_cast<double>(costTime);
+    std::cout << "\n threads: " << threadCount << " costTime: " << costTime / 1000
+              << "ms throughput: " << throughput << " tasks/ms" << std::endl;
+  }
+}
+
+static int64_t GetResidentMemory() {
+#if defined(__APPLE__)
+  mach_task_basic_info info = {};
+  mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+  if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info),
+                &count) != KERN_SUCCESS) {
+    return 0;
+  }
+  return static_cast<int64_t>(info.resident_size);
+#elif defined(__linux__)
+  std::ifstream statm("/proc/self/statm");
+  int64_t totalPages = 0;
+  int64_t residentPages = 0;
+  statm >> totalPages >> residentPages;
+  return residentPages * sysconf(_SC_PAGESIZE);
+#else
+  return 0;
+#endif
+}
+
+/**
+ * 用例描述: 测试 resources 目录下的 PAG 文件分别通过拷贝和内存映射方式加载时的耗时和常驻内存增量。
+ */
+PAG_TEST(PerformanceTest, FileLoad) {
+  std::vector<std::string> files;
+  for (auto& directory : {"../resources/apitest", "../resources/smoke", "../resources/AE",
+                          "../resources/filter", "../resources/timestretch"}) {
+    GetAllPAGFiles(directory, files);
+  }
+  int64_t totalCopyTime = 0;
+  int64_t totalMapTime = 0;
+  for (auto& filePath : files) {
+    auto memoryBefore = GetResidentMemory();
+    auto startTime = GetTimer();
+    auto byteData = ByteData::FromPath(filePath);
+    if (byteData == nullptr) {
+      continue;
+    }
+    auto copiedFile = Codec::Decode(byteData->data(), byteData->length(), filePath);
+    auto copyTime = GetTimer() - startTime;
+    auto copyMemory = GetResidentMemory() - memoryBefore;
+    copiedFile = nullptr;
+    byteData = nullptr;
+
+    memoryBefore = GetResidentMemory();
+    startTime = GetTimer();
+    auto mappedFile = File::Load(filePath, true);
+    auto mapTime = GetTimer() - startTime;
+    auto mapMemory = GetResidentMemory() - memoryBefore;
+    mappedFile = nullptr;
+
+    totalCopyTime += copyTime;
+    totalMapTime += mapTime;
+    auto fileName = filePath.substr(filePath.rfind('/') + 1);
+    std::cout << "\n" << fileName << " copy: " << copyTime << "us " << copyMemory / 1024
+              << "KB, mmap: " << mapTime << "us " << mapMemory / 1024 << "KB" << std::endl;
+  }
+  std::cout << "\n total copy: " << totalCopyTime / 1000 << "ms, total mmap: "
+            << totalMapTime / 1000 << "ms" << std::endl;
+}
+
+/**
+ * 用例描述: 测试 resources 目录下多合成的 PAG 文件串行解码和并行解码的耗时。
+ */
+PAG_TEST(PerformanceTest, ParallelDecode) {
+  std::vector<std::string> files;
+  for (auto& directory : {"../resources/apitest", "../resources/smoke", "../resources/AE",
+                          "../resources/filter", "../resources/timestretch"}) {
+    GetAllPAGFiles(directory, files);
+  }
+  const int decodeTimes = 10;
+  int64_t totalSerialTime = 0;
+  int64_t totalParallelTime = 0;
+  for (auto& filePath : files) {
+    auto byteData = ByteData::FromPath(filePath);
+    if (byteData == nullptr) {
+      continue;
+    }
+    auto file = Codec::Decode(byteData->data(), byteData->length(), "");
+    if (file == nullptr || file->compositions.size() < 2) {
+      continue;
+    }
+    int64_t costTimes[2] = {0, 0};
+    for (int parallel = 0; parallel < 2; parallel++) {
+      Codec::SetParallelDecodingEnabled(parallel == 1);
+      auto startTime = GetTimer();
+      for (int i = 0; i < decodeTimes; i++) {
+        Codec::Decode(byteData->data(), byteData->length(), "");
+      }
+      costTimes[parallel] = (GetTimer() - startTime) / decodeTimes;
+    }
+    Codec::SetParallelDecodingEnabled(false);
+    totalSerialTime += costTimes[0];
+    totalParallelTime += costTimes[1];
+    auto fileName = filePath.substr(filePath.rfind('/') + 1);
+    std::cout << "\n" << fileName << " compositions: " << file->compositions.size()
+              << " serial: " << costTimes[0] << "us parallel: " << costTimes[1] << "us"
+              << std::endl;
+  }
+  std::cout << "\n total serial: " << totalSerialTime / 1000
+            << "ms, total parallel: " << totalParallelTime / 1000 << "ms" << std::endl;
+}
+
+/**
+ * 用例描述: 对比 smoke 目录下的 PAG 文件中的凸路径分别通过三角形和遮罩绘制时的平均帧耗时和遮罩生成次数，
+ * CI 上使用 SwiftShader 运行。
+ */
+PAG_TEST(PerformanceTest, ConvexPathRendering) {
+  std::vector<std::string> files;
+  GetAllPAGFiles("../resources/smoke", files);
+  int64_t totalTimes[2] = {0, 0};
+  for (auto& filePath : files) {
+    auto pagFile = PAGFile::Load(filePath);
+    if (pagFile == nullptr) {
+      continue;
+    }
+    Frame totalFrames = TimeToFrame(pagFile->duration(), pagFile->frameRate());
+    int64_t costTimes[2] = {0, 0};
+    int64_t maskCounts[2] = {0, 0};
+    for (int triangles = 0; triangles < 2; triangles++) {
+      GLConvexPathOp::SetEnabled(triangles == 1);
+      auto pagSurface = PAGSurface::MakeOffscreen(pagFile->width(), pagFile->height());
+      ASSERT_NE(pagSurface, nullptr);
+      auto pagPlayer = std::make_shared<PAGPlayer>();
+      pagPlayer->setSurface(pagSurface);
+      pagPlayer->setComposition(pagFile);
+      for (Frame frame = 0; frame < totalFrames; frame++) {
+        pagPlayer->setProgress((frame + 0.1) * 1.0 / totalFrames);
+        auto startTime = GetTimer();
+        pagPlayer->flush();
+        costTimes[triangles] += GetTimer() - startTime;
+        maskCounts[triangles] += pagPlayer->cacheStats().pathMasks.misses;
+      }
+      costTimes[triangles] /= std::max(totalFrames, static_cast<Frame>(1));
+    }
+    GLConvexPathOp::SetEnabled(true);
+    totalTimes[0] += costTimes[0];
+    totalTimes[1] += costTimes[1];
+    auto fileName = filePath.substr(filePath.rfind('/') + 1);
+    std::cout << "\n" << fileName << " masks: " << costTimes[0] << "us(" << maskCounts[0]
+              << " masks) triangles: " << costTimes[1] << "us(" << maskCounts[1] << " masks)"
+              << std::endl;
+  }
+  std::cout << "\n total masks: " << totalTimes[0] / 1000
+            << "ms, total triangles: " << totalTimes[1] / 1000 << "ms" << std::endl;
+}
 }  // namespace pag
 #endif
\ No newline at end of file
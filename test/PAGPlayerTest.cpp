@@ -18,7 +18,12 @@
 
 #include "framework/pag_test.h"
 #include "framework/utils/PAGTestUtils.h"
+#include "gpu/opengl/GLUtil.h"
 #include "nlohmann/json.hpp"
+#include "platform/NativeGLDevice.h"
+#include "rendering/Drawable.h"
+#include "rendering/caches/GraphicsMemoryManager.h"
+#include "rendering/caches/RenderCache.h"
 
 namespace pag {
 using nlohmann::json;
@@ -176,4 +181,354 @@ PAG_TEST_F(PAGPlayerTest, autoClear) {
   PAGTestEnvironment::DumpJson["PAGPlayerAutoClearTest"] = outputJson;
 }
 
+/**
+ * 用例描述: 连续绘制同一张图片的多个图层时合并为一次 draw call
+ */
+PAG_TEST(PAGPlayerTest, drawCallBatching) {
+  auto pagImage = PAGImage::FromPath("../resources/apitest/imageReplacement.png");
+  ASSERT_TRUE(pagImage != nullptr);
+  auto composition = PAGComposition::Make(400, 400);
+  for (int i = 0; i < 16; i++) {
+    auto imageLayer = PAGImageLayer::Make(100, 100, 1000000);
+    ASSERT_TRUE(imageLayer != nullptr);
+    imageLayer->replaceImage(pagImage);
+    imageLayer->setMatrix(Matrix::MakeTrans(static_cast<float>(i % 4 * 100),
+                                            static_cast<float>(i / 4 * 100)));
+    composition->addLayer(imageLayer);
+  }
+  auto pagSurface = PAGSurface::MakeOffscreen(400, 400);
+  ASSERT_TRUE(pagSurface != nullptr);
+  auto pagPlayer = std::make_shared<PAGPlayer>();
+  pagPlayer->setSurface(pagSurface);
+  pagPlayer->setComposition(composition);
+  ASSERT_TRUE(pagPlayer->flush());
+  EXPECT_GT(pagPlayer->drawCallCount(), 0);
+  EXPECT_GT(pagPlayer->mergedDrawCount(), 0);
+  EXPECT_LT(pagPlayer->drawCallCount(), 16);
+}
+
+/**
+ * 用例描述: 播放前预热滤镜程序，首次绘制时不再创建滤镜
+ */
+PAG_TEST(PAGPlayerTest, prewarm) {
+  auto pagFile = PAGFile::Load("../resources/filter/DropShadow.pag");
+  ASSERT_TRUE(pagFile != nullptr);
+  auto pagPlayer = std::make_shared<PAGPlayer>();
+  EXPECT_FALSE(pagPlayer->prewarm(pagFile));
+  auto pagSurface = PAGSurface::MakeOffscreen(pagFile->width(), pagFile->height());
+  ASSERT_TRUE(pagSurface != nullptr);
+  pagPlayer->setSurface(pagSurface);
+  ASSERT_TRUE(pagPlayer->prewarm(pagFile));
+  EXPECT_GT(pagPlayer->cacheStats().filters.misses, 0);
+  pagPlayer->setComposition(pagFile);
+  ASSERT_TRUE(pagPlayer->flush());
+  // The statistics are reset at the beginning of every flush.
+  EXPECT_EQ(pagPlayer->cacheStats().filters.misses, 0);
+  EXPECT_GT(pagPlayer->cacheStats().filters.hits, 0);
+}
+
+/**
+ * 用例描述: 预热后未设置到 PAGPlayer 的 composition，其滤镜在下一次 flush 时被释放
+ */
+PAG_TEST(PAGPlayerTest, prewarmUnused) {
+  auto pagFile = PAGFile::Load("../resources/filter/DropShadow.pag");
+  ASSERT_TRUE(pagFile != nullptr);
+  auto pagSurface = PAGSurface::MakeOffscreen(pagFile->width(), pagFile->height());
+  ASSERT_TRUE(pagSurface != nullptr);
+  auto pagPlayer = std::make_shared<PAGPlayer>();
+  pagPlayer->setSurface(pagSurface);
+  pagPlayer->setComposition(PAGComposition::Make(pagFile->width(), pagFile->height()));
+  ASSERT_TRUE(pagPlayer->prewarm(pagFile));
+  EXPECT_FALSE(pagPlayer->renderCache->filterCaches.empty());
+  ASSERT_TRUE(pagPlayer->flush());
+  EXPECT_TRUE(pagPlayer->renderCache->filterCaches.empty());
+  EXPECT_GT(pagPlayer->cacheStats().filters.evictions, 0);
+}
+
+/**
+ * 用例描述: 局部重绘的结果与全量重绘一致，且只重绘发生变化的区域
+ */
+PAG_TEST(PAGPlayerTest, partialRedraw) {
+  auto pagFile = PAGFile::Load("../resources/apitest/test.pag");
+  ASSERT_TRUE(pagFile != nullptr);
+  auto pagSurface = PAGSurface::MakeOffscreen(pagFile->width(), pagFile->height());
+  ASSERT_TRUE(pagSurface != nullptr);
+  auto pagPlayer = std::make_shared<PAGPlayer>();
+  pagPlayer->setSurface(pagSurface);
+  pagPlayer->setComposition(pagFile);
+  pagPlayer->setPartialRedraw(true);
+  auto fullFile = PAGFile::Load("../resources/apitest/test.pag");
+  auto fullSurface = PAGSurface::MakeOffscreen(fullFile->width(), fullFile->height());
+  ASSERT_TRUE(fullSurface != nullptr);
+  auto fullPlayer = std::make_shared<PAGPlayer>();
+  fullPlayer->setSurface(fullSurface);
+  fullPlayer->setComposition(fullFile);
+  auto surfaceBounds = Rect::MakeWH(static_cast<float>(pagSurface->width()),
+                                    static_cast<float>(pagSurface->height()));
+  ASSERT_TRUE(pagPlayer->flush());
+  EXPECT_TRUE(pagPlayer->damageRect() == surfaceBounds);
+  for (int i = 0; i < 30; i++) {
+    pagPlayer->nextFrame();
+    fullPlayer->nextFrame();
+    pagPlayer->flush();
+    fullPlayer->flush();
+    EXPECT_EQ(DumpMD5(pagSurface), DumpMD5(fullSurface));
+  }
+
+  auto pagImage = PAGImage::FromPath("../resources/apitest/imageReplacement.png");
+  ASSERT_TRUE(pagImage != nullptr);
+  auto composition = PAGComposition::Make(400, 400);
+  auto background = PAGImageLayer::Make(400, 400, 1000000);
+  background->replaceImage(pagImage);
+  composition->addLayer(background);
+  auto sticker = PAGImageLayer::Make(50, 50, 1000000);
+  sticker->replaceImage(pagImage);
+  composition->addLayer(sticker);
+  auto stickerSurface = PAGSurface::MakeOffscreen(400, 400);
+  ASSERT_TRUE(stickerSurface != nullptr);
+  pagPlayer->setSurface(stickerSurface);
+  pagPlayer->setComposition(composition);
+  ASSERT_TRUE(pagPlayer->flush());
+  sticker->setMatrix(Matrix::MakeTrans(100, 100));
+  ASSERT_TRUE(pagPlayer->flush());
+  auto damageRect = pagPlayer->damageRect();
+  EXPECT_FALSE(damageRect.isEmpty());
+  EXPECT_LE(damageRect.width(), 150);
+  EXPECT_LE(damageRect.height(), 150);
+  EXPECT_FALSE(pagPlayer->flush());
+  EXPECT_TRUE(pagPlayer->damageRect().isEmpty());
+}
+
+/**
+ * 用例描述: 被上方不透明图层完全遮挡的图层不参与绘制
+ */
+PAG_TEST(PAGPlayerTest, occlusionCulling) {
+  auto pagImage = PAGImage::FromPath("../resources/apitest/imageReplacement.png");
+  ASSERT_TRUE(pagImage != nullptr);
+  auto composition = PAGComposition::Make(400, 400);
+  auto background = PAGImageLayer::Make(400, 400, 1000000);
+  background->replaceImage(pagImage);
+  composition->addLayer(background);
+  auto solidLayer = PAGSolidLayer::Make(1000000, 400, 400, Red);
+  composition->addLayer(solidLayer);
+  auto pagSurface = PAGSurface::MakeOffscreen(400, 400);
+  ASSERT_TRUE(pagSurface != nullptr);
+  auto pagPlayer = std::make_shared<PAGPlayer>();
+  pagPlayer->setSurface(pagSurface);
+  pagPlayer->setComposition(composition);
+  ASSERT_TRUE(pagPlayer->flush());
+  EXPECT_EQ(pagPlayer->culledLayerCount(), 1);
+  auto culledMD5 = DumpMD5(pagSurface);
+
+  solidLayer->setOpacity(128);
+  ASSERT_TRUE(pagPlayer->flush());
+  EXPECT_EQ(pagPlayer->culledLayerCount(), 0);
+
+  solidLayer->setOpacity(255);
+  solidLayer->setMatrix(Matrix::MakeTrans(10, 10));
+  ASSERT_TRUE(pagPlayer->flush());
+  EXPECT_EQ(pagPlayer->culledLayerCount(), 0);
+
+  solidLayer->setMatrix(Matrix::I());
+  ASSERT_TRUE(pagPlayer->flush());
+  EXPECT_EQ(pagPlayer->culledLayerCount(), 1);
+  EXPECT_EQ(DumpMD5(pagSurface), culledMD5);
+
+  auto solidSurface = PAGSurface::MakeOffscreen(400, 400);
+  ASSERT_TRUE(solidSurface != nullptr);
+  auto solidPlayer = std::make_shared<PAGPlayer>();
+  solidPlayer->setSurface(solidSurface);
+  auto solidComposition = PAGComposition::Make(400, 400);
+  solidComposition->addLayer(PAGSolidLayer::Make(1000000, 400, 400, Red));
+  solidPlayer->setComposition(solidComposition);
+  ASSERT_TRUE(solidPlayer->flush());
+  EXPECT_EQ(DumpMD5(solidSurface), culledMD5);
+}
+
+/**
+ * 用例描述: 父级 composition 半透明或带混合模式时，子图层逐个叠加，下方图层不能被剔除
+ */
+PAG_TEST(PAGPlayerTest, occlusionCullingTranslucentParent) {
+  auto pagImage = PAGImage::FromPath("../resources/apitest/imageReplacement.png");
+  ASSERT_TRUE(pagImage != nullptr);
+  auto parent = PAGComposition::Make(400, 400);
+  auto background = PAGImageLayer::Make(400, 400, 1000000);
+  background->replaceImage(pagImage);
+  parent->addLayer(background);
+  parent->addLayer(PAGSolidLayer::Make(1000000, 400, 400, Red));
+  parent->setOpacity(128);
+  auto composition = PAGComposition::Make(400, 400);
+  composition->addLayer(parent);
+  auto pagSurface = PAGSurface::MakeOffscreen(400, 400);
+  ASSERT_TRUE(pagSurface != nullptr);
+  auto pagPlayer = std::make_shared<PAGPlayer>();
+  pagPlayer->setSurface(pagSurface);
+  pagPlayer->setComposition(composition);
+  ASSERT_TRUE(pagPlayer->flush());
+  EXPECT_EQ(pagPlayer->culledLayerCount(), 0);
+  auto translucentMD5 = DumpMD5(pagSurface);
+
+  parent->setOpacity(255);
+  ASSERT_TRUE(pagPlayer->flush());
+  EXPECT_EQ(pagPlayer->culledLayerCount(), 1);
+  EXPECT_NE(DumpMD5(pagSurface), translucentMD5);
+
+  parent->setOpacity(128);
+  ASSERT_TRUE(pagPlayer->flush());
+  EXPECT_EQ(pagPlayer->culledLayerCount(), 0);
+  EXPECT_EQ(DumpMD5(pagSurface), translucentMD5);
+}
+
+/**
+ * 用例描述: 同一设备上开启共享缓存的两个 PAGPlayer 共用同一张 Snapshot 纹理，显存只统计一次
+ */
+PAG_TEST(PAGPlayerTest, sharedCache) {
+  auto pagImage = PAGImage::FromPath("../resources/apitest/imageReplacement.png");
+  ASSERT_TRUE(pagImage != nullptr);
+  auto device = NativeGLDevice::Make();
+  auto context = device->lockContext();
+  ASSERT_TRUE(context != nullptr);
+  auto gl = GLContext::Unwrap(context);
+  GLTextureInfo textureInfo;
+  CreateTexture(gl, 400, 400, &textureInfo);
+  GLTextureInfo textureInfo2;
+  CreateTexture(gl, 400, 400, &textureInfo2);
+  device->unlock();
+  std::vector<std::shared_ptr<PAGPlayer>> players = {};
+  for (auto& info : {textureInfo, textureInfo2}) {
+    auto drawable = std::make_shared<TextureDrawable>(device, BackendTexture(info, 400, 400),
+                                                      ImageOrigin::TopLeft);
+    auto pagSurface = PAGSurface::MakeFrom(drawable);
+    ASSERT_TRUE(pagSurface != nullptr);
+    auto composition = PAGComposition::Make(400, 400);
+    auto imageLayer = PAGImageLayer::Make(400, 400, 1000000);
+    imageLayer->replaceImage(pagImage);
+    composition->addLayer(imageLayer);
+    auto pagPlayer = std::make_shared<PAGPlayer>();
+    pagPlayer->setSharedCacheEnabled(true);
+    pagPlayer->setSurface(pagSurface);
+    pagPlayer->setComposition(composition);
+    players.push_back(pagPlayer);
+  }
+  ASSERT_TRUE(players[0]->flush());
+  auto snapshot = players[0]->renderCache->getSnapshot(pagImage->uniqueID());
+  ASSERT_TRUE(snapshot != nullptr);
+  auto snapshotMemory = snapshot->memoryUsage();
+  auto totalMemory = PAG::GraphicsMemory();
+  ASSERT_TRUE(players[1]->flush());
+  auto sharedSnapshot = players[1]->renderCache->getSnapshot(pagImage->uniqueID());
+  ASSERT_TRUE(sharedSnapshot != nullptr);
+  EXPECT_EQ(sharedSnapshot->getTexture(), snapshot->getTexture());
+  EXPECT_LT(PAG::GraphicsMemory(), totalMemory + snapshotMemory);
+  EXPECT_EQ(DumpMD5(players[0]->getSurface()), DumpMD5(players[1]->getSurface()));
+
+  players[0] = nullptr;
+  ASSERT_TRUE(players[1]->flush());
+  EXPECT_GE(PAG::GraphicsMemory(), snapshotMemory);
+  players[1] = nullptr;
+
+  context = device->lockContext();
+  ASSERT_TRUE(context != nullptr);
+  gl = GLContext::Unwrap(context);
+  gl->deleteTextures(1, &textureInfo.id);
+  gl->deleteTextures(1, &textureInfo2.id);
+  device->unlock();
+}
+
+/**
+ * 用例描述: 缩放值在同一个 √2 分档内变化时复用 Snapshot，跨过分档边界时重新光栅化
+ */
+PAG_TEST(PAGPlayerTest, snapshotScaleBucket) {
+  auto pagImage = PAGImage::FromPath("../resources/apitest/imageReplacement.png");
+  ASSERT_TRUE(pagImage != nullptr);
+  auto composition = PAGComposition::Make(400, 400);
+  auto imageLayer = PAGImageLayer::Make(400, 400, 1000000);
+  imageLayer->replaceImage(pagImage);
+  composition->addLayer(imageLayer);
+  auto pagSurface = PAGSurface::MakeOffscreen(400, 400);
+  ASSERT_TRUE(pagSurface != nullptr);
+  auto pagPlayer = std::make_shared<PAGPlayer>();
+  pagPlayer->setSurface(pagSurface);
+  pagPlayer->setComposition(composition);
+  auto layerScale = 0.2f;
+  imageLayer->setMatrix(Matrix::MakeScale(layerScale));
+  ASSERT_TRUE(pagPlayer->flush());
+  // Images are never cached at a scale larger than 1.0, keeps the scale below it.
+  auto maxScale = pagPlayer->stage->getAssetMaxScale(pagImage->uniqueID());
+  ASSERT_GT(maxScale, 0.0f);
+  ASSERT_LT(maxScale, 0.5f);
+  auto snapshot = pagPlayer->renderCache->getSnapshot(pagImage->uniqueID());
+  ASSERT_TRUE(snapshot != nullptr);
+  auto texture = snapshot->getTexture();
+  auto bucketScale = snapshot->scaleFactor();
+  EXPECT_GE(bucketScale, maxScale);
+  EXPECT_LT(bucketScale, maxScale * 1.5f);
+  // Scales the content up to the top of its bucket.
+  layerScale *= bucketScale / maxScale;
+  imageLayer->setMatrix(Matrix::MakeScale(layerScale * 0.99f));
+  ASSERT_TRUE(pagPlayer->flush());
+  snapshot = pagPlayer->renderCache->getSnapshot(pagImage->uniqueID());
+  ASSERT_TRUE(snapshot != nullptr);
+  EXPECT_EQ(snapshot->getTexture(), texture);
+  // Scales the content down a little, the larger snapshot is still sharp enough.
+  imageLayer->setMatrix(Matrix::MakeScale(layerScale * 0.8f));
+  ASSERT_TRUE(pagPlayer->flush());
+  snapshot = pagPlayer->renderCache->getSnapshot(pagImage->uniqueID());
+  ASSERT_TRUE(snapshot != nullptr);
+  EXPECT_EQ(snapshot->getTexture(), texture);
+  EXPECT_EQ(pagPlayer->renderCache->snapshotRescalingCount, 0);
+  // Crosses the upper boundary of the bucket.
+  imageLayer->setMatrix(Matrix::MakeScale(layerScale * 1.2f));
+  ASSERT_TRUE(pagPlayer->flush());
+  snapshot = pagPlayer->renderCache->getSnapshot(pagImage->uniqueID());
+  ASSERT_TRUE(snapshot != nullptr);
+  EXPECT_NE(snapshot->getTexture(), texture);
+  EXPECT_NEAR(snapshot->scaleFactor(), bucketScale * sqrtf(2.0f), 0.001f);
+  EXPECT_EQ(pagPlayer->renderCache->snapshotRescalingCount, 1);
+  // Goes back to the previous bucket, the larger snapshot is reused for a few frames only.
+  imageLayer->setMatrix(Matrix::MakeScale(layerScale * 0.9f));
+  ASSERT_TRUE(pagPlayer->flush());
+  snapshot = pagPlayer->renderCache->getSnapshot(pagImage->uniqueID());
+  ASSERT_TRUE(snapshot != nullptr);
+  EXPECT_NEAR(snapshot->scaleFactor(), bucketScale * sqrtf(2.0f), 0.001f);
+  for (int i = 0; i < 10; i++) {
+    imageLayer->setMatrix(Matrix::MakeScale(layerScale * (i % 2 == 0 ? 0.85f : 0.9f)));
+    ASSERT_TRUE(pagPlayer->flush());
+  }
+  snapshot = pagPlayer->renderCache->getSnapshot(pagImage->uniqueID());
+  ASSERT_TRUE(snapshot != nullptr);
+  EXPECT_NEAR(snapshot->scaleFactor(), bucketScale, 0.001f);
+}
+
+/**
+ * 用例描述: 显存超出上限后，最久未使用的 PAGPlayer 在下一次点击测试时释放缓存，总显存回到上限以内
+ */
+PAG_TEST(PAGPlayerTest, purgeIdlePlayer) {
+  auto previousMaxMemory = GraphicsMemoryManager::MaxMemory();
+  auto makePlayer = [](std::shared_ptr<PAGFile> pagFile) {
+    auto pagPlayer = std::make_shared<PAGPlayer>();
+    pagPlayer->setSurface(PAGSurface::MakeOffscreen(pagFile->width(), pagFile->height()));
+    pagPlayer->setComposition(pagFile);
+    return pagPlayer;
+  };
+  auto idleFile = PAGFile::Load("../resources/apitest/test.pag");
+  auto activeFile = PAGFile::Load("../resources/apitest/test.pag");
+  ASSERT_TRUE(idleFile != nullptr && activeFile != nullptr);
+  auto idlePlayer = makePlayer(idleFile);
+  auto activePlayer = makePlayer(activeFile);
+  ASSERT_TRUE(idlePlayer->flush());
+  ASSERT_TRUE(activePlayer->flush());
+  auto idleMemory = static_cast<size_t>(idlePlayer->graphicsMemory());
+  auto activeMemory = activePlayer->graphicsMemory();
+  ASSERT_GT(idleMemory, 0u);
+  auto maxMemory = PAG::GraphicsMemory() - idleMemory / 2;
+  PAG::SetMaxGraphicsMemory(maxMemory);
+  // The purge request goes to the player that has been idle the longest.
+  activePlayer->hitTestPoint(activeFile, 0, 0, true);
+  EXPECT_EQ(activePlayer->graphicsMemory(), activeMemory);
+  idlePlayer->hitTestPoint(idleFile, 0, 0, true);
+  EXPECT_LT(static_cast<size_t>(idlePlayer->graphicsMemory()), idleMemory);
+  EXPECT_LE(PAG::GraphicsMemory(), maxMemory);
+  PAG::SetMaxGraphicsMemory(previousMaxMemory);
+}
 }  // namespace pag
\ No newline at end of file
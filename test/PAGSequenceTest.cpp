@@ -16,6 +16,7 @@
 //
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include <cstring>
 #include "framework/pag_test.h"
 #include "framework/utils/PAGTestUtils.h"
 #include "pag/pag.h"
@@ -98,4 +99,85 @@ PAG_TEST_F(PAGSequenceTest, VideoSequenceAsMask_ID83191791) {
   EXPECT_EQ(compareMD5.get<std::string>(), md5);
 #endif
 }
+
+static bool SameBytes(ByteData* a, ByteData* b) {
+  if (a == nullptr || b == nullptr) {
+    return a == b;
+  }
+  return a->length() == b->length() && memcmp(a->data(), b->data(), a->length()) == 0;
+}
+
+static void CompareSequences(Sequence* lazy, Sequence* eager, CompositionType type) {
+  ASSERT_EQ(lazy->duration(), eager->duration());
+  EXPECT_EQ(lazy->width, eager->width);
+  EXPECT_EQ(lazy->height, eager->height);
+  if (type == CompositionType::Video) {
+    auto lazySequence = static_cast<VideoSequence*>(lazy);
+    auto eagerSequence = static_cast<VideoSequence*>(eager);
+    ASSERT_EQ(lazySequence->headers.size(), eagerSequence->headers.size());
+    for (size_t i = 0; i < lazySequence->headers.size(); i++) {
+      EXPECT_TRUE(SameBytes(lazySequence->headers[i], eagerSequence->headers[i]));
+    }
+    ASSERT_EQ(lazySequence->frames.size(), eagerSequence->frames.size());
+    for (size_t i = 0; i < lazySequence->frames.size(); i++) {
+      auto lazyFrame = lazySequence->frames[i];
+      auto eagerFrame = eagerSequence->frames[i];
+      EXPECT_EQ(lazyFrame->isKeyframe, eagerFrame->isKeyframe);
+      EXPECT_EQ(lazyFrame->frame, eagerFrame->frame);
+      EXPECT_TRUE(SameBytes(lazyFrame->fileBytes, eagerFrame->fileBytes));
+    }
+  } else {
+    auto lazySequence = static_cast<BitmapSequence*>(lazy);
+    auto eagerSequence = static_cast<BitmapSequence*>(eager);
+    ASSERT_EQ(lazySequence->frames.size(), eagerSequence->frames.size());
+    for (size_t i = 0; i < lazySequence->frames.size(); i++) {
+      auto lazyFrame = lazySequence->frames[i];
+      auto eagerFrame = eagerSequence->frames[i];
+      EXPECT_EQ(lazyFrame->isKeyframe, eagerFrame->isKeyframe);
+      ASSERT_EQ(lazyFrame->bitmaps.size(), eagerFrame->bitmaps.size());
+      for (size_t j = 0; j < lazyFrame->bitmaps.size(); j++) {
+        EXPECT_EQ(lazyFrame->bitmaps[j]->x, eagerFrame->bitmaps[j]->x);
+        EXPECT_EQ(lazyFrame->bitmaps[j]->y, eagerFrame->bitmaps[j]->y);
+        EXPECT_TRUE(
+            SameBytes(lazyFrame->bitmaps[j]->fileBytes, eagerFrame->bitmaps[j]->fileBytes));
+      }
+    }
+  }
+}
+
+/**
+ * 用例描述: 延迟解码的序列帧在调用 decodeFrames() 之前能通过校验，解码后与立即解码的结果一致
+ */
+PAG_TEST_F(PAGSequenceTest, LazyDecoding) {
+  for (auto& path : {"../resources/apitest/video_sequence_test.pag",
+                     "../resources/apitest/bitmap_sequence_test.pag"}) {
+    auto byteData = ByteData::FromPath(path);
+    ASSERT_TRUE(byteData != nullptr);
+    auto eagerFile =
+        Codec::Decode(byteData->data(), static_cast<uint32_t>(byteData->length()), path);
+    auto lazyFile = Codec::Decode(ByteData::FromPath(path), path);
+    ASSERT_TRUE(eagerFile != nullptr);
+    ASSERT_TRUE(lazyFile != nullptr);
+    ASSERT_EQ(lazyFile->compositions.size(), eagerFile->compositions.size());
+    int sequenceCount = 0;
+    for (size_t i = 0; i < lazyFile->compositions.size(); i++) {
+      auto type = lazyFile->compositions[i]->type();
+      auto lazySequence = Sequence::Get(lazyFile->compositions[i]);
+      auto eagerSequence = Sequence::Get(eagerFile->compositions[i]);
+      if (lazySequence == nullptr) {
+        continue;
+      }
+      ASSERT_TRUE(eagerSequence != nullptr);
+      EXPECT_TRUE(lazySequence->framesDeferred());
+      EXPECT_FALSE(eagerSequence->framesDeferred());
+      EXPECT_TRUE(lazySequence->verify());
+      lazySequence->decodeFrames();
+      EXPECT_FALSE(lazySequence->framesDeferred());
+      EXPECT_TRUE(lazySequence->verify());
+      CompareSequences(lazySequence, eagerSequence, type);
+      sequenceCount++;
+    }
+    EXPECT_GT(sequenceCount, 0);
+  }
+}
 }  // namespace pag
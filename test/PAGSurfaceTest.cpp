@@ -122,4 +122,87 @@ PAG_TEST(PAGSurfaceTest, mask_ID85767971) {
   gl->deleteTextures(1, &textureInfo.id);
   device->unlock();
 }
+
+/**
+ * 用例描述: 异步读取的像素与同步读取的一致，且按调用顺序回调
+ */
+PAG_TEST(PAGSurfaceTest, readPixelsAsync) {
+  auto pagFile = PAGFile::Load("../resources/apitest/test.pag");
+  ASSERT_TRUE(pagFile != nullptr);
+  auto width = pagFile->width();
+  auto height = pagFile->height();
+  auto device = NativeGLDevice::Make();
+  auto context = device->lockContext();
+  ASSERT_TRUE(context != nullptr);
+  auto gl = GLContext::Unwrap(context);
+  GLTextureInfo textureInfo;
+  CreateTexture(gl, width, height, &textureInfo);
+  auto backendTexture = BackendTexture(textureInfo, width, height);
+  auto pagSurface = PAGSurface::MakeFrom(backendTexture, ImageOrigin::BottomLeft);
+  device->unlock();
+  ASSERT_TRUE(pagSurface != nullptr);
+
+  auto pagPlayer = std::make_shared<PAGPlayer>();
+  pagPlayer->setSurface(pagSurface);
+  pagPlayer->setComposition(pagFile);
+  auto rowBytes = static_cast<size_t>(width) * 4;
+  std::vector<std::vector<uint8_t>> expectedPixels = {};
+  std::vector<std::vector<uint8_t>> asyncPixels = {};
+  std::vector<int64_t> frames = {};
+  auto callback = [&](int64_t frame, const void* pixels, size_t pixelRowBytes) {
+    frames.push_back(frame);
+    auto data = static_cast<const uint8_t*>(pixels);
+    EXPECT_TRUE(data != nullptr);
+    EXPECT_EQ(pixelRowBytes, rowBytes);
+    asyncPixels.emplace_back(data, data + rowBytes * height);
+  };
+  for (int64_t i = 0; i < 10; i++) {
+    pagPlayer->setProgress(static_cast<double>(i) / 10);
+    pagPlayer->flush();
+    std::vector<uint8_t> pixels(rowBytes * height);
+    ASSERT_TRUE(pagSurface->readPixels(ColorType::RGBA_8888, AlphaType::Premultiplied,
+                                       pixels.data(), rowBytes));
+    expectedPixels.push_back(std::move(pixels));
+    ASSERT_TRUE(
+        pagSurface->readPixelsAsync(i, ColorType::RGBA_8888, AlphaType::Premultiplied, callback));
+  }
+  pagSurface->finishReadPixels();
+  ASSERT_EQ(frames.size(), expectedPixels.size());
+  for (size_t i = 0; i < frames.size(); i++) {
+    EXPECT_EQ(frames[i], static_cast<int64_t>(i));
+    EXPECT_TRUE(asyncPixels[i] == expectedPixels[i]);
+  }
+
+  context = device->lockContext();
+  ASSERT_TRUE(context != nullptr);
+  gl = GLContext::Unwrap(context);
+  gl->deleteTextures(1, &textureInfo.id);
+  device->unlock();
+}
+
+/**
+ * 用例描述: PAGSurface 析构时仍在等待的异步读取也会回调
+ */
+PAG_TEST(PAGSurfaceTest, readPixelsAsyncOnDestroy) {
+  auto pagFile = PAGFile::Load("../resources/apitest/test.pag");
+  ASSERT_TRUE(pagFile != nullptr);
+  auto pagSurface = PAGSurface::MakeOffscreen(pagFile->width(), pagFile->height());
+  ASSERT_TRUE(pagSurface != nullptr);
+  auto pagPlayer = std::make_shared<PAGPlayer>();
+  pagPlayer->setSurface(pagSurface);
+  pagPlayer->setComposition(pagFile);
+  std::vector<int64_t> frames = {};
+  auto callback = [&](int64_t frame, const void*, size_t) { frames.push_back(frame); };
+  for (int64_t i = 0; i < 2; i++) {
+    pagPlayer->setProgress(static_cast<double>(i) / 10);
+    pagPlayer->flush();
+    ASSERT_TRUE(
+        pagSurface->readPixelsAsync(i, ColorType::RGBA_8888, AlphaType::Premultiplied, callback));
+  }
+  pagPlayer->setSurface(nullptr);
+  pagSurface = nullptr;
+  ASSERT_EQ(frames.size(), 2u);
+  EXPECT_EQ(frames[0], 0);
+  EXPECT_EQ(frames[1], 1);
+}
 }  // namespace pag
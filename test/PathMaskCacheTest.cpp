@@ -0,0 +1,131 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+#include "framework/pag_test.h"
+#include "gpu/Context.h"
+#include "gpu/PathMaskCache.h"
+#include "gpu/Surface.h"
+#include "platform/NativeGLDevice.h"
+
+namespace pag {
+static Path MakeStar() {
+  Path star = {};
+  star.moveTo(50, 0);
+  star.lineTo(61, 35);
+  star.lineTo(98, 35);
+  star.lineTo(68, 57);
+  star.lineTo(79, 91);
+  star.lineTo(50, 70);
+  star.lineTo(21, 91);
+  star.lineTo(32, 57);
+  star.lineTo(2, 35);
+  star.lineTo(39, 35);
+  star.close();
+  return star;
+}
+
+/**
+ * 用例描述: 路径遮罩按路径和矩阵缓存，相同的路径和矩阵命中缓存，路径或矩阵变化时重新光栅化
+ */
+PAG_TEST(PathMaskCacheTest, HitAndMiss) {
+  auto device = NativeGLDevice::Make();
+  ASSERT_TRUE(device != nullptr);
+  auto context = device->lockContext();
+  ASSERT_TRUE(context != nullptr);
+  auto star = MakeStar();
+  auto counters = context->pathMaskCounters();
+  auto mask = context->getPathMask(star, Matrix::I(), 100, 100);
+  ASSERT_TRUE(mask != nullptr);
+  EXPECT_EQ(context->pathMaskCounters().misses, counters.misses + 1);
+  EXPECT_EQ(context->pathMaskCounters().hits, counters.hits);
+  // A copy of the path shares the same geometry.
+  auto copy = star;
+  EXPECT_EQ(context->getPathMask(copy, Matrix::I(), 100, 100), mask);
+  EXPECT_EQ(context->pathMaskCounters().misses, counters.misses + 1);
+  EXPECT_EQ(context->pathMaskCounters().hits, counters.hits + 1);
+  // The same geometry built again is a different path.
+  auto newStar = MakeStar();
+  EXPECT_NE(context->getPathMask(newStar, Matrix::I(), 100, 100), mask);
+  EXPECT_EQ(context->pathMaskCounters().misses, counters.misses + 2);
+  // Another matrix or mask size rasterizes a new mask.
+  EXPECT_NE(context->getPathMask(star, Matrix::MakeScale(2), 200, 200), mask);
+  EXPECT_EQ(context->pathMaskCounters().misses, counters.misses + 3);
+  EXPECT_NE(context->getPathMask(star, Matrix::I(), 120, 100), mask);
+  EXPECT_EQ(context->pathMaskCounters().misses, counters.misses + 4);
+  // Modifying a copy does not change the cached path.
+  copy.lineTo(0, 0);
+  EXPECT_NE(context->getPathMask(copy, Matrix::I(), 100, 100), mask);
+  EXPECT_EQ(context->pathMaskCounters().misses, counters.misses + 5);
+  EXPECT_EQ(context->getPathMask(star, Matrix::I(), 100, 100), mask);
+  EXPECT_EQ(context->pathMaskCounters().hits, counters.hits + 2);
+  device->unlock();
+}
+
+/**
+ * 用例描述: 提前光栅化的路径遮罩在第一帧绘制时被取用，第二帧直接命中缓存；凸路径提前构建的三角形绘制也会被取用
+ */
+PAG_TEST(PathMaskCacheTest, PreparedMasks) {
+  auto device = NativeGLDevice::Make();
+  ASSERT_TRUE(device != nullptr);
+  auto context = device->lockContext();
+  ASSERT_TRUE(context != nullptr);
+  auto surface = Surface::Make(context, 200, 200);
+  ASSERT_TRUE(surface != nullptr);
+  auto canvas = surface->getCanvas();
+  auto matrix = Matrix::MakeTrans(20, 30);
+  canvas->setMatrix(matrix);
+  auto star = MakeStar();
+  auto pendingMask = PendingPathMask::Make(star, matrix);
+  ASSERT_TRUE(pendingMask != nullptr);
+  pendingMask->run();
+  EXPECT_TRUE(pendingMask->task != nullptr);
+  EXPECT_TRUE(pendingMask->convexOp == nullptr);
+  context->addPendingPathMask(pendingMask);
+  auto counters = context->pathMaskCounters();
+  canvas->drawPath(star, Black);
+  canvas->flush();
+  EXPECT_EQ(context->pathMaskCounters().misses, counters.misses + 1);
+  EXPECT_TRUE(context->pathMaskCache->pendingMasks.empty());
+  // The mask prepared in the first frame is cached for the second frame.
+  canvas->drawPath(star, Black);
+  canvas->flush();
+  EXPECT_EQ(context->pathMaskCounters().misses, counters.misses + 1);
+  EXPECT_EQ(context->pathMaskCounters().hits, counters.hits + 1);
+
+  Path hexagon = {};
+  hexagon.moveTo(40, 0);
+  hexagon.lineTo(80, 20);
+  hexagon.lineTo(80, 60);
+  hexagon.lineTo(40, 80);
+  hexagon.lineTo(0, 60);
+  hexagon.lineTo(0, 20);
+  hexagon.close();
+  auto convexMask = PendingPathMask::Make(hexagon, matrix);
+  ASSERT_TRUE(convexMask != nullptr);
+  convexMask->run();
+  EXPECT_TRUE(convexMask->task == nullptr);
+  EXPECT_TRUE(convexMask->convexOp != nullptr);
+  context->addPendingPathMask(convexMask);
+  EXPECT_FALSE(context->pathMaskCache->pendingMasks.empty());
+  canvas->drawPath(hexagon, Black);
+  canvas->flush();
+  EXPECT_TRUE(convexMask->convexOp == nullptr);
+  EXPECT_TRUE(context->pathMaskCache->pendingMasks.empty());
+  EXPECT_EQ(context->pathMaskCounters().misses, counters.misses + 1);
+  device->unlock();
+}
+}  // namespace pag
@@ -0,0 +1,78 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "framework/pag_test.h"
+#include "rendering/caches/PrefetchScheduler.h"
+
+namespace pag {
+/**
+ * 用例描述: 预测解码的提前量根据素材的实际耗时调整，并限制未取用的预测解码内存
+ */
+PAG_TEST(PrefetchSchedulerTest, AdaptiveLeadTime) {
+  PrefetchScheduler scheduler = {};
+  scheduler.beginFrame(0, 0);
+  // Assets without any record start 500ms in advance, as before.
+  EXPECT_GE(scheduler.lookAheadTime(), 500000);
+  EXPECT_TRUE(scheduler.shouldPrefetch(1, 400000, 1024));
+  // A cheap asset starts much later.
+  scheduler.recordCost(2, 10000);
+  scheduler.beginFrame(0, 0);
+  EXPECT_FALSE(scheduler.shouldPrefetch(2, 400000, 1024));
+  EXPECT_TRUE(scheduler.shouldPrefetch(2, 40000, 1024));
+  // An expensive asset starts earlier.
+  scheduler.recordCost(3, 600000);
+  scheduler.beginFrame(0, 0);
+  EXPECT_GE(scheduler.lookAheadTime(), 1200000);
+  EXPECT_TRUE(scheduler.shouldPrefetch(3, 1000000, 1024));
+  // The prefetch memory is capped until the previous prefetches are consumed.
+  EXPECT_FALSE(scheduler.shouldPrefetch(4, 0, 64 * 1024 * 1024));
+  scheduler.finishPrefetch(1);
+  scheduler.finishPrefetch(2);
+  scheduler.finishPrefetch(3);
+  EXPECT_TRUE(scheduler.shouldPrefetch(4, 0, 64 * 1024 * 1024));
+  // Sequences that become visible soon do not wait for the hardware decoders.
+  EXPECT_TRUE(scheduler.needsSoftwareDecoding(50000));
+  EXPECT_FALSE(scheduler.needsSoftwareDecoding(200000));
+}
+
+/**
+ * 用例描述: 命中预测解码的素材不会拉低学习到的耗时，已移除素材的耗时不再影响预测范围
+ */
+PAG_TEST(PrefetchSchedulerTest, PrunedCosts) {
+  PrefetchScheduler scheduler = {};
+  scheduler.beginFrame(0, 0);
+  auto defaultLookAhead = scheduler.lookAheadTime();
+  scheduler.recordCost(1, 600000);
+  scheduler.beginFrame(0, 0);
+  auto lookAhead = scheduler.lookAheadTime();
+  EXPECT_GT(lookAhead, defaultLookAhead);
+  // The asset is ready when it becomes visible, reading it costs almost nothing.
+  for (int i = 0; i < 30; i++) {
+    scheduler.markPrefetched(1);
+    scheduler.recordCost(1, 100);
+    scheduler.beginFrame(0, 0);
+  }
+  EXPECT_EQ(scheduler.lookAheadTime(), lookAhead);
+  EXPECT_TRUE(scheduler.shouldPrefetch(1, 1000000, 1024));
+  // The costs of the removed assets are forgotten.
+  scheduler.removeAsset(1);
+  scheduler.beginFrame(0, 0);
+  EXPECT_EQ(scheduler.lookAheadTime(), defaultLookAhead);
+  EXPECT_TRUE(scheduler.shouldPrefetch(2, 0, 64 * 1024 * 1024));
+}
+}  // namespace pag
@@ -0,0 +1,179 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include "base/utils/Task.h"
+#include "framework/pag_test.h"
+
+namespace pag {
+class CountingExecutor : public Executor {
+ public:
+  explicit CountingExecutor(std::atomic_int* counter) : counter(counter) {
+  }
+
+ private:
+  std::atomic_int* counter = nullptr;
+
+  void execute() override {
+    (*counter)++;
+  }
+};
+
+class OrderExecutor : public Executor {
+ public:
+  OrderExecutor(std::mutex* locker, std::vector<int>* order, int id)
+      : locker(locker), order(order), id(id) {
+  }
+
+ private:
+  std::mutex* locker = nullptr;
+  std::vector<int>* order = nullptr;
+  int id = 0;
+
+  void execute() override {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    std::lock_guard<std::mutex> autoLock(*locker);
+    order->push_back(id);
+  }
+};
+
+/**
+ * 用例描述: 使用同步的 TaskExecutor 时，任务在 run() 内立即执行完成
+ */
+PAG_TEST(TaskExecutorTest, Inline) {
+  PAG::SetTaskExecutor(TaskExecutor::MakeInline());
+  std::atomic_int counter = {0};
+  auto task = Task::Make(std::make_unique<CountingExecutor>(&counter));
+  task->run();
+  EXPECT_FALSE(task->isRunning());
+  EXPECT_EQ(counter, 1);
+  task->run(TaskPriority::Urgent);
+  EXPECT_EQ(counter, 2);
+  PAG::SetTaskExecutor(nullptr);
+}
+
+/**
+ * 用例描述: 使用内置限定线程数的 TaskExecutor 时，所有任务都能执行完成，取消的任务不会被执行
+ */
+PAG_TEST(TaskExecutorTest, ThreadPool) {
+  PAG::SetTaskExecutor(TaskExecutor::MakeThreadPool(2));
+  std::atomic_int counter = {0};
+  std::vector<std::shared_ptr<Task>> tasks = {};
+  for (int i = 0; i < 100; i++) {
+    auto task = Task::Make(std::make_unique<CountingExecutor>(&counter));
+    task->run(i % 2 == 0 ? TaskPriority::Prefetch : TaskPriority::Urgent);
+    tasks.push_back(task);
+  }
+  for (auto& task : tasks) {
+    task->wait();
+    EXPECT_FALSE(task->isRunning());
+  }
+  EXPECT_EQ(counter, 100);
+  PAG::SetTaskExecutor(nullptr);
+}
+
+/**
+ * 用例描述: 销毁内置线程池时，队列中剩余的任务仍然会被执行且只执行一次，在工作线程上释放线程池不会死锁
+ */
+PAG_TEST(TaskExecutorTest, ThreadPoolDestroy) {
+  std::atomic_int counter = {0};
+  auto executor = TaskExecutor::MakeThreadPool(2);
+  for (int i = 0; i < 1000; i++) {
+    executor->execute([&counter]() { counter++; }, i % 2 == 0);
+  }
+  executor = nullptr;
+  EXPECT_EQ(counter, 1000);
+
+  counter = 0;
+  executor = TaskExecutor::MakeThreadPool(2);
+  std::weak_ptr<TaskExecutor> weakExecutor = executor;
+  for (int i = 0; i < 100; i++) {
+    executor->execute([&counter]() { counter++; }, false);
+  }
+  // The job keeps the last reference of the thread pool, which is released on the worker thread.
+  executor->execute([executor, &counter]() { counter++; }, false);
+  executor = nullptr;
+  // The jobs left in the queues are executed by the destructor after the last reference is gone.
+  for (int i = 0; i < 5000 && (!weakExecutor.expired() || counter < 101); i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_TRUE(weakExecutor.expired());
+  EXPECT_EQ(counter, 101);
+}
+
+/**
+ * 用例描述: 通过 MakeAfter() 和 then() 创建的任务总是在所有依赖的任务执行完之后才执行
+ */
+PAG_TEST(TaskExecutorTest, MakeAfter) {
+  PAG::SetTaskExecutor(TaskExecutor::MakeThreadPool(4));
+  std::mutex locker = {};
+  std::vector<int> order = {};
+  auto first = Task::Make(std::make_unique<OrderExecutor>(&locker, &order, 1));
+  auto second = Task::Make(std::make_unique<OrderExecutor>(&locker, &order, 2));
+  first->run();
+  second->run();
+  auto third = Task::MakeAfter({first, second},
+                               std::make_unique<OrderExecutor>(&locker, &order, 3));
+  auto fourth = third->then(std::make_unique<OrderExecutor>(&locker, &order, 4));
+  fourth->wait();
+  EXPECT_FALSE(first->isRunning());
+  EXPECT_FALSE(second->isRunning());
+  EXPECT_FALSE(third->isRunning());
+  ASSERT_EQ(order.size(), 4u);
+  EXPECT_EQ(order[2], 3);
+  EXPECT_EQ(order[3], 4);
+
+  // The dependency has finished before the continuation is added.
+  std::atomic_int counter = {0};
+  auto finished = Task::Make(std::make_unique<CountingExecutor>(&counter));
+  finished->run();
+  finished->wait();
+  auto next = finished->then(std::make_unique<CountingExecutor>(&counter), TaskPriority::Urgent);
+  next->wait();
+  EXPECT_FALSE(next->isRunning());
+  EXPECT_EQ(counter, 2);
+  PAG::SetTaskExecutor(nullptr);
+}
+
+/**
+ * 用例描述: 取消一个任务时，依赖它的任务也会被取消且不会被执行
+ */
+PAG_TEST(TaskExecutorTest, CancelDependencies) {
+  auto executor = TaskExecutor::MakeThreadPool(1);
+  PAG::SetTaskExecutor(executor);
+  std::atomic_int counter = {0};
+  // Keeps the only worker busy, so the parent stays in the queue until it is cancelled.
+  std::mutex blocker = {};
+  std::unique_lock<std::mutex> blockLock(blocker);
+  executor->execute([&blocker]() { std::lock_guard<std::mutex> autoLock(blocker); }, true);
+  auto parent = Task::Make(std::make_unique<CountingExecutor>(&counter));
+  parent->run();
+  auto child = parent->then(std::make_unique<CountingExecutor>(&counter));
+  auto grandChild = Task::MakeAfter({child}, std::make_unique<CountingExecutor>(&counter));
+  EXPECT_TRUE(child->isRunning());
+  parent->cancel();
+  blockLock.unlock();
+  EXPECT_FALSE(parent->isRunning());
+  EXPECT_FALSE(child->isRunning());
+  EXPECT_FALSE(grandChild->isRunning());
+  grandChild->wait();
+  EXPECT_EQ(counter, 0);
+  PAG::SetTaskExecutor(nullptr);
+}
+}  // namespace pag
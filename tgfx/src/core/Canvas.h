@@ -119,6 +119,12 @@ class Canvas {
    */
   virtual void clear() = 0;
 
+  /**
+   * Replacing the pixels inside the rect with transparent color. The rect is in device coordinates
+   * and is rounded out to pixel boundaries. The clip and matrix are ignored.
+   */
+  virtual void clearRect(const Rect& rect) = 0;
+
   /**
    * Draws a Texture, with its top-left corner at (0, 0), using a mask texture and current alpha,
    * blend mode, clip and matrix. The mask texture has the same position and size with the texture.
@@ -17,10 +17,13 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "Context.h"
+#include "GlyphAtlas.h"
 #include "GradientCache.h"
+#include "PathMaskCache.h"
 #include "Program.h"
 #include "Resource.h"
 #include "base/utils/GetTimer.h"
+#include "gpu/opengl/GLConvexPathOp.h"
 
 namespace pag {
 #define MAX_PROGRAM_COUNT 128
@@ -42,6 +45,8 @@ class PurgeGuard {
 
 Context::Context() {
   gradientCache = new GradientCache(this);
+  pathMaskCache = new PathMaskCache(this);
+  glyphAtlas = new GlyphAtlas(this);
 }
 
 Context::~Context() {
@@ -52,7 +57,11 @@ Context::~Context() {
   DEBUG_ASSERT(recycledResources.empty());
   DEBUG_ASSERT(programMap.empty());
   DEBUG_ASSERT(gradientCache->empty())
+  DEBUG_ASSERT(pathMaskCache->empty())
+  DEBUG_ASSERT(glyphAtlas->empty())
   delete gradientCache;
+  delete pathMaskCache;
+  delete glyphAtlas;
 }
 
 Device* Context::getDevice() const {
@@ -95,6 +104,8 @@ void Context::purgeResourcesNotUsedIn(int64_t usNotUsed) {
       if (currentTime - resource->lastUsedTime < usNotUsed) {
         needToRecycle.push_back(resource);
       } else {
+        _resourceCounters.evictions++;
+        _recycledResourceMemory -= resource->memoryUsage();
         resource->onRelease(this);
         delete resource;
       }
@@ -110,6 +121,12 @@ void Context::releaseAll(bool releaseGPU) {
   if (gradientCache) {
     gradientCache->releaseAll();
   }
+  if (pathMaskCache) {
+    pathMaskCache->releaseAll();
+  }
+  if (glyphAtlas) {
+    glyphAtlas->releaseAll();
+  }
   PurgeGuard guard(this);
   for (auto& resource : nonpurgeableResources) {
     if (releaseGPU) {
@@ -131,6 +148,7 @@ void Context::releaseAll(bool releaseGPU) {
     }
   }
   recycledResources.clear();
+  _recycledResourceMemory = 0;
 }
 
 Program* Context::getProgram(const ProgramCreator* programMaker) {
@@ -138,10 +156,12 @@ Program* Context::getProgram(const ProgramCreator* programMaker) {
   programMaker->computeUniqueKey(this, &uniqueKey);
   auto result = programMap.find(uniqueKey);
   if (result != programMap.end()) {
+    _programCounters.hits++;
     programLRU.remove(result->second);
     programLRU.push_front(result->second);
     return result->second;
   }
+  _programCounters.misses++;
   // TODO(domrjchen): createProgram() 应该统计到 programCompilingTime 里。
   auto program = programMaker->createProgram(this).release();
   if (program == nullptr) {
@@ -151,6 +171,7 @@ Program* Context::getProgram(const ProgramCreator* programMaker) {
   programLRU.push_front(program);
   programMap[uniqueKey] = program;
   while (programLRU.size() > MAX_PROGRAM_COUNT) {
+    _programCounters.evictions++;
     removeOldestProgram();
   }
   return program;
@@ -160,14 +181,54 @@ const Texture* Context::getGradient(const Color4f* colors, const float* position
   return gradientCache->getGradient(colors, positions, count);
 }
 
+const CacheCounters& Context::gradientCounters() const {
+  return gradientCache->getCounters();
+}
+
+std::shared_ptr<Texture> Context::getPathMask(const Path& path, const Matrix& matrix, int width,
+                                              int height) {
+  return pathMaskCache->getMask(path, matrix, width, height);
+}
+
+std::unique_ptr<GLConvexPathOp> Context::takeConvexPathOp(const Path& path, const Matrix& matrix,
+                                                          int width, int height) {
+  return pathMaskCache->takeConvexOp(path, matrix, width, height);
+}
+
+void Context::addPendingPathMask(std::shared_ptr<PendingPathMask> pendingMask) {
+  pathMaskCache->addPendingMask(std::move(pendingMask));
+}
+
+void Context::clearPendingPathMasks() {
+  pathMaskCache->clearPendingMasks();
+}
+
+const CacheCounters& Context::pathMaskCounters() const {
+  return pathMaskCache->getCounters();
+}
+
+const CacheCounters& Context::glyphCounters() const {
+  return glyphAtlas->getCounters();
+}
+
+void Context::recordDrawCall(size_t drawCount) {
+  _drawCallCount++;
+  if (drawCount > 1) {
+    _mergedDrawCount += static_cast<int64_t>(drawCount - 1);
+  }
+}
+
 std::shared_ptr<Resource> Context::getRecycledResource(const BytesKey& resourceKey) {
   auto result = recycledResources.find(resourceKey);
   if (result == recycledResources.end()) {
+    _resourceCounters.misses++;
     return nullptr;
   }
+  _resourceCounters.hits++;
   auto& list = result->second;
   auto resource = list.back();
   list.pop_back();
+  _recycledResourceMemory -= resource->memoryUsage();
   if (list.empty()) {
     recycledResources.erase(result);
   }
@@ -222,6 +283,7 @@ void Context::removeResource(Resource* resource) {
   RemoveFromList(nonpurgeableResources, resource);
   if (resource->recycleKey.isValid()) {
     resource->lastUsedTime = GetTimer();
+    _recycledResourceMemory += resource->memoryUsage();
     recycledResources[resource->recycleKey].push_back(resource);
   } else {
     purgingResource = true;
@@ -26,6 +26,7 @@
 #include "base/utils/UniqueID.h"
 #include "gpu/Device.h"
 #include "pag/gpu.h"
+#include "pag/types.h"
 
 namespace pag {
 
@@ -39,6 +40,16 @@ class ProgramCreator;
 
 class GradientCache;
 
+class PathMaskCache;
+
+class GlyphAtlas;
+
+class PendingPathMask;
+
+class GLConvexPathOp;
+
+class Path;
+
 class Context {
  public:
   virtual ~Context();
@@ -62,11 +73,101 @@ class Context {
    */
   std::shared_ptr<Resource> getRecycledResource(const BytesKey& recycleKey);
 
+  /**
+   * Returns the counters of the program cache, accumulated since this context was created. A miss
+   * means a program was compiled.
+   */
+  const CacheCounters& programCounters() const {
+    return _programCounters;
+  }
+
+  /**
+   * Returns the counters of the recycled resources, accumulated since this context was created.
+   */
+  const CacheCounters& resourceCounters() const {
+    return _resourceCounters;
+  }
+
+  /**
+   * Returns the counters of the gradient textures, accumulated since this context was created.
+   */
+  const CacheCounters& gradientCounters() const;
+
+  /**
+   * Returns a cached mask texture of the specified size, which has the path filled with the
+   * matrix. A new mask is rasterized if there is no cache available.
+   */
+  std::shared_ptr<Texture> getPathMask(const Path& path, const Matrix& matrix, int width,
+                                       int height);
+
+  /**
+   * Returns the GLConvexPathOp built ahead for a path by a pending path mask with the same path and
+   * matrix. Returns nullptr if there is no such pending path mask.
+   */
+  std::unique_ptr<GLConvexPathOp> takeConvexPathOp(const Path& path, const Matrix& matrix,
+                                                   int width, int height);
+
+  /**
+   * Hands a mask that is being rasterized on the task pool to the path mask cache, so that the next
+   * getPathMask() call for it waits for the result instead of rasterizing it again.
+   */
+  void addPendingPathMask(std::shared_ptr<PendingPathMask> pendingMask);
+
+  /**
+   * Cancels the pending path masks that have not been used by any getPathMask() call.
+   */
+  void clearPendingPathMasks();
+
+  /**
+   * Returns the counters of the path masks, accumulated since this context was created.
+   */
+  const CacheCounters& pathMaskCounters() const;
+
+  /**
+   * Returns the atlas that caches the glyph images drawn by this context.
+   */
+  GlyphAtlas* getGlyphAtlas() const {
+    return glyphAtlas;
+  }
+
+  /**
+   * Returns the counters of the glyph atlas, accumulated since this context was created.
+   */
+  const CacheCounters& glyphCounters() const;
+
+  /**
+   * Returns the number of draw calls issued by this context, accumulated since it was created.
+   */
+  int64_t drawCallCount() const {
+    return _drawCallCount;
+  }
+
+  /**
+   * Returns the number of draws that were merged into the draw calls of other draws, accumulated
+   * since this context was created.
+   */
+  int64_t mergedDrawCount() const {
+    return _mergedDrawCount;
+  }
+
+  /**
+   * Counts a draw call which has the specified number of draws merged into it.
+   */
+  void recordDrawCall(size_t drawCount);
+
   /**
    * Purges GPU resources that haven't been used in the past 'usNotUsed' microseconds.
    */
   void purgeResourcesNotUsedIn(int64_t usNotUsed);
 
+  /**
+   * Returns the GPU memory held by the recycled resources, which are not used by anyone but kept
+   * for reuse.
+   */
+  size_t recycledResourceMemory() const {
+    return _recycledResourceMemory;
+  }
+
   /**
    * Returns the GPU backend of this context.
    */
@@ -87,11 +188,18 @@ class Context {
   std::list<Program*> programLRU = {};
   std::unordered_map<BytesKey, Program*, BytesHasher> programMap = {};
   GradientCache* gradientCache = nullptr;
+  PathMaskCache* pathMaskCache = nullptr;
+  GlyphAtlas* glyphAtlas = nullptr;
   std::vector<Resource*> nonpurgeableResources = {};
   std::vector<std::shared_ptr<Resource>> strongReferences = {};
   std::unordered_map<BytesKey, std::vector<Resource*>, BytesHasher> recycledResources = {};
   std::mutex removeLocker = {};
   std::vector<Resource*> pendingRemovedResources = {};
+  CacheCounters _programCounters = {};
+  CacheCounters _resourceCounters = {};
+  size_t _recycledResourceMemory = 0;
+  int64_t _drawCallCount = 0;
+  int64_t _mergedDrawCount = 0;
 
   static void AddToList(std::vector<Resource*>& list, Resource* resource);
   static void RemoveFromList(std::vector<Resource*>& list, Resource* resource);
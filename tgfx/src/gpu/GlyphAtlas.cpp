@@ -0,0 +1,240 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "GlyphAtlas.h"
+
+#include <cmath>
+
+#include "base/utils/MathExtra.h"
+#include "gpu/Texture.h"
+#include "raster/Mask.h"
+#include "raster/TextBlob.h"
+
+namespace pag {
+static constexpr int kAtlasSize = 1024;
+// Glyph images larger than this are not cached, they would fill up the atlas too quickly.
+static constexpr int kMaxGlyphSize = 256;
+static constexpr float kMaxMaskFontSize = 160.0f;
+// Leaves a gap between glyphs, so that the linear filtering never samples the neighbours.
+static constexpr int kGlyphPadding = 1;
+// Font sizes are rounded to a quarter of a point, the small difference is made up by scaling.
+static constexpr float kFontSizeBuckets = 4.0f;
+static constexpr int kSubpixelLevels = 4;
+
+enum class GlyphType : uint32_t { Mask, Color };
+
+static float RoundFontSize(float size) {
+  return std::max(roundf(size * kFontSizeBuckets) / kFontSizeBuckets, 1.0f / kFontSizeBuckets);
+}
+
+static BytesKey MakeKey(GlyphType type, const Font& font, float fontSize, GlyphID glyphID,
+                        int subpixelX, int subpixelY) {
+  BytesKey bytesKey = {};
+  bytesKey.write(static_cast<uint32_t>(type));
+  bytesKey.write(font.getTypeface()->uniqueID());
+  bytesKey.write(fontSize);
+  auto flags = (font.isFauxBold() ? 1 : 0) | (font.isFauxItalic() ? 2 : 0);
+  bytesKey.write(static_cast<uint32_t>(glyphID) | static_cast<uint32_t>(flags) << 16);
+  bytesKey.write(static_cast<uint32_t>(subpixelX * kSubpixelLevels + subpixelY));
+  return bytesKey;
+}
+
+// Splits the coordinate into the integer part and the subpixel level.
+static int SplitSubpixel(float value, float* integer) {
+  *integer = floorf(value);
+  auto level = static_cast<int>(roundf((value - *integer) * kSubpixelLevels));
+  if (level == kSubpixelLevels) {
+    *integer += 1;
+    level = 0;
+  }
+  return level;
+}
+
+bool GlyphAtlas::CanUseAtlas(const Font& font, const Matrix& matrix) {
+  if (matrix.getSkewX() != 0 || matrix.getSkewY() != 0 || matrix.getScaleX() <= 0 ||
+      !FloatNearlyEqual(matrix.getScaleX(), matrix.getScaleY())) {
+    return false;
+  }
+  return font.getSize() * matrix.getScaleX() <= kMaxMaskFontSize;
+}
+
+bool GlyphAtlas::getMaskGlyph(const Font& font, GlyphID glyphID, const Point& position,
+                              const Matrix& matrix, AtlasGlyph* glyph) {
+  if (!CanUseAtlas(font, matrix)) {
+    return false;
+  }
+  auto deviceSize = font.getSize() * matrix.getScaleX();
+  auto fontSize = RoundFontSize(deviceSize);
+  auto origin = matrix.mapXY(position.x, position.y);
+  auto subpixelX = SplitSubpixel(origin.x, &origin.x);
+  auto subpixelY = SplitSubpixel(origin.y, &origin.y);
+  auto key = MakeKey(GlyphType::Mask, font, fontSize, glyphID, subpixelX, subpixelY);
+  GlyphEntry entry = {};
+  auto result = glyphs.find(key);
+  if (result != glyphs.end()) {
+    counters.hits++;
+    entry = result->second;
+  } else {
+    auto sizedFont = font.makeWithSize(fontSize);
+    auto offset = Point::Make(static_cast<float>(subpixelX) / kSubpixelLevels,
+                              static_cast<float>(subpixelY) / kSubpixelLevels);
+    auto bounds = sizedFont.getGlyphBounds(glyphID);
+    if (!bounds.isEmpty()) {
+      bounds.offset(offset.x, offset.y);
+      // Makes room for the anti-aliasing pixels.
+      bounds.outset(1, 1);
+      bounds.roundOut();
+    }
+    auto width = static_cast<int>(bounds.width());
+    auto height = static_cast<int>(bounds.height());
+    if (width > kMaxGlyphSize || height > kMaxGlyphSize) {
+      return false;
+    }
+    std::shared_ptr<Texture> texture = nullptr;
+    if (width > 0 && height > 0) {
+      auto mask = Mask::Make(width, height);
+      if (mask == nullptr) {
+        return false;
+      }
+      mask->setMatrix(Matrix::MakeTrans(offset.x - bounds.left, offset.y - bounds.top));
+      auto glyphPosition = Point::Zero();
+      auto textBlob = TextBlob::MakeFrom(&glyphID, &glyphPosition, 1, sizedFont);
+      if (textBlob == nullptr || !mask->fillText(textBlob.get())) {
+        return false;
+      }
+      texture = mask->makeTexture(context);
+    }
+    if (!addGlyph(key, texture.get(), Matrix::MakeTrans(bounds.left, bounds.top), &entry)) {
+      return false;
+    }
+  }
+  glyph->texture = surface->getTexture();
+  glyph->location = entry.location;
+  glyph->matrix = entry.matrix;
+  auto scale = deviceSize / fontSize;
+  glyph->matrix.postScale(scale, scale);
+  glyph->matrix.postTranslate(origin.x, origin.y);
+  return true;
+}
+
+bool GlyphAtlas::getColorGlyph(const Font& font, GlyphID glyphID, const Matrix& matrix,
+                               AtlasGlyph* glyph) {
+  auto scaleX = matrix.getScaleX();
+  auto skewY = matrix.getSkewY();
+  auto scale = std::sqrt(scaleX * scaleX + skewY * skewY);
+  auto fontSize = RoundFontSize(font.getSize() * scale);
+  auto key = MakeKey(GlyphType::Color, font, fontSize, glyphID, 0, 0);
+  GlyphEntry entry = {};
+  auto result = glyphs.find(key);
+  if (result != glyphs.end()) {
+    counters.hits++;
+    entry = result->second;
+  } else {
+    auto glyphMatrix = Matrix::I();
+    auto glyphBuffer = font.makeWithSize(fontSize).getGlyphImage(glyphID, &glyphMatrix);
+    if (glyphBuffer == nullptr || glyphBuffer->width() > kMaxGlyphSize ||
+        glyphBuffer->height() > kMaxGlyphSize) {
+      return false;
+    }
+    auto texture = glyphBuffer->makeTexture(context);
+    if (texture == nullptr) {
+      return false;
+    }
+    if (!addGlyph(key, texture.get(), glyphMatrix, &entry)) {
+      return false;
+    }
+  }
+  glyph->texture = surface->getTexture();
+  glyph->location = entry.location;
+  glyph->matrix = entry.matrix;
+  // The glyph image is drawn at the font size of the entry, which is shared by all the font sizes
+  // rounded to it, scales it back to the size of this font.
+  auto glyphScale = font.getSize() / fontSize;
+  glyph->matrix.postScale(glyphScale, glyphScale);
+  return true;
+}
+
+bool GlyphAtlas::addGlyph(const BytesKey& key, const Texture* image, const Matrix& matrix,
+                          GlyphEntry* entry) {
+  auto location = Point::Zero();
+  auto width = image ? image->width() : 0;
+  auto height = image ? image->height() : 0;
+  if (!allocate(width, height, &location)) {
+    return false;
+  }
+  counters.misses++;
+  entry->location = Rect::MakeXYWH(location.x, location.y, static_cast<float>(width),
+                                   static_cast<float>(height));
+  entry->matrix = matrix;
+  if (image != nullptr) {
+    auto canvas = surface->getCanvas();
+    canvas->setMatrix(Matrix::MakeTrans(location.x, location.y));
+    canvas->drawTexture(image);
+    counters.allocatedBytes += static_cast<int64_t>(width) * height * 4;
+  }
+  glyphs[key] = *entry;
+  return true;
+}
+
+bool GlyphAtlas::allocate(int width, int height, Point* location) {
+  if (surface == nullptr) {
+    surface = Surface::Make(context, kAtlasSize, kAtlasSize);
+    if (surface == nullptr) {
+      return false;
+    }
+  }
+  if (width == 0 || height == 0) {
+    *location = Point::Zero();
+    return true;
+  }
+  width += kGlyphPadding;
+  height += kGlyphPadding;
+  if (shelfX + width > kAtlasSize) {
+    shelfX = 0;
+    shelfY += shelfHeight;
+    shelfHeight = 0;
+  }
+  if (shelfY + height > kAtlasSize) {
+    // The atlas is full, starts over with a new texture. The glyphs that are being drawn keep a
+    // reference to the old texture.
+    for (auto& item : glyphs) {
+      auto& location = item.second.location;
+      counters.evictedBytes += static_cast<int64_t>(location.width() * location.height()) * 4;
+    }
+    counters.evictions += static_cast<int64_t>(glyphs.size());
+    releaseAll();
+    return allocate(width - kGlyphPadding, height - kGlyphPadding, location);
+  }
+  *location = Point::Make(static_cast<float>(shelfX), static_cast<float>(shelfY));
+  shelfX += width;
+  shelfHeight = std::max(shelfHeight, height);
+  return true;
+}
+
+void GlyphAtlas::releaseAll() {
+  glyphs.clear();
+  surface = nullptr;
+  shelfX = 0;
+  shelfY = 0;
+  shelfHeight = 0;
+}
+
+bool GlyphAtlas::empty() const {
+  return glyphs.empty() && surface == nullptr;
+}
+}  // namespace pag
@@ -0,0 +1,113 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <unordered_map>
+
+#include "base/utils/BytesKey.h"
+#include "gpu/Surface.h"
+#include "raster/Font.h"
+
+namespace pag {
+class Context;
+
+class Texture;
+
+/**
+ * Describes a glyph image stored in the GlyphAtlas.
+ */
+struct AtlasGlyph {
+  /**
+   * The atlas texture that contains the glyph image.
+   */
+  std::shared_ptr<Texture> texture = nullptr;
+  /**
+   * The location of the glyph image in the atlas texture, in pixels. It is empty if the glyph has
+   * nothing to draw, such as a space.
+   */
+  Rect location = Rect::MakeEmpty();
+  /**
+   * The matrix to apply to the glyph image when drawing, the image is placed at (0, 0).
+   */
+  Matrix matrix = Matrix::I();
+};
+
+/**
+ * Keeps the rasterized glyph images in a large texture, so that a glyph is rasterized and uploaded
+ * only once no matter how it moves between frames, and all glyphs of a text can be drawn from the
+ * same texture. Glyphs are identified by their typeface, font size bucket, glyph ID and subpixel
+ * offset. When the atlas is full, it starts over with a new texture, the old one is released once
+ * the pending draws that use it are flushed.
+ */
+class GlyphAtlas {
+ public:
+  explicit GlyphAtlas(Context* context) : context(context) {
+  }
+
+  /**
+   * Returns true if the mask glyphs of the font drawn with the matrix can be cached in the atlas,
+   * which requires the matrix to have only a uniform scale and a translation.
+   */
+  static bool CanUseAtlas(const Font& font, const Matrix& matrix);
+
+  /**
+   * Finds the mask glyph of the font drawn at the position with the matrix, rasterizing and
+   * uploading it if it is not cached yet. The matrix of the returned glyph maps the image to the
+   * device space. Returns false if the glyph can not be cached.
+   */
+  bool getMaskGlyph(const Font& font, GlyphID glyphID, const Point& position,
+                    const Matrix& matrix, AtlasGlyph* glyph);
+
+  /**
+   * Finds the color glyph of the font drawn with the matrix, uploading it if it is not cached yet.
+   * The matrix of the returned glyph maps the image to the glyph space, where the glyph origin is
+   * at (0, 0). Returns false if the glyph can not be cached.
+   */
+  bool getColorGlyph(const Font& font, GlyphID glyphID, const Matrix& matrix, AtlasGlyph* glyph);
+
+  void releaseAll();
+
+  bool empty() const;
+
+  /**
+   * Returns the counters of this atlas, accumulated since it was created.
+   */
+  const CacheCounters& getCounters() const {
+    return counters;
+  }
+
+ private:
+  struct GlyphEntry {
+    Rect location = Rect::MakeEmpty();
+    Matrix matrix = Matrix::I();
+  };
+
+  Context* context = nullptr;
+  std::shared_ptr<Surface> surface = nullptr;
+  int shelfX = 0;
+  int shelfY = 0;
+  int shelfHeight = 0;
+  std::unordered_map<BytesKey, GlyphEntry, BytesHasher> glyphs = {};
+  CacheCounters counters = {};
+
+  bool addGlyph(const BytesKey& key, const Texture* image, const Matrix& matrix,
+                GlyphEntry* entry);
+  bool allocate(int width, int height, Point* location);
+};
+}  // namespace pag
@@ -19,6 +19,7 @@
 #include "GradientCache.h"
 
 #include <utility>
+#include "gpu/Texture.h"
 
 namespace pag {
 // Each bitmap will be 256x1.
@@ -36,11 +37,14 @@ const Texture* GradientCache::find(const BytesKey& bytesKey) {
 }
 
 void GradientCache::add(const BytesKey& bytesKey, std::shared_ptr<Texture> texture) {
+  counters.allocatedBytes += static_cast<int64_t>(texture->memoryUsage());
   textures[bytesKey] = std::move(texture);
   keys.push_front(bytesKey);
   while (keys.size() > kMaxNumCachedGradientBitmaps) {
     auto key = keys.back();
     keys.pop_back();
+    counters.evictions++;
+    counters.evictedBytes += static_cast<int64_t>(textures[key]->memoryUsage());
     textures.erase(key);
   }
 }
@@ -104,13 +108,18 @@ const Texture* GradientCache::getGradient(const Color4f* colors, const float* po
 
   const auto* texture = find(bytesKey);
   if (texture) {
+    counters.hits++;
     return texture;
   }
+  counters.misses++;
   auto bitmap = CreateGradient(colors, positions, count, kGradientTextureSize);
   if (bitmap == nullptr) {
     return nullptr;
   }
   auto tex = bitmap->makeTexture(context);
+  if (tex == nullptr) {
+    return nullptr;
+  }
   add(bytesKey, tex);
   return tex.get();
 }
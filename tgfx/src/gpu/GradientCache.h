@@ -39,6 +39,13 @@ class GradientCache {
 
   bool empty() const;
 
+  /**
+   * Returns the counters of this cache, accumulated since it was created.
+   */
+  const CacheCounters& getCounters() const {
+    return counters;
+  }
+
  private:
   const Texture* find(const BytesKey& bytesKey);
 
@@ -47,5 +54,6 @@ class GradientCache {
   Context* context = nullptr;
   std::list<BytesKey> keys = {};
   std::unordered_map<BytesKey, std::shared_ptr<Texture>, BytesHasher> textures = {};
+  CacheCounters counters = {};
 };
 }  // namespace pag
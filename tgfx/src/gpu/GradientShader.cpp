@@ -31,6 +31,7 @@
 #include "TextureGradientColorizer.h"
 #include "UnrolledBinaryGradientColorizer.h"
 #include "base/utils/MathExtra.h"
+#include "pag/file.h"
 
 namespace pag {
 // Intervals smaller than this (that aren't hard stops) on low-precision-only devices force us to
@@ -275,6 +276,30 @@ std::unique_ptr<Shader> GradientShader::MakeRadial(const Point& center, float ra
   return std::make_unique<RadialGradient>(center, radius, colors, positions);
 }
 
+std::unique_ptr<Shader> GradientShader::MakeFrom(const GradientPaint& gradient) {
+  std::unique_ptr<Shader> shader;
+  std::vector<Color4f> colors = {};
+  int index = 0;
+  auto& alphas = gradient.alphas;
+  for (auto& color : gradient.colors) {
+    auto r = static_cast<float>(color.red) / 255.0f;
+    auto g = static_cast<float>(color.green) / 255.0f;
+    auto b = static_cast<float>(color.blue) / 255.0f;
+    auto a = static_cast<float>(alphas[index++]) / 255.0f;
+    colors.emplace_back(r, g, b, a);
+  }
+  if (gradient.gradientType == GradientFillType::Linear) {
+    shader = MakeLinear(gradient.startPoint, gradient.endPoint, colors, gradient.positions);
+  } else {
+    auto radius = Point::Distance(gradient.startPoint, gradient.endPoint);
+    shader = MakeRadial(gradient.startPoint, radius, colors, gradient.positions);
+  }
+  if (!shader) {
+    shader = std::make_unique<Color4Shader>(colors.back());
+  }
+  return shader;
+}
+
 std::unique_ptr<Shader> Shader::MakeColorShader(Color color, Opacity opacity) {
   return std::make_unique<Color4Shader>(
       Color4f{static_cast<float>(color.red) / 255.0f, static_cast<float>(color.green) / 255.0f,
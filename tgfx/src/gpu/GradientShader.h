@@ -19,6 +19,7 @@
 #pragma once
 
 #include "Color4f.h"
+#include "core/Paint.h"
 #include "FragmentProcessor.h"
 
 namespace pag {
@@ -80,6 +81,12 @@ class RadialGradient : public GradientShaderBase {
 
 class GradientShader {
  public:
+  /**
+   * Creates a shader that draws the gradient colors of the paint. Falls back to the last color if
+   * the gradient is degenerate.
+   */
+  static std::unique_ptr<Shader> MakeFrom(const GradientPaint& gradient);
+
   static std::unique_ptr<Shader> MakeLinear(const Point& startPoint, const Point& endPoint,
                                             const std::vector<Color4f>& colors,
                                             const std::vector<float>& positions);
@@ -0,0 +1,224 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "PathMaskCache.h"
+
+#include <cmath>
+
+#include "gpu/Texture.h"
+#include "gpu/opengl/GLConvexPathOp.h"
+#include "raster/Mask.h"
+
+namespace pag {
+static constexpr size_t kMaxNumCachedPathMasks = 256;
+static constexpr size_t kMaxPathMaskMemory = 16777216;  // 16M
+// Masks larger than this are not cached, they would evict too many other masks.
+static constexpr size_t kMaxCachedPathMaskSize = 4194304;  // 4M
+
+class PathMaskTask : public Executor {
+ public:
+  PathMaskTask(Path path, const Matrix& matrix, int width, int height)
+      : path(std::move(path)), matrix(matrix), width(width), height(height) {
+  }
+
+  std::shared_ptr<Mask> mask = nullptr;
+
+ private:
+  Path path = {};
+  Matrix matrix = Matrix::I();
+  int width = 0;
+  int height = 0;
+
+  void execute() override {
+    auto result = Mask::Make(width, height);
+    if (result == nullptr) {
+      return;
+    }
+    result->setMatrix(matrix);
+    result->fillPath(path);
+    mask = result;
+  }
+};
+
+std::shared_ptr<PendingPathMask> PendingPathMask::Make(const Path& path,
+                                                       const Matrix& viewMatrix) {
+  RRect rRect = {};
+  if (path.isEmpty() || path.asRect(nullptr) || path.asRRect(&rRect)) {
+    return nullptr;
+  }
+  auto quad = viewMatrix.mapRect(path.getBounds());
+  int width = 0;
+  int height = 0;
+  auto matrix = PathMaskCache::GetMaskMatrix(viewMatrix, quad, &width, &height);
+  if (width <= 0 || height <= 0 ||
+      static_cast<size_t>(width) * static_cast<size_t>(height) > kMaxCachedPathMaskSize) {
+    return nullptr;
+  }
+  auto pendingMask = std::shared_ptr<PendingPathMask>(new PendingPathMask());
+  pendingMask->bytesKey = PathMaskCache::MakeKey(path, matrix, width, height);
+  pendingMask->path = path;
+  pendingMask->viewMatrix = viewMatrix;
+  pendingMask->matrix = matrix;
+  pendingMask->width = width;
+  pendingMask->height = height;
+  return pendingMask;
+}
+
+PendingPathMask::PendingPathMask() = default;
+
+PendingPathMask::~PendingPathMask() = default;
+
+void PendingPathMask::run() {
+  // Convex paths are drawn as triangles without masks.
+  if (task != nullptr || convexOp != nullptr) {
+    return;
+  }
+  convexOp = GLConvexPathOp::Make(path, viewMatrix);
+  if (convexOp != nullptr) {
+    return;
+  }
+  task = Task::Make(std::make_unique<PathMaskTask>(path, matrix, width, height));
+  // The mask is needed by the drawing of the current frame.
+  task->run(TaskPriority::Urgent);
+}
+
+Matrix PathMaskCache::GetMaskMatrix(const Matrix& viewMatrix, const Rect& deviceQuad, int* width,
+                                    int* height) {
+  auto maskWidth = ceilf(deviceQuad.width());
+  auto maskHeight = ceilf(deviceQuad.height());
+  auto matrix = viewMatrix;
+  auto maskMatrix = Matrix::MakeTrans(-deviceQuad.x(), -deviceQuad.y());
+  maskMatrix.postScale(maskWidth / deviceQuad.width(), maskHeight / deviceQuad.height());
+  matrix.postConcat(maskMatrix);
+  *width = static_cast<int>(maskWidth);
+  *height = static_cast<int>(maskHeight);
+  return matrix;
+}
+
+BytesKey PathMaskCache::MakeKey(const Path& path, const Matrix& matrix, int width, int height) {
+  // The matrix is relative to the device bounds of the path, so translating the path on the
+  // device does not change the key, unless it is clipped differently.
+  BytesKey bytesKey = {};
+  bytesKey.write(path.pathRef.get());
+  bytesKey.write(static_cast<uint32_t>(path.getFillType()));
+  bytesKey.write(matrix.getScaleX());
+  bytesKey.write(matrix.getSkewX());
+  bytesKey.write(matrix.getTranslateX());
+  bytesKey.write(matrix.getSkewY());
+  bytesKey.write(matrix.getScaleY());
+  bytesKey.write(matrix.getTranslateY());
+  bytesKey.write(static_cast<uint32_t>(width));
+  bytesKey.write(static_cast<uint32_t>(height));
+  return bytesKey;
+}
+
+std::shared_ptr<Texture> PathMaskCache::getMask(const Path& path, const Matrix& matrix, int width,
+                                                int height) {
+  auto bytesKey = MakeKey(path, matrix, width, height);
+  auto iter = masks.find(bytesKey);
+  if (iter != masks.end()) {
+    counters.hits++;
+    keys.remove(bytesKey);
+    keys.push_front(bytesKey);
+    return iter->second.texture;
+  }
+  counters.misses++;
+  std::shared_ptr<Mask> mask = nullptr;
+  auto pendingMask = pendingMasks.find(bytesKey);
+  if (pendingMask != pendingMasks.end() && pendingMask->second->task != nullptr) {
+    auto executor = static_cast<PathMaskTask*>(pendingMask->second->task->wait());
+    mask = executor->mask;
+    pendingMasks.erase(pendingMask);
+  }
+  if (mask == nullptr) {
+    mask = Mask::Make(width, height);
+    if (mask == nullptr) {
+      return nullptr;
+    }
+    mask->setMatrix(matrix);
+    mask->fillPath(path);
+  }
+  auto texture = mask->makeTexture(context);
+  if (texture == nullptr) {
+    return nullptr;
+  }
+  if (texture->memoryUsage() <= kMaxCachedPathMaskSize) {
+    add(bytesKey, path, texture);
+  }
+  return texture;
+}
+
+void PathMaskCache::add(const BytesKey& bytesKey, const Path& path,
+                        std::shared_ptr<Texture> texture) {
+  auto memory = texture->memoryUsage();
+  counters.allocatedBytes += static_cast<int64_t>(memory);
+  totalMemory += memory;
+  masks[bytesKey] = {path, std::move(texture)};
+  keys.push_front(bytesKey);
+  while (keys.size() > kMaxNumCachedPathMasks || totalMemory > kMaxPathMaskMemory) {
+    auto key = keys.back();
+    keys.pop_back();
+    auto evictedMemory = masks[key].texture->memoryUsage();
+    totalMemory -= evictedMemory;
+    counters.evictions++;
+    counters.evictedBytes += static_cast<int64_t>(evictedMemory);
+    masks.erase(key);
+  }
+}
+
+std::unique_ptr<GLConvexPathOp> PathMaskCache::takeConvexOp(const Path& path,
+                                                            const Matrix& matrix, int width,
+                                                            int height) {
+  auto pendingMask = pendingMasks.find(MakeKey(path, matrix, width, height));
+  if (pendingMask == pendingMasks.end() || pendingMask->second->convexOp == nullptr) {
+    return nullptr;
+  }
+  auto op = std::move(pendingMask->second->convexOp);
+  pendingMasks.erase(pendingMask);
+  return op;
+}
+
+void PathMaskCache::addPendingMask(std::shared_ptr<PendingPathMask> pendingMask) {
+  if (pendingMask == nullptr ||
+      (pendingMask->task == nullptr && pendingMask->convexOp == nullptr) ||
+      masks.count(pendingMask->key()) > 0) {
+    return;
+  }
+  pendingMasks[pendingMask->key()] = std::move(pendingMask);
+}
+
+void PathMaskCache::clearPendingMasks() {
+  for (auto& item : pendingMasks) {
+    if (item.second->task != nullptr) {
+      item.second->task->cancel();
+    }
+  }
+  pendingMasks.clear();
+}
+
+void PathMaskCache::releaseAll() {
+  clearPendingMasks();
+  masks.clear();
+  keys.clear();
+  totalMemory = 0;
+}
+
+bool PathMaskCache::empty() const {
+  return masks.empty() && keys.empty() && pendingMasks.empty();
+}
+}  // namespace pag
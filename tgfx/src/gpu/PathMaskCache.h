@@ -0,0 +1,151 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <list>
+#include <unordered_map>
+
+#include "base/utils/BytesKey.h"
+#include "base/utils/Task.h"
+#include "raster/Path.h"
+
+namespace pag {
+class Context;
+
+class Texture;
+
+class GLConvexPathOp;
+
+/**
+ * A path mask that starts rasterizing on the task pool before the path gets drawn. Hand it to the
+ * Context by addPendingPathMask() before drawing, and the drawing picks up the rasterized mask
+ * instead of rasterizing it on the render thread.
+ */
+class PendingPathMask {
+ public:
+  /**
+   * Creates a PendingPathMask for the path drawn with the specified view matrix, assuming it is not
+   * clipped. Returns nullptr if the path is empty, is too large to be cached, or can be drawn
+   * directly on the GPU without a mask. The rasterization does not start until run() is called.
+   */
+  static std::shared_ptr<PendingPathMask> Make(const Path& path, const Matrix& viewMatrix);
+
+  ~PendingPathMask();
+
+  /**
+   * Returns the key of the mask in the PathMaskCache.
+   */
+  const BytesKey& key() const {
+    return bytesKey;
+  }
+
+  /**
+   * Starts rasterizing the mask on the task pool. If the path can be drawn as triangles without a
+   * mask, keeps the GLConvexPathOp instead, which the drawing picks up without building it again.
+   */
+  void run();
+
+ private:
+  BytesKey bytesKey = {};
+  Path path = {};
+  Matrix viewMatrix = Matrix::I();
+  Matrix matrix = Matrix::I();
+  int width = 0;
+  int height = 0;
+  std::shared_ptr<Task> task = nullptr;
+  std::unique_ptr<GLConvexPathOp> convexOp;
+
+  PendingPathMask();
+
+  friend class PathMaskCache;
+};
+
+/**
+ * Caches the mask textures of the paths that can not be drawn directly on the GPU, so that a
+ * static path drawn with the same matrix in every frame is rasterized and uploaded only once.
+ * Paths are identified by their shared geometry, the cache keeps a copy of each path, so the
+ * geometry of a cached path never changes.
+ */
+class PathMaskCache {
+ public:
+  explicit PathMaskCache(Context* context) : context(context) {
+  }
+
+  /**
+   * Returns a mask texture of the specified size, which has the path filled with the matrix.
+   * Returns nullptr if the mask fails to be created.
+   */
+  std::shared_ptr<Texture> getMask(const Path& path, const Matrix& matrix, int width, int height);
+
+  /**
+   * Returns the GLConvexPathOp built ahead by a pending mask with the same path and matrix, which
+   * can be taken only once. Returns nullptr if there is no such pending mask.
+   */
+  std::unique_ptr<GLConvexPathOp> takeConvexOp(const Path& path, const Matrix& matrix, int width,
+                                               int height);
+
+  /**
+   * Adds a mask that is being rasterized on the task pool, the next getMask() call with the same
+   * path and matrix waits for it instead of rasterizing again.
+   */
+  void addPendingMask(std::shared_ptr<PendingPathMask> pendingMask);
+
+  /**
+   * Cancels all the pending masks that have not been used yet.
+   */
+  void clearPendingMasks();
+
+  /**
+   * Returns the size of the mask for a path drawn onto the device quad, and the matrix to fill the
+   * path into the mask. The viewMatrix is the matrix the path is drawn with.
+   */
+  static Matrix GetMaskMatrix(const Matrix& viewMatrix, const Rect& deviceQuad, int* width,
+                              int* height);
+
+  void releaseAll();
+
+  bool empty() const;
+
+  /**
+   * Returns the counters of this cache, accumulated since it was created.
+   */
+  const CacheCounters& getCounters() const {
+    return counters;
+  }
+
+ private:
+  struct MaskEntry {
+    Path path;
+    std::shared_ptr<Texture> texture;
+  };
+
+  Context* context = nullptr;
+  std::list<BytesKey> keys = {};
+  std::unordered_map<BytesKey, MaskEntry, BytesHasher> masks = {};
+  std::unordered_map<BytesKey, std::shared_ptr<PendingPathMask>, BytesHasher> pendingMasks = {};
+  size_t totalMemory = 0;
+  CacheCounters counters = {};
+
+  static BytesKey MakeKey(const Path& path, const Matrix& matrix, int width, int height);
+
+  void add(const BytesKey& bytesKey, const Path& path, std::shared_ptr<Texture> texture);
+
+  friend class PendingPathMask;
+};
+}  // namespace pag
@@ -38,8 +38,25 @@ class Resource {
     return std::static_pointer_cast<T>(context->wrapResource(resource));
   }
 
+  /**
+   * Returns a strong reference to the specified resource, or nullptr if it was not created by
+   * Wrap().
+   */
+  template <class T>
+  static std::shared_ptr<T> Ref(const T* resource) {
+    return std::static_pointer_cast<T>(static_cast<const Resource*>(resource)->weakThis.lock());
+  }
+
   virtual ~Resource() = default;
 
+  /**
+   * Returns the GPU memory held by this Resource. The recycled resources in the context are
+   * budgeted by their memory usage.
+   */
+  virtual size_t memoryUsage() const {
+    return 0;
+  }
+
  protected:
   Context* context = nullptr;
 
@@ -33,6 +33,10 @@ class GLBuffer : public Resource {
     return _length;
   }
 
+  size_t memoryUsage() const override {
+    return _length * sizeof(uint16_t);
+  }
+
  protected:
   void computeRecycleKey(BytesKey*) const override;
 
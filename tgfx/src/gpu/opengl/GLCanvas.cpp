@@ -17,11 +17,14 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "GLCanvas.h"
+#include "GLConvexPathOp.h"
 #include "GLFillRectOp.h"
 #include "GLRRectOp.h"
 #include "GLSurface.h"
 #include "base/utils/MathExtra.h"
+#include "gpu/GlyphAtlas.h"
 #include "gpu/AlphaFragmentProcessor.h"
+#include "gpu/PathMaskCache.h"
 #include "gpu/TextureFragmentProcessor.h"
 #include "gpu/TextureMaskFragmentProcessor.h"
 #include "gpu/YUVTextureFragmentProcessor.h"
@@ -34,9 +37,26 @@ GLCanvas::GLCanvas(Surface* surface) : Canvas(surface) {
 }
 
 void GLCanvas::clear() {
+  // The pending draws are covered by the clear, there is no need to draw them.
+  batchTexture = nullptr;
+  batchOp = nullptr;
   static_cast<GLSurface*>(surface)->getRenderTarget()->clear(GLContext::Unwrap(getContext()));
 }
 
+void GLCanvas::clearRect(const Rect& rect) {
+  auto clearBounds = rect;
+  clearBounds.roundOut();
+  auto surfaceBounds =
+      Rect::MakeWH(static_cast<float>(surface->width()), static_cast<float>(surface->height()));
+  if (!clearBounds.intersect(surfaceBounds)) {
+    return;
+  }
+  // The pending draws must land before the clear, which only covers part of them.
+  flushBatch();
+  static_cast<GLSurface*>(surface)->getRenderTarget()->clearRect(GLContext::Unwrap(getContext()),
+                                                                 clearBounds);
+}
+
 void GLCanvas::drawTexture(const Texture* texture, const Texture* mask, bool inverted) {
   drawTexture(texture, nullptr, mask, inverted);
 }
@@ -117,8 +137,14 @@ void GLCanvas::drawTexture(const Texture* texture, const RGBAAALayout* layout, c
   }
   auto width = static_cast<float>(layout ? layout->width : texture->width());
   auto height = static_cast<float>(layout ? layout->height : texture->height());
+  drawTexture(texture, Rect::MakeWH(width, height), layout, mask, inverted);
+}
+
+void GLCanvas::drawTexture(const Texture* texture, const Rect& srcRect,
+                           const RGBAAALayout* layout, const Texture* mask, bool inverted) {
   auto clippedDeviceQuad = Rect::MakeEmpty();
-  auto clippedLocalQuad = clipLocalQuad(Rect::MakeWH(width, height), &clippedDeviceQuad);
+  auto clippedLocalQuad =
+      clipLocalQuad(Rect::MakeWH(srcRect.width(), srcRect.height()), &clippedDeviceQuad);
   if (clippedLocalQuad.isEmpty()) {
     return;
   }
@@ -126,8 +152,13 @@ void GLCanvas::drawTexture(const Texture* texture, const RGBAAALayout* layout, c
   auto scale = texture->getTextureCoord(clippedLocalQuad.width(), clippedLocalQuad.height()) -
                texture->getTextureCoord(0, 0);
   localMatrix.postScale(scale.x, scale.y);
-  auto translate = texture->getTextureCoord(clippedLocalQuad.x(), clippedLocalQuad.y());
+  auto translate = texture->getTextureCoord(srcRect.x() + clippedLocalQuad.x(),
+                                            srcRect.y() + clippedLocalQuad.y());
   localMatrix.postTranslate(translate.x, translate.y);
+  if (layout == nullptr && mask == nullptr && !texture->isYUV() &&
+      addToBatch(texture, clippedLocalQuad, clippedDeviceQuad, localMatrix)) {
+    return;
+  }
   std::unique_ptr<FragmentProcessor> color;
   if (texture->isYUV()) {
     color = YUVTextureFragmentProcessor::Make(static_cast<const YUVTexture*>(texture), layout,
@@ -144,33 +175,8 @@ void GLCanvas::drawPath(const Path& path, Color color) {
   drawPath(path, shader.get());
 }
 
-static std::unique_ptr<Shader> MakeGradientShader(const GradientPaint& gradient) {
-  std::unique_ptr<Shader> shader;
-  std::vector<Color4f> colors = {};
-  int index = 0;
-  auto& alphas = gradient.alphas;
-  for (auto& color : gradient.colors) {
-    auto r = static_cast<float>(color.red) / 255.0f;
-    auto g = static_cast<float>(color.green) / 255.0f;
-    auto b = static_cast<float>(color.blue) / 255.0f;
-    auto a = static_cast<float>(alphas[index++]) / 255.0f;
-    colors.emplace_back(r, g, b, a);
-  }
-  if (gradient.gradientType == GradientFillType::Linear) {
-    shader = GradientShader::MakeLinear(gradient.startPoint, gradient.endPoint, colors,
-                                        gradient.positions);
-  } else {
-    auto radius = Point::Distance(gradient.startPoint, gradient.endPoint);
-    shader = GradientShader::MakeRadial(gradient.startPoint, radius, colors, gradient.positions);
-  }
-  if (!shader) {
-    shader = std::make_unique<Color4Shader>(colors.back());
-  }
-  return shader;
-}
-
 void GLCanvas::drawPath(const Path& path, const GradientPaint& gradient) {
-  auto shader = MakeGradientShader(gradient);
+  auto shader = GradientShader::MakeFrom(gradient);
   drawPath(path, shader.get());
 }
 
@@ -194,7 +200,17 @@ void GLCanvas::drawPath(const Path& path, const Shader* shader) {
   if (clippedLocalQuad.isEmpty()) {
     return;
   }
-  auto op = MakeSimplePathOp(path);
+  auto quad = globalPaint.matrix.mapRect(clippedLocalQuad);
+  int width = 0;
+  int height = 0;
+  auto totalMatrix = PathMaskCache::GetMaskMatrix(globalPaint.matrix, quad, &width, &height);
+  std::unique_ptr<GLDrawOp> op = MakeSimplePathOp(path);
+  if (op == nullptr) {
+    op = getContext()->takeConvexPathOp(path, totalMatrix, width, height);
+  }
+  if (op == nullptr) {
+    op = GLConvexPathOp::Make(path, globalPaint.matrix);
+  }
   if (op) {
     auto localMatrix = Matrix::MakeScale(bounds.width(), bounds.height());
     localMatrix.postTranslate(bounds.x(), bounds.y());
@@ -202,20 +218,7 @@ void GLCanvas::drawPath(const Path& path, const Shader* shader) {
     draw(bounds, bounds, std::move(op), shader->asFragmentProcessor(args));
     return;
   }
-  auto quad = globalPaint.matrix.mapRect(clippedLocalQuad);
-  auto width = ceilf(quad.width());
-  auto height = ceilf(quad.height());
-  auto mask = Mask::Make(static_cast<int>(width), static_cast<int>(height));
-  if (!mask) {
-    return;
-  }
-  auto totalMatrix = globalPaint.matrix;
-  auto matrix = Matrix::MakeTrans(-quad.x(), -quad.y());
-  matrix.postScale(width / quad.width(), height / quad.height());
-  totalMatrix.postConcat(matrix);
-  mask->setMatrix(totalMatrix);
-  mask->fillPath(path);
-  auto maskTexture = mask->makeTexture(getContext());
+  auto maskTexture = getContext()->getPathMask(path, totalMatrix, width, height);
   drawMask(quad, maskTexture.get(), shader);
 }
 
@@ -249,6 +252,10 @@ void GLCanvas::drawGlyphs(const GlyphID glyphIDs[], const Point positions[], siz
     drawColorGlyphs(glyphIDs, positions, glyphCount, font, paint);
     return;
   }
+  if (paint.getStyle() == PaintStyle::Fill &&
+      drawAtlasGlyphs(glyphIDs, positions, glyphCount, font, paint)) {
+    return;
+  }
   Path path = {};
   auto stroke = paint.getStyle() == PaintStyle::Stroke ? paint.getStroke() : nullptr;
   if (textBlob->getPath(&path, stroke)) {
@@ -265,10 +272,24 @@ void GLCanvas::drawColorGlyphs(const GlyphID glyphIDs[], const Point positions[]
   auto skewY = globalPaint.matrix.getSkewY();
   auto scale = std::sqrt(scaleX * scaleX + skewY * skewY);
   auto scaleFont = font.makeWithSize(font.getSize() * scale);
+  auto glyphAtlas = getContext()->getGlyphAtlas();
   for (size_t i = 0; i < glyphCount; ++i) {
     const auto& glyphID = glyphIDs[i];
     const auto& position = positions[i];
 
+    // The glyphs drawn from the atlas share the same texture, their draws are merged.
+    AtlasGlyph glyph = {};
+    if (glyphAtlas->getColorGlyph(font, glyphID, globalPaint.matrix, &glyph)) {
+      if (!glyph.location.isEmpty()) {
+        save();
+        concat(Matrix::MakeTrans(position.x, position.y));
+        concat(glyph.matrix);
+        concatAlpha(paint.getAlpha());
+        drawTexture(glyph.texture.get(), glyph.location, nullptr, nullptr, false);
+        restore();
+      }
+      continue;
+    }
     auto glyphMatrix = Matrix::I();
     auto glyphBuffer = scaleFont.getGlyphImage(glyphID, &glyphMatrix);
     if (glyphBuffer == nullptr) {
@@ -285,6 +306,53 @@ void GLCanvas::drawColorGlyphs(const GlyphID glyphIDs[], const Point positions[]
   }
 }
 
+bool GLCanvas::drawAtlasGlyphs(const GlyphID glyphIDs[], const Point positions[],
+                               size_t glyphCount, const Font& font, const Paint& paint) {
+  if (!GlyphAtlas::CanUseAtlas(font, globalPaint.matrix)) {
+    return false;
+  }
+  auto glyphAtlas = getContext()->getGlyphAtlas();
+  std::vector<AtlasGlyph> glyphs = {};
+  glyphs.reserve(glyphCount);
+  for (size_t i = 0; i < glyphCount; ++i) {
+    AtlasGlyph glyph = {};
+    if (!glyphAtlas->getMaskGlyph(font, glyphIDs[i], positions[i], globalPaint.matrix, &glyph)) {
+      return false;
+    }
+    if (!glyph.location.isEmpty()) {
+      glyphs.push_back(std::move(glyph));
+    }
+  }
+  save();
+  resetMatrix();
+  auto viewMatrix = getViewMatrix();
+  auto shader = Shader::MakeColorShader(paint.getColor(), paint.getAlpha());
+  size_t index = 0;
+  while (index < glyphs.size()) {
+    // All glyphs come from the same atlas texture, unless the atlas was full and started over.
+    auto atlas = glyphs[index].texture.get();
+    auto op = std::make_unique<GLBatchedFillRectOp>();
+    auto bounds = Rect::MakeEmpty();
+    for (; index < glyphs.size() && glyphs[index].texture.get() == atlas; index++) {
+      auto& glyph = glyphs[index];
+      auto rect = Rect::MakeWH(glyph.location.width(), glyph.location.height());
+      auto localMatrix = Matrix::MakeScale(rect.width(), rect.height());
+      localMatrix.postTranslate(glyph.location.x(), glyph.location.y());
+      auto scale = atlas->getTextureCoord(1, 1) - atlas->getTextureCoord(0, 0);
+      localMatrix.postScale(scale.x, scale.y);
+      auto deviceMatrix = glyph.matrix;
+      deviceMatrix.postConcat(viewMatrix);
+      op->addRect(rect, deviceMatrix, AAType::None, 1.0f, localMatrix);
+      bounds.join(glyph.matrix.mapRect(rect));
+    }
+    auto args = FPArgs(getContext(), Matrix::I());
+    draw(bounds, bounds, std::move(op), shader->asFragmentProcessor(args),
+         TextureMaskFragmentProcessor::MakeUseLocalCoord(atlas, Matrix::I()));
+  }
+  restore();
+  return true;
+}
+
 void GLCanvas::drawMaskGlyphs(TextBlob* textBlob, const Paint& paint) {
   if (textBlob == nullptr) {
     return;
@@ -356,26 +424,93 @@ Matrix GLCanvas::getViewMatrix() {
   return matrix;
 }
 
+AAType GLCanvas::getAAType(const Rect& deviceQuad, bool aa) const {
+  auto renderTarget = static_cast<GLSurface*>(surface)->getRenderTarget();
+  if (renderTarget->usesMSAA()) {
+    return AAType::MSAA;
+  }
+  if (aa && !IsPixelAligned(deviceQuad)) {
+    return AAType::Coverage;
+  }
+  auto& matrix = globalPaint.matrix;
+  auto rotation = std::round(RadiansToDegrees(atan2f(matrix.getSkewX(), matrix.getScaleX())));
+  if (static_cast<int>(rotation) % 90 != 0) {
+    return AAType::Coverage;
+  }
+  return AAType::None;
+}
+
+bool GLCanvas::addToBatch(const Texture* texture, const Rect& localQuad, const Rect& deviceQuad,
+                          const Matrix& localMatrix) {
+  auto renderTarget = static_cast<GLSurface*>(surface)->getRenderTarget();
+  if (globalPaint.blendMode != Blend::SrcOver || renderTarget->usesMSAA()) {
+    return false;
+  }
+  // Only the clips that can be done by the scissor test are allowed, clip masks are drawn into the
+  // same clip surface for every draw.
+  auto scissorRect = Rect::MakeEmpty();
+  auto& clipPath = globalPaint.clip;
+  if (!clipPath.contains(deviceQuad)) {
+    if (!clipPath.asRect(&scissorRect) || !IsPixelAligned(scissorRect)) {
+      return false;
+    }
+    scissorRect.round();
+  }
+  if (batchTexture.get() != texture || batchScissorRect != scissorRect) {
+    flushBatch();
+    // Holds the texture until the batch is flushed, the caller may release it after drawing.
+    batchTexture = Resource::Ref(texture);
+    if (batchTexture == nullptr) {
+      return false;
+    }
+    batchOp = std::make_unique<GLBatchedFillRectOp>();
+    batchScissorRect = scissorRect;
+    batchBounds = Rect::MakeEmpty();
+  }
+  auto viewMatrix = getViewMatrix();
+  auto alpha = static_cast<float>(globalPaint.alpha) / Opaque;
+  batchOp->addRect(localQuad, viewMatrix, getAAType(deviceQuad, true), alpha, localMatrix);
+  batchBounds.join(viewMatrix.mapRect(localQuad));
+  return true;
+}
+
+void GLCanvas::flushBatch() {
+  if (batchOp == nullptr) {
+    return;
+  }
+  auto texture = std::move(batchTexture);
+  auto op = std::move(batchOp);
+  auto* drawer = getDrawer();
+  if (drawer == nullptr) {
+    return;
+  }
+  auto renderTarget = static_cast<GLSurface*>(surface)->getRenderTarget();
+  DrawArgs args;
+  args.colors.push_back(TextureFragmentProcessor::Make(texture.get(), nullptr, Matrix::I()));
+  args.context = surface->getContext();
+  args.blendMode = Blend::SrcOver;
+  args.renderTarget = renderTarget.get();
+  args.renderTargetTexture = surface->getTexture();
+  args.aa = AAType::Coverage;
+  args.rectToDraw = batchBounds;
+  args.scissorRect = batchScissorRect;
+  drawer->draw(std::move(args), std::move(op));
+}
+
+void GLCanvas::flush() {
+  flushBatch();
+}
+
 void GLCanvas::draw(const Rect& localQuad, const Rect& deviceQuad, std::unique_ptr<GLDrawOp> op,
                     std::unique_ptr<FragmentProcessor> color,
                     std::unique_ptr<FragmentProcessor> mask, bool aa) {
+  flushBatch();
   auto* drawer = getDrawer();
   if (drawer == nullptr) {
     return;
   }
   auto renderTarget = static_cast<GLSurface*>(surface)->getRenderTarget();
-  auto aaType = AAType::None;
-  if (renderTarget->usesMSAA()) {
-    aaType = AAType::MSAA;
-  } else if (aa && !IsPixelAligned(deviceQuad)) {
-    aaType = AAType::Coverage;
-  } else {
-    auto& matrix = globalPaint.matrix;
-    auto rotation = std::round(RadiansToDegrees(atan2f(matrix.getSkewX(), matrix.getScaleX())));
-    if (static_cast<int>(rotation) % 90 != 0) {
-      aaType = AAType::Coverage;
-    }
-  }
+  auto aaType = getAAType(deviceQuad, aa);
   DrawArgs args;
   if (color) {
     args.colors.push_back(std::move(color));
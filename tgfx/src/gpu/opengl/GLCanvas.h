@@ -19,6 +19,7 @@
 #pragma once
 
 #include "GLDrawer.h"
+#include "GLFillRectOp.h"
 #include "core/Canvas.h"
 #include "gpu/Blend.h"
 #include "gpu/GradientShader.h"
@@ -30,12 +31,14 @@ class GLCanvas : public Canvas {
   explicit GLCanvas(Surface* surface);
 
   void clear() override;
+  void clearRect(const Rect& rect) override;
   void drawTexture(const Texture* texture, const Texture* mask, bool inverted) override;
   void drawTexture(const Texture* texture, const RGBAAALayout* layout) override;
   void drawPath(const Path& path, Color color) override;
   void drawPath(const Path& path, const GradientPaint& gradient) override;
   void drawGlyphs(const GlyphID glyphIDs[], const Point positions[], size_t glyphCount,
                   const Font& font, const Paint& paint) override;
+  void flush() override;
   Enum hasComplexPaint(const Rect& drawingBounds) const override;
   void drawPath(const Path& path, const Shader* shader);
 
@@ -52,6 +55,11 @@ class GLCanvas : public Canvas {
  private:
   std::shared_ptr<Surface> _clipSurface = nullptr;
   std::shared_ptr<GLDrawer> _drawer = nullptr;
+  // The pending draws of the same texture, which are merged into one draw call when flushed.
+  std::shared_ptr<Texture> batchTexture = nullptr;
+  std::unique_ptr<GLBatchedFillRectOp> batchOp = nullptr;
+  Rect batchScissorRect = Rect::MakeEmpty();
+  Rect batchBounds = Rect::MakeEmpty();
 
   GLDrawer* getDrawer();
 
@@ -63,14 +71,27 @@ class GLCanvas : public Canvas {
 
   Rect clipLocalQuad(Rect localQuad, Rect* outClippedDeviceQuad);
 
+  AAType getAAType(const Rect& deviceQuad, bool aa) const;
+
+  bool addToBatch(const Texture* texture, const Rect& localQuad, const Rect& deviceQuad,
+                  const Matrix& localMatrix);
+
+  void flushBatch();
+
   void drawTexture(const Texture* texture, const RGBAAALayout* layout, const Texture* mask,
                    bool inverted);
 
+  void drawTexture(const Texture* texture, const Rect& srcRect, const RGBAAALayout* layout,
+                   const Texture* mask, bool inverted);
+
   void drawMask(Rect quad, const Texture* mask, const Shader* shader);
 
   void drawColorGlyphs(const GlyphID glyphIDs[], const Point positions[], size_t glyphCount,
                        const Font& font, const Paint& paint);
 
+  bool drawAtlasGlyphs(const GlyphID glyphIDs[], const Point positions[], size_t glyphCount,
+                       const Font& font, const Paint& paint);
+
   void drawMaskGlyphs(TextBlob* textBlob, const Paint& paint);
 
   void draw(const Rect& localQuad, const Rect& deviceQuad, std::unique_ptr<GLDrawOp> op,
@@ -163,6 +163,11 @@ GLCaps::GLCaps(const GLInfo& info) {
   standard = info.standard;
   version = info.version;
   vendor = GetVendorFromString((const char*)info.getString(GL::VENDOR));
+  for (auto name : {GL::VENDOR, GL::RENDERER, GL::VERSION}) {
+    auto value = (const char*)info.getString(name);
+    driverString += value ? value : "";
+    driverString += "\n";
+  }
   floatIs32Bits = IsMediumFloatFp32(info);
   switch (standard) {
     case GLStandard::GL:
@@ -179,6 +184,12 @@ GLCaps::GLCaps(const GLInfo& info) {
   }
   info.getIntegerv(GL::MAX_TEXTURE_SIZE, &maxTextureSize);
   info.getIntegerv(GL::MAX_TEXTURE_IMAGE_UNITS, &maxFragmentSamplers);
+  if (programBinarySupport) {
+    // Some drivers support the functions but no binary format at all.
+    int numFormats = 0;
+    info.getIntegerv(GL::NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+    programBinarySupport = numFormats > 0;
+  }
   initFSAASupport(info);
   initConfigMap(info);
 }
@@ -227,6 +238,10 @@ void GLCaps::initGLSupport(const GLInfo& info) {
                           info.hasExtension("GL_NV_texture_barrier");
   textureSwizzleSupport = version >= GL_VER(3, 3) || info.hasExtension("GL_ARB_texture_swizzle");
   semaphoreSupport = version >= GL_VER(3, 2) || info.hasExtension("GL_ARB_sync");
+  programBinarySupport =
+      version >= GL_VER(4, 1) || info.hasExtension("GL_ARB_get_program_binary");
+  pixelBufferSupport = semaphoreSupport && (version >= GL_VER(3, 0) ||
+                                            info.hasExtension("GL_ARB_map_buffer_range"));
 }
 
 void GLCaps::initGLESSupport(const GLInfo& info) {
@@ -258,6 +273,9 @@ void GLCaps::initGLESSupport(const GLInfo& info) {
     frameBufferFetchRequiresEnablePerSample = true;
   }
   semaphoreSupport = version >= GL_VER(3, 0) || info.hasExtension("GL_APPLE_sync");
+  programBinarySupport =
+      version >= GL_VER(3, 0) || info.hasExtension("GL_OES_get_program_binary");
+  pixelBufferSupport = version >= GL_VER(3, 0);
 }
 
 void GLCaps::initWebGLSupport(const GLInfo& info) {
@@ -132,6 +132,17 @@ class GLCaps : public Caps {
   int maxFragmentSamplers = kMaxSaneSamplers;
   bool textureSwizzleSupport = false;
   bool semaphoreSupport = false;
+  bool programBinarySupport = false;
+  /**
+   * True if the pixels of a render target can be copied into a pixel pack buffer and mapped after
+   * a fence, which makes the copy asynchronous.
+   */
+  bool pixelBufferSupport = false;
+  /**
+   * The vendor, renderer and version strings of the driver, which identify the binary format of
+   * the programs.
+   */
+  std::string driverString;
 
   explicit GLCaps(const GLInfo& info);
 
@@ -0,0 +1,281 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "GLConvexPathOp.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include "base/utils/MathExtra.h"
+#include "gpu/QuadPerEdgeAAGeometryProcessor.h"
+
+namespace pag {
+// The maximum distance in pixels between a curve and the line segments it is flattened into.
+static constexpr float kFlattenTolerance = 0.25f;
+static constexpr int kMaxCurveSegments = 64;
+// Paths flattened into more points are drawn with masks, uploading a mask costs less then.
+static constexpr size_t kMaxConvexPathPoints = 512;
+// The cosine of the largest angle between the normals of two adjacent edges. The outset of a
+// sharper corner spikes too far away from the contour.
+static constexpr float kMinCornerCosine = -0.8f;
+
+static std::atomic<bool> convexPathEnabled = {true};
+
+void GLConvexPathOp::SetEnabled(bool enabled) {
+  convexPathEnabled = enabled;
+}
+
+static Point Scale(const Point& point, float scale) {
+  return Point::Make(point.x * scale, point.y * scale);
+}
+
+static float Cross(const Point& a, const Point& b) {
+  return a.x * b.y - a.y * b.x;
+}
+
+static float Dot(const Point& a, const Point& b) {
+  return a.x * b.x + a.y * b.y;
+}
+
+static int CountSegments(float value) {
+  auto count = static_cast<int>(ceilf(sqrtf(value)));
+  return std::max(1, std::min(count, kMaxCurveSegments));
+}
+
+// Flattens the path into a polygon. Returns false if the path has more than one contour or too many
+// points.
+static bool FlattenPath(const Path& path, float tolerance, std::vector<Point>* points) {
+  int contourCount = 0;
+  path.decompose([&](PathVerb verb, const Point pts[4], void*) {
+    if (contourCount > 1 || points->size() > kMaxConvexPathPoints) {
+      // Skips the remaining curves, the path is going to be drawn with a mask anyway.
+      return;
+    }
+    switch (verb) {
+      case PathVerb::Move:
+        contourCount++;
+        points->push_back(pts[0]);
+        break;
+      case PathVerb::Line:
+        points->push_back(pts[1]);
+        break;
+      case PathVerb::Quad: {
+        // The distance between a quad and its chords is at most |p0 - 2p1 + p2| / (4 * n^2).
+        auto distance = (pts[0] - pts[1] - pts[1] + pts[2]).length();
+        auto count = CountSegments(distance / (4 * tolerance));
+        for (int i = 1; i <= count; i++) {
+          auto t = static_cast<float>(i) / static_cast<float>(count);
+          auto mt = 1 - t;
+          points->push_back(Scale(pts[0], mt * mt) + Scale(pts[1], 2 * mt * t) +
+                            Scale(pts[2], t * t));
+        }
+      } break;
+      case PathVerb::Cubic: {
+        // The distance between a cubic and its chords is at most 3 * d / (4 * n^2), where d is the
+        // larger one of |p0 - 2p1 + p2| and |p1 - 2p2 + p3|.
+        auto distance = std::max((pts[0] - pts[1] - pts[1] + pts[2]).length(),
+                                 (pts[1] - pts[2] - pts[2] + pts[3]).length());
+        auto count = CountSegments(3 * distance / (4 * tolerance));
+        for (int i = 1; i <= count; i++) {
+          auto t = static_cast<float>(i) / static_cast<float>(count);
+          auto mt = 1 - t;
+          points->push_back(Scale(pts[0], mt * mt * mt) + Scale(pts[1], 3 * mt * mt * t) +
+                            Scale(pts[2], 3 * mt * t * t) + Scale(pts[3], t * t * t));
+        }
+      } break;
+      default:
+        break;
+    }
+  });
+  return contourCount == 1 && points->size() <= kMaxConvexPathPoints;
+}
+
+// Removes the points that are too close to the previous ones on the device, including the last
+// point that closes the contour.
+static std::vector<Point> RemoveDuplicatePoints(const std::vector<Point>& points,
+                                                const std::vector<Point>& devicePoints,
+                                                std::vector<Point>* uniqueDevicePoints) {
+  std::vector<Point> uniquePoints = {};
+  for (size_t i = 0; i < points.size(); i++) {
+    if (!uniqueDevicePoints->empty() &&
+        Point::Distance(uniqueDevicePoints->back(), devicePoints[i]) < FLOAT_NEARLY_ZERO) {
+      continue;
+    }
+    uniquePoints.push_back(points[i]);
+    uniqueDevicePoints->push_back(devicePoints[i]);
+  }
+  while (uniquePoints.size() > 1 &&
+         Point::Distance(uniqueDevicePoints->back(), uniqueDevicePoints->front()) <
+             FLOAT_NEARLY_ZERO) {
+    uniquePoints.pop_back();
+    uniqueDevicePoints->pop_back();
+  }
+  return uniquePoints;
+}
+
+static float SignedArea(const std::vector<Point>& points) {
+  float area = 0;
+  for (size_t i = 0; i < points.size(); i++) {
+    area += Cross(points[i], points[(i + 1) % points.size()]);
+  }
+  return area * 0.5f;
+}
+
+// Returns true if the counterclockwise polygon turns left at every corner and winds only once.
+static bool IsConvex(const std::vector<Point>& points) {
+  auto count = points.size();
+  float totalAngle = 0;
+  for (size_t i = 0; i < count; i++) {
+    auto edge = points[(i + 1) % count] - points[i];
+    auto nextEdge = points[(i + 2) % count] - points[(i + 1) % count];
+    auto cross = Cross(edge, nextEdge);
+    if (cross < -FLOAT_NEARLY_ZERO * edge.length() * nextEdge.length()) {
+      return false;
+    }
+    totalAngle += atan2f(cross, Dot(edge, nextEdge));
+  }
+  return FloatNearlyEqual(totalAngle, 2 * M_PI_F, 0.01f);
+}
+
+// Returns the outward unit normal of the edge from a to b of a counterclockwise polygon.
+static Point EdgeNormal(const Point& a, const Point& b) {
+  auto edge = b - a;
+  auto length = edge.length();
+  return Point::Make(edge.y / length, -edge.x / length);
+}
+
+std::unique_ptr<GLConvexPathOp> GLConvexPathOp::Make(const Path& path, const Matrix& viewMatrix) {
+  if (!convexPathEnabled || path.isInverseFillType() || path.countPoints() < 3) {
+    return nullptr;
+  }
+  Matrix inverse = Matrix::I();
+  auto scale = viewMatrix.getMaxScale();
+  if (scale <= 0 || !viewMatrix.invert(&inverse)) {
+    return nullptr;
+  }
+  std::vector<Point> flattenedPoints = {};
+  if (!FlattenPath(path, kFlattenTolerance / scale, &flattenedPoints)) {
+    return nullptr;
+  }
+  std::vector<Point> flattenedDevicePoints(flattenedPoints.size());
+  viewMatrix.mapPoints(&flattenedDevicePoints[0], &flattenedPoints[0],
+                       static_cast<int>(flattenedPoints.size()));
+  std::vector<Point> devicePoints = {};
+  auto points = RemoveDuplicatePoints(flattenedPoints, flattenedDevicePoints, &devicePoints);
+  if (points.size() < 3) {
+    return nullptr;
+  }
+  if (SignedArea(devicePoints) < 0) {
+    std::reverse(points.begin(), points.end());
+    std::reverse(devicePoints.begin(), devicePoints.end());
+  }
+  if (!IsConvex(devicePoints)) {
+    return nullptr;
+  }
+  auto count = devicePoints.size();
+  std::vector<Point> insetPoints(count);
+  std::vector<Point> outsetPoints(count);
+  for (size_t i = 0; i < count; i++) {
+    auto& previous = devicePoints[(i + count - 1) % count];
+    auto& current = devicePoints[i];
+    auto& next = devicePoints[(i + 1) % count];
+    auto normal = EdgeNormal(previous, current);
+    auto nextNormal = EdgeNormal(current, next);
+    auto cosine = Dot(normal, nextNormal);
+    if (cosine < kMinCornerCosine) {
+      return nullptr;
+    }
+    // The miter vector has a projection of exactly half a pixel on both of the edge normals.
+    auto miter = Scale(normal + nextNormal, 0.5f / (1 + cosine));
+    insetPoints[i] = current - miter;
+    outsetPoints[i] = current + miter;
+  }
+  for (size_t i = 0; i < count; i++) {
+    auto next = (i + 1) % count;
+    // An inset edge turns around if the path is thinner than one pixel there.
+    if (Dot(insetPoints[next] - insetPoints[i], devicePoints[next] - devicePoints[i]) <= 0) {
+      return nullptr;
+    }
+  }
+  inverse.mapPoints(&insetPoints[0], static_cast<int>(count));
+  inverse.mapPoints(&outsetPoints[0], static_cast<int>(count));
+  auto op = std::make_unique<GLConvexPathOp>();
+  op->points = std::move(points);
+  op->insetPoints = std::move(insetPoints);
+  op->outsetPoints = std::move(outsetPoints);
+  return op;
+}
+
+static AAType GetAAType(const DrawArgs& args) {
+  // The edges of curves are never pixel aligned, they always need anti-aliasing.
+  return args.aa == AAType::MSAA ? AAType::MSAA : AAType::Coverage;
+}
+
+std::unique_ptr<GeometryProcessor> GLConvexPathOp::getGeometryProcessor(const DrawArgs& args) {
+  return QuadPerEdgeAAGeometryProcessor::Make(
+      args.renderTarget->width(), args.renderTarget->height(), args.viewMatrix, GetAAType(args));
+}
+
+std::vector<float> GLConvexPathOp::vertices(const DrawArgs& args) {
+  auto& bounds = args.rectToDraw;
+  std::vector<float> vertices = {};
+  auto addVertex = [&](const Point& point, float coverage, bool aa) {
+    vertices.push_back(point.x);
+    vertices.push_back(point.y);
+    if (aa) {
+      vertices.push_back(coverage);
+    }
+    // Local coordinates are normalized to the bounds, just like GLFillRectOp does.
+    vertices.push_back((point.x - bounds.left) / bounds.width());
+    vertices.push_back((point.y - bounds.top) / bounds.height());
+  };
+  auto count = points.size();
+  if (GetAAType(args) != AAType::Coverage) {
+    for (size_t i = 1; i + 1 < count; i++) {
+      addVertex(points[0], 1.0f, false);
+      addVertex(points[i], 1.0f, false);
+      addVertex(points[i + 1], 1.0f, false);
+    }
+    return vertices;
+  }
+  vertices.reserve(((count - 2) * 3 + count * 6) * 5);
+  for (size_t i = 1; i + 1 < count; i++) {
+    addVertex(insetPoints[0], 1.0f, true);
+    addVertex(insetPoints[i], 1.0f, true);
+    addVertex(insetPoints[i + 1], 1.0f, true);
+  }
+  for (size_t i = 0; i < count; i++) {
+    auto next = (i + 1) % count;
+    addVertex(insetPoints[i], 1.0f, true);
+    addVertex(outsetPoints[i], 0.0f, true);
+    addVertex(insetPoints[next], 1.0f, true);
+    addVertex(outsetPoints[i], 0.0f, true);
+    addVertex(outsetPoints[next], 0.0f, true);
+    addVertex(insetPoints[next], 1.0f, true);
+  }
+  return vertices;
+}
+
+std::shared_ptr<GLBuffer> GLConvexPathOp::getIndexBuffer(const DrawArgs&) {
+  return nullptr;
+}
+
+unsigned GLConvexPathOp::primitiveType() const {
+  return GL::TRIANGLES;
+}
+}  // namespace pag
@@ -0,0 +1,61 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "GLDrawer.h"
+#include "raster/Path.h"
+
+namespace pag {
+/**
+ * Draws a path made of a single convex contour as triangles on the GPU. Curves are flattened into
+ * line segments on the CPU, and the edges get anti-aliased by a ramp of coverage that is one pixel
+ * wide, just like GLFillRectOp does.
+ */
+class GLConvexPathOp : public GLDrawOp {
+ public:
+  /**
+   * Creates a GLConvexPathOp for the path drawn with the specified view matrix. Returns nullptr if
+   * the path is not convex, has sharp corners or thin parts that can not be anti-aliased by the
+   * coverage ramp, or has too many points after flattening. These paths should be drawn with masks
+   * instead.
+   */
+  static std::unique_ptr<GLConvexPathOp> Make(const Path& path, const Matrix& viewMatrix);
+
+  /**
+   * Globally enables or disables drawing convex paths as triangles, which is used to compare the
+   * performance against masks. The default value is true.
+   */
+  static void SetEnabled(bool enabled);
+
+  std::unique_ptr<GeometryProcessor> getGeometryProcessor(const DrawArgs& args) override;
+
+  std::vector<float> vertices(const DrawArgs& args) override;
+
+  std::shared_ptr<GLBuffer> getIndexBuffer(const DrawArgs& args) override;
+
+  unsigned primitiveType() const override;
+
+ private:
+  // The flattened contour in local coordinates, and its inset and outset copies whose edges are
+  // half a pixel away from the contour on the device.
+  std::vector<Point> points = {};
+  std::vector<Point> insetPoints = {};
+  std::vector<Point> outsetPoints = {};
+};
+}  // namespace pag
@@ -812,6 +812,8 @@ static constexpr unsigned NUM_SHADER_BINARY_FORMATS = 0x8DF9;
 
 // Program Binary
 static constexpr unsigned NUM_PROGRAM_BINARY_FORMATS = 0x87FE;
+static constexpr unsigned PROGRAM_BINARY_LENGTH = 0x8741;
+static constexpr unsigned PROGRAM_BINARY_RETRIEVABLE_HINT = 0x8257;
 
 // Shader Precision-Specified Types
 static constexpr unsigned LOW_FLOAT = 0x8DF0;
@@ -907,5 +909,10 @@ static constexpr unsigned NUM_SAMPLE_COUNTS = 0x9380;
 static constexpr unsigned FETCH_PER_SAMPLE_ARM = 0x8F65;
 
 static constexpr unsigned SYNC_GPU_COMMANDS_COMPLETE = 0x9117;
+static constexpr unsigned SYNC_FLUSH_COMMANDS_BIT = 0x00000001;
+static constexpr unsigned ALREADY_SIGNALED = 0x911A;
+static constexpr unsigned TIMEOUT_EXPIRED = 0x911B;
+static constexpr unsigned CONDITION_SATISFIED = 0x911C;
+static constexpr unsigned WAIT_FAILED = 0x911D;
 static constexpr uint64_t TIMEOUT_IGNORED = 0xFFFFFFFFFFFFFFFFull;
 }  // namespace GL
@@ -144,7 +144,12 @@ static void UpdateScissor(const GLInterface* gl, const DrawArgs& args) {
     gl->disable(GL::SCISSOR_TEST);
   } else {
     gl->enable(GL::SCISSOR_TEST);
-    gl->scissor(static_cast<int>(args.scissorRect.x()), static_cast<int>(args.scissorRect.y()),
+    auto y = args.scissorRect.y();
+    if (args.renderTarget->origin() == ImageOrigin::BottomLeft) {
+      // The scissor box is in the window coordinates of OpenGL, which start from the bottom.
+      y = static_cast<float>(args.renderTarget->height()) - args.scissorRect.bottom;
+    }
+    gl->scissor(static_cast<int>(args.scissorRect.x()), static_cast<int>(y),
                 static_cast<int>(args.scissorRect.width()),
                 static_cast<int>(args.scissorRect.height()));
   }
@@ -228,8 +233,11 @@ void GLDrawer::draw(DrawArgs args, std::unique_ptr<GLDrawOp> op) const {
     gl->drawElements(GL::TRIANGLES, static_cast<int>(indexBuffer->length()), GL::UNSIGNED_SHORT, 0);
     gl->bindBuffer(GL::ELEMENT_ARRAY_BUFFER, 0);
   } else {
-    gl->drawArrays(GL::TRIANGLE_STRIP, 0, 4);
+    auto vertexCount =
+        vertices.size() * sizeof(float) / static_cast<size_t>(program->vertexStride());
+    gl->drawArrays(op->primitiveType(), 0, static_cast<int>(vertexCount));
   }
+  args.context->recordDrawCall(op->drawCount());
   if (vertexArray > 0) {
     gl->bindVertexArray(0);
   }
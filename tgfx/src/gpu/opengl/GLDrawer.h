@@ -48,6 +48,20 @@ class GLDrawOp {
   virtual std::vector<float> vertices(const DrawArgs& args) = 0;
 
   virtual std::shared_ptr<GLBuffer> getIndexBuffer(const DrawArgs& args) = 0;
+
+  /**
+   * Returns the primitive type used to draw the vertices if there is no index buffer.
+   */
+  virtual unsigned primitiveType() const {
+    return GL::TRIANGLE_STRIP;
+  }
+
+  /**
+   * Returns the number of draws merged into this op.
+   */
+  virtual size_t drawCount() const {
+    return 1;
+  }
 };
 
 class GLDrawer : public Resource {
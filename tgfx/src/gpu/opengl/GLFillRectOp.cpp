@@ -83,4 +83,51 @@ std::shared_ptr<GLBuffer> GLFillRectOp::getIndexBuffer(const DrawArgs& args) {
   }
   return nullptr;
 }
+
+static constexpr uint16_t gFillRectIdx[] = {0, 1, 2, 2, 1, 3};
+
+void GLBatchedFillRectOp::addRect(const Rect& rect, const Matrix& viewMatrix, AAType aa,
+                                  float alpha, const Matrix& localMatrix) {
+  DrawArgs args;
+  args.viewMatrix = viewMatrix;
+  args.rectToDraw = rect;
+  args.aa = aa;
+  auto rectVertices = GLFillRectOp().vertices(args);
+  auto hasCoverage = aa == AAType::Coverage;
+  size_t stride = hasCoverage ? 5 : 4;
+  // Expands the indexed vertices into a triangle list, so the rects can be appended one by one.
+  auto appendVertex = [&](uint16_t index) {
+    auto vertex = &rectVertices[index * stride];
+    auto position = viewMatrix.mapXY(vertex[0], vertex[1]);
+    auto coverage = hasCoverage ? vertex[2] : 1.0f;
+    auto localCoord = localMatrix.mapXY(vertex[stride - 2], vertex[stride - 1]);
+    vertexData.insert(vertexData.end(),
+                      {position.x, position.y, coverage * alpha, localCoord.x, localCoord.y});
+  };
+  if (hasCoverage) {
+    for (auto index : gFillAARectIdx) {
+      appendVertex(index);
+    }
+  } else {
+    for (auto index : gFillRectIdx) {
+      appendVertex(index);
+    }
+  }
+  rectCount++;
+}
+
+std::unique_ptr<GeometryProcessor> GLBatchedFillRectOp::getGeometryProcessor(
+    const DrawArgs& args) {
+  return QuadPerEdgeAAGeometryProcessor::Make(args.renderTarget->width(),
+                                              args.renderTarget->height(), Matrix::I(),
+                                              AAType::Coverage);
+}
+
+std::vector<float> GLBatchedFillRectOp::vertices(const DrawArgs&) {
+  return vertexData;
+}
+
+std::shared_ptr<GLBuffer> GLBatchedFillRectOp::getIndexBuffer(const DrawArgs&) {
+  return nullptr;
+}
 }  // namespace pag
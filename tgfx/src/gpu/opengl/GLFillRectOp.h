@@ -33,4 +33,38 @@ class GLFillRectOp : public GLDrawOp {
 
   std::shared_ptr<GLBuffer> getIndexBuffer(const DrawArgs& args) override;
 };
+
+/**
+ * Draws a list of rects sharing the same fragment processors with one draw call. The rects are
+ * mapped to the device space on the CPU, and their alpha values are multiplied into the coverage,
+ * so each rect can have its own view matrix and alpha. The op must be drawn with an identity view
+ * matrix.
+ */
+class GLBatchedFillRectOp : public GLDrawOp {
+ public:
+  /**
+   * Appends a rect drawn with the specified view matrix, anti-aliasing type and alpha. The
+   * localMatrix maps the normalized coordinates (0 - 1) of the rect to its local coordinates.
+   */
+  void addRect(const Rect& rect, const Matrix& viewMatrix, AAType aa, float alpha,
+               const Matrix& localMatrix);
+
+  std::unique_ptr<GeometryProcessor> getGeometryProcessor(const DrawArgs& args) override;
+
+  std::vector<float> vertices(const DrawArgs& args) override;
+
+  std::shared_ptr<GLBuffer> getIndexBuffer(const DrawArgs& args) override;
+
+  unsigned primitiveType() const override {
+    return GL::TRIANGLES;
+  }
+
+  size_t drawCount() const override {
+    return rectCount;
+  }
+
+ private:
+  std::vector<float> vertexData = {};
+  size_t rectCount = 0;
+};
 }  // namespace pag
@@ -160,6 +160,15 @@ using GLGetShaderPrecisionFormat = void GL_FUNCTION_TYPE(unsigned shadertype,
 using GLFenceSync = void* GL_FUNCTION_TYPE(unsigned condition, unsigned flags);
 using GLWaitSync = void GL_FUNCTION_TYPE(void* sync, unsigned flags, uint64_t timeout);
 using GLDeleteSync = void GL_FUNCTION_TYPE(void* sync);
+using GLClientWaitSync = unsigned GL_FUNCTION_TYPE(void* sync, unsigned flags, uint64_t timeout);
+using GLMapBufferRange = void* GL_FUNCTION_TYPE(unsigned target, GLintptr offset,
+                                                GLsizeiptr length, unsigned access);
+using GLUnmapBuffer = unsigned char GL_FUNCTION_TYPE(unsigned target);
+using GLGetProgramBinary = void GL_FUNCTION_TYPE(unsigned program, int bufSize, int* length,
+                                                 unsigned* binaryFormat, void* binary);
+using GLProgramBinary = void GL_FUNCTION_TYPE(unsigned program, unsigned binaryFormat,
+                                              const void* binary, int length);
+using GLProgramParameteri = void GL_FUNCTION_TYPE(unsigned program, unsigned pname, int value);
 }  // extern "C"
 
 // This is a lighter-weight std::function, trying to reduce code size and compile time by only
@@ -145,6 +145,26 @@ static void InitBlitFramebuffer(const GLProcGetter* getter, GLInterface* interfa
   }
 }
 
+static void InitProgramBinary(const GLProcGetter* getter, GLInterface* interface,
+                              const GLInfo& info) {
+  if ((info.standard == GLStandard::GL &&
+       (info.version >= GL_VER(4, 1) || info.hasExtension("GL_ARB_get_program_binary"))) ||
+      (info.standard == GLStandard::GLES && info.version >= GL_VER(3, 0))) {
+    interface->getProgramBinary =
+        reinterpret_cast<GLGetProgramBinary*>(getter->getProcAddress("glGetProgramBinary"));
+    interface->programBinary =
+        reinterpret_cast<GLProgramBinary*>(getter->getProcAddress("glProgramBinary"));
+    interface->programParameteri =
+        reinterpret_cast<GLProgramParameteri*>(getter->getProcAddress("glProgramParameteri"));
+  } else if (info.standard == GLStandard::GLES &&
+             info.hasExtension("GL_OES_get_program_binary")) {
+    interface->getProgramBinary =
+        reinterpret_cast<GLGetProgramBinary*>(getter->getProcAddress("glGetProgramBinaryOES"));
+    interface->programBinary =
+        reinterpret_cast<GLProgramBinary*>(getter->getProcAddress("glProgramBinaryOES"));
+  }
+}
+
 #ifdef TGFX_BUILD_FOR_WEB
 
 static unsigned GetErrorFake() {
@@ -325,9 +345,16 @@ std::unique_ptr<const GLInterface> GLInterface::MakeNativeInterface(const GLProc
   interface->fenceSync = reinterpret_cast<GLFenceSync*>(getter->getProcAddress("glFenceSync"));
   interface->waitSync = reinterpret_cast<GLWaitSync*>(getter->getProcAddress("glWaitSync"));
   interface->deleteSync = reinterpret_cast<GLDeleteSync*>(getter->getProcAddress("glDeleteSync"));
+  interface->clientWaitSync =
+      reinterpret_cast<GLClientWaitSync*>(getter->getProcAddress("glClientWaitSync"));
+  interface->mapBufferRange =
+      reinterpret_cast<GLMapBufferRange*>(getter->getProcAddress("glMapBufferRange"));
+  interface->unmapBuffer =
+      reinterpret_cast<GLUnmapBuffer*>(getter->getProcAddress("glUnmapBuffer"));
   InitFramebufferTexture2DMultisample(getter, interface, info);
   InitRenderbufferStorageMultisample(getter, interface, info);
   InitBlitFramebuffer(getter, interface, info);
+  InitProgramBinary(getter, interface, info);
   InitGetError(getter, interface);
   InitCheckFramebufferStatus(getter, interface);
   interface->caps = std::shared_ptr<const GLCaps>(new GLCaps(info));
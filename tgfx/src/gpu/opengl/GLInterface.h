@@ -125,6 +125,12 @@ class GLInterface {
   GLFunction<GLFenceSync> fenceSync;
   GLFunction<GLWaitSync> waitSync;
   GLFunction<GLDeleteSync> deleteSync;
+  GLFunction<GLClientWaitSync> clientWaitSync;
+  GLFunction<GLMapBufferRange> mapBufferRange;
+  GLFunction<GLUnmapBuffer> unmapBuffer;
+  GLFunction<GLGetProgramBinary> getProgramBinary;
+  GLFunction<GLProgramBinary> programBinary;
+  GLFunction<GLProgramParameteri> programParameteri;
 
   std::shared_ptr<const GLCaps> caps = nullptr;
 
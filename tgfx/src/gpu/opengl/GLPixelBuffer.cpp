@@ -0,0 +1,166 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "GLPixelBuffer.h"
+#include "GLContext.h"
+#include "GLState.h"
+#include "image/PixelMap.h"
+
+namespace pag {
+// The time in nanoseconds to wait for a fence in each round of a blocking wait.
+static constexpr uint64_t FenceWaitTimeout = 1000000000;
+
+static void ComputeRecycleKey(BytesKey* recycleKey, const ImageInfo& info) {
+  static const uint32_t Type = UniqueID::Next();
+  recycleKey->write(Type);
+  recycleKey->write(static_cast<uint32_t>(info.width()));
+  recycleKey->write(static_cast<uint32_t>(info.height()));
+  recycleKey->write(static_cast<uint32_t>(info.colorType()));
+}
+
+std::shared_ptr<GLPixelBuffer> GLPixelBuffer::Make(Context* context, int width, int height,
+                                                   bool alphaOnly) {
+  const auto* gl = GLContext::Unwrap(context);
+  if (!gl->caps->pixelBufferSupport) {
+    return nullptr;
+  }
+  auto colorType = alphaOnly ? ColorType::ALPHA_8 : ColorType::RGBA_8888;
+  auto info = ImageInfo::Make(width, height, colorType, AlphaType::Premultiplied);
+  if (info.isEmpty()) {
+    return nullptr;
+  }
+  BytesKey recycleKey = {};
+  ComputeRecycleKey(&recycleKey, info);
+  auto pixelBuffer =
+      std::static_pointer_cast<GLPixelBuffer>(context->getRecycledResource(recycleKey));
+  if (pixelBuffer != nullptr) {
+    return pixelBuffer;
+  }
+  pixelBuffer = Resource::Wrap(context, new GLPixelBuffer(info));
+  gl->genBuffers(1, &pixelBuffer->_bufferID);
+  if (pixelBuffer->_bufferID == 0) {
+    return nullptr;
+  }
+  gl->bindBuffer(GL::PIXEL_PACK_BUFFER, pixelBuffer->_bufferID);
+  gl->bufferData(GL::PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(info.byteSize()), nullptr,
+                 GL::STREAM_READ);
+  gl->bindBuffer(GL::PIXEL_PACK_BUFFER, 0);
+  return pixelBuffer;
+}
+
+bool GLPixelBuffer::readPixels(Context* context, const GLRenderTarget* renderTarget) {
+  if (renderTarget->width() != _info.width() || renderTarget->height() != _info.height()) {
+    return false;
+  }
+  auto alphaOnly = renderTarget->getGLInfo().format == GL::R8;
+  if (alphaOnly != (_info.colorType() == ColorType::ALPHA_8)) {
+    return false;
+  }
+  GLStateGuard stateGuard(context);
+  auto gl = GLContext::Unwrap(context);
+  if (sync != nullptr) {
+    gl->deleteSync(sync);
+    sync = nullptr;
+  }
+  auto pixelConfig = alphaOnly ? PixelConfig::ALPHA_8 : PixelConfig::RGBA_8888;
+  const auto& format = gl->caps->getTextureFormat(pixelConfig);
+  gl->bindFramebuffer(GL::FRAMEBUFFER, renderTarget->getGLInfo().id);
+  gl->bindBuffer(GL::PIXEL_PACK_BUFFER, _bufferID);
+  gl->pixelStorei(GL::PACK_ALIGNMENT, alphaOnly ? 1 : 4);
+  // With a pixel pack buffer bound, the last argument is an offset into the buffer, and the call
+  // returns without waiting for the GPU.
+  gl->readPixels(0, 0, _info.width(), _info.height(), format.externalFormat, GL::UNSIGNED_BYTE,
+                 nullptr);
+  gl->bindBuffer(GL::PIXEL_PACK_BUFFER, 0);
+  sync = gl->fenceSync(GL::SYNC_GPU_COMMANDS_COMPLETE, 0);
+  // Submits the commands, otherwise the fence may never be signaled.
+  gl->flush();
+  flipY = renderTarget->origin() == ImageOrigin::BottomLeft;
+  return sync != nullptr;
+}
+
+bool GLPixelBuffer::isFinished(Context* context, bool wait) {
+  if (sync == nullptr) {
+    return true;
+  }
+  auto gl = GLContext::Unwrap(context);
+  auto flags = wait ? GL::SYNC_FLUSH_COMMANDS_BIT : 0;
+  auto timeout = wait ? FenceWaitTimeout : 0;
+  auto result = gl->clientWaitSync(sync, flags, timeout);
+  while (wait && result == GL::TIMEOUT_EXPIRED) {
+    result = gl->clientWaitSync(sync, flags, timeout);
+  }
+  if (result == GL::TIMEOUT_EXPIRED) {
+    return false;
+  }
+  // The copy is also finished when the wait failed, mapping the buffer synchronizes it anyway.
+  gl->deleteSync(sync);
+  sync = nullptr;
+  return true;
+}
+
+bool GLPixelBuffer::getPixels(Context* context, const ImageInfo& dstInfo, void* dstPixels) {
+  if (dstInfo.isEmpty() || dstPixels == nullptr || dstInfo.width() != _info.width() ||
+      dstInfo.height() != _info.height()) {
+    return false;
+  }
+  isFinished(context, true);
+  auto gl = GLContext::Unwrap(context);
+  gl->bindBuffer(GL::PIXEL_PACK_BUFFER, _bufferID);
+  auto pixels = gl->mapBufferRange(GL::PIXEL_PACK_BUFFER, 0,
+                                   static_cast<GLsizeiptr>(_info.byteSize()), GL::MAP_READ_BIT);
+  if (pixels == nullptr) {
+    gl->bindBuffer(GL::PIXEL_PACK_BUFFER, 0);
+    return false;
+  }
+  if (!flipY) {
+    PixelMap pixelMap(_info, pixels);
+    pixelMap.readPixels(dstInfo, dstPixels);
+  } else {
+    // The rows of a BottomLeft render target are stored from bottom to top.
+    auto srcRowInfo = ImageInfo::Make(_info.width(), 1, _info.colorType(), _info.alphaType());
+    auto dstRowInfo =
+        ImageInfo::Make(dstInfo.width(), 1, dstInfo.colorType(), dstInfo.alphaType());
+    auto rowCount = _info.height();
+    for (int i = 0; i < rowCount; i++) {
+      auto srcRow = _info.computeOffset(pixels, 0, rowCount - i - 1);
+      PixelMap pixelMap(srcRowInfo, srcRow);
+      pixelMap.readPixels(dstRowInfo, dstInfo.computeOffset(dstPixels, 0, i));
+    }
+  }
+  gl->unmapBuffer(GL::PIXEL_PACK_BUFFER);
+  gl->bindBuffer(GL::PIXEL_PACK_BUFFER, 0);
+  return true;
+}
+
+void GLPixelBuffer::computeRecycleKey(BytesKey* recycleKey) const {
+  ComputeRecycleKey(recycleKey, _info);
+}
+
+void GLPixelBuffer::onRelease(Context* context) {
+  auto gl = GLContext::Unwrap(context);
+  if (sync != nullptr) {
+    gl->deleteSync(sync);
+    sync = nullptr;
+  }
+  if (_bufferID > 0) {
+    gl->deleteBuffers(1, &_bufferID);
+    _bufferID = 0;
+  }
+}
+}  // namespace pag
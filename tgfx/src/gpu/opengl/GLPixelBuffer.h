@@ -0,0 +1,84 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "GLRenderTarget.h"
+#include "gpu/Resource.h"
+#include "image/ImageInfo.h"
+
+namespace pag {
+/**
+ * GLPixelBuffer is a pixel pack buffer that receives the pixels of a render target. The copy is
+ * followed by a fence, so the GPU keeps working while the pixels are transferred, and the buffer
+ * can be mapped without stalling once the fence is signaled.
+ */
+class GLPixelBuffer : public Resource {
+ public:
+  /**
+   * Creates a pixel buffer which holds all pixels of a render target with the specified size.
+   * Returns nullptr if pixel pack buffers or fences are not supported, such as on GL ES 2.0.
+   */
+  static std::shared_ptr<GLPixelBuffer> Make(Context* context, int width, int height,
+                                             bool alphaOnly = false);
+
+  /**
+   * Returns the ImageInfo of the pixels held by this buffer.
+   */
+  const ImageInfo& info() const {
+    return _info;
+  }
+
+  size_t memoryUsage() const override {
+    return _info.byteSize();
+  }
+
+  /**
+   * Starts copying all pixels of the render target into this buffer. The size of the render target
+   * must be the same as the buffer. Returns false if the copy can not be started.
+   */
+  bool readPixels(Context* context, const GLRenderTarget* renderTarget);
+
+  /**
+   * Returns true if the GPU has finished the last copy. Blocks until the copy is finished if wait
+   * is true.
+   */
+  bool isFinished(Context* context, bool wait);
+
+  /**
+   * Copies the pixels in this buffer to dstPixels with specified ImageInfo, waiting for the last
+   * copy to finish if necessary. Pixels are copied only if pixel conversion is possible. Returns
+   * true if pixels are copied to dstPixels.
+   */
+  bool getPixels(Context* context, const ImageInfo& dstInfo, void* dstPixels);
+
+ protected:
+  void computeRecycleKey(BytesKey* recycleKey) const override;
+
+ private:
+  ImageInfo _info = {};
+  unsigned _bufferID = 0;
+  void* sync = nullptr;
+  bool flipY = false;
+
+  explicit GLPixelBuffer(const ImageInfo& info) : _info(info) {
+  }
+
+  void onRelease(Context* context) override;
+};
+}  // namespace pag
@@ -0,0 +1,218 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "GLProgramBinaryCache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "GLUtil.h"
+
+namespace pag {
+static constexpr uint32_t kFileMagic = 0x42474150;  // "PAGB"
+static constexpr uint32_t kFileVersion = 2;
+
+static std::mutex directoryLocker = {};
+static std::string cacheDirectory = {};
+
+// The header of a cache file, which is followed by the driver string, the vertex source, the
+// fragment source and the program binary.
+struct BinaryHeader {
+  uint32_t magic = kFileMagic;
+  uint32_t version = kFileVersion;
+  uint32_t binaryFormat = 0;
+  uint32_t driverLength = 0;
+  uint32_t vertexLength = 0;
+  uint32_t fragmentLength = 0;
+  uint32_t binaryLength = 0;
+  // The FNV-1a hash of the program binary, a corrupted binary may crash some drivers.
+  uint32_t binaryChecksum = 0;
+};
+
+static int CurrentProcessID() {
+#ifdef _WIN32
+  return _getpid();
+#else
+  return static_cast<int>(getpid());
+#endif
+}
+
+static uint32_t Checksum(const char* data, size_t length) {
+  uint32_t hash = 2166136261U;
+  for (size_t i = 0; i < length; i++) {
+    hash = (hash ^ static_cast<uint8_t>(data[i])) * 16777619U;
+  }
+  return hash;
+}
+
+void GLProgramBinaryCache::SetDirectory(const std::string& directory) {
+  std::lock_guard<std::mutex> autoLock(directoryLocker);
+  cacheDirectory = directory;
+}
+
+// Returns the cache file of the shader sources, or an empty string if the cache is disabled. The
+// file name is the FNV-1a hash of the sources, which stays the same across processes.
+static std::string GetFilePath(const GLInterface* gl, const std::string& vertex,
+                               const std::string& fragment) {
+  if (!gl->caps->programBinarySupport) {
+    return "";
+  }
+  std::string directory = {};
+  {
+    std::lock_guard<std::mutex> autoLock(directoryLocker);
+    directory = cacheDirectory;
+  }
+  if (directory.empty()) {
+    return "";
+  }
+  uint64_t hash = 14695981039346656037ULL;
+  for (auto source : {&vertex, &fragment}) {
+    for (auto c : *source) {
+      hash = (hash ^ static_cast<uint8_t>(c)) * 1099511628211ULL;
+    }
+    hash = (hash ^ 0xFF) * 1099511628211ULL;
+  }
+  char fileName[32];
+  snprintf(fileName, sizeof(fileName), "%016llx.bin", static_cast<unsigned long long>(hash));
+  if (directory.back() != '/') {
+    directory += "/";
+  }
+  return directory + fileName;
+}
+
+static std::vector<char> ReadFile(const std::string& filePath) {
+  std::vector<char> data = {};
+  auto file = fopen(filePath.c_str(), "rb");
+  if (file == nullptr) {
+    return data;
+  }
+  fseek(file, 0, SEEK_END);
+  auto length = ftell(file);
+  if (length > 0) {
+    fseek(file, 0, SEEK_SET);
+    data.resize(static_cast<size_t>(length));
+    if (fread(data.data(), 1, data.size(), file) != data.size()) {
+      data.clear();
+    }
+  }
+  fclose(file);
+  return data;
+}
+
+static bool MatchString(const char** data, uint32_t length, const std::string& value) {
+  if (length != value.size() || value.compare(0, length, *data, length) != 0) {
+    return false;
+  }
+  *data += length;
+  return true;
+}
+
+unsigned GLProgramBinaryCache::LoadProgram(const GLInterface* gl, const std::string& vertex,
+                                           const std::string& fragment) {
+  auto filePath = GetFilePath(gl, vertex, fragment);
+  if (filePath.empty()) {
+    return 0;
+  }
+  auto data = ReadFile(filePath);
+  if (data.size() < sizeof(BinaryHeader)) {
+    return 0;
+  }
+  BinaryHeader header = {};
+  memcpy(&header, data.data(), sizeof(BinaryHeader));
+  auto totalLength = sizeof(BinaryHeader) + static_cast<size_t>(header.driverLength) +
+                     header.vertexLength + header.fragmentLength + header.binaryLength;
+  auto binary = static_cast<const char*>(data.data()) + sizeof(BinaryHeader);
+  if (header.magic != kFileMagic || header.version != kFileVersion ||
+      totalLength != data.size() ||
+      !MatchString(&binary, header.driverLength, gl->caps->driverString) ||
+      !MatchString(&binary, header.vertexLength, vertex) ||
+      !MatchString(&binary, header.fragmentLength, fragment) ||
+      Checksum(binary, header.binaryLength) != header.binaryChecksum) {
+    // The file is broken, or it was saved by another driver, or the hash collides.
+    remove(filePath.c_str());
+    return 0;
+  }
+  auto program = gl->createProgram();
+  gl->programBinary(program, header.binaryFormat, binary, static_cast<int>(header.binaryLength));
+  int success = 0;
+  gl->getProgramiv(program, GL::LINK_STATUS, &success);
+  if (!success) {
+    // The driver may reject a binary even if its version strings stay the same.
+    gl->deleteProgram(program);
+    remove(filePath.c_str());
+    CheckGLError(gl);
+    return 0;
+  }
+  return program;
+}
+
+void GLProgramBinaryCache::SaveProgram(const GLInterface* gl, unsigned program,
+                                       const std::string& vertex, const std::string& fragment) {
+  auto filePath = GetFilePath(gl, vertex, fragment);
+  if (filePath.empty()) {
+    return;
+  }
+  int length = 0;
+  gl->getProgramiv(program, GL::PROGRAM_BINARY_LENGTH, &length);
+  if (length <= 0) {
+    return;
+  }
+  std::vector<char> binary(static_cast<size_t>(length));
+  BinaryHeader header = {};
+  gl->getProgramBinary(program, length, &length, &header.binaryFormat, binary.data());
+  if (length <= 0) {
+    return;
+  }
+  auto& driverString = gl->caps->driverString;
+  header.driverLength = static_cast<uint32_t>(driverString.size());
+  header.vertexLength = static_cast<uint32_t>(vertex.size());
+  header.fragmentLength = static_cast<uint32_t>(fragment.size());
+  header.binaryLength = static_cast<uint32_t>(length);
+  header.binaryChecksum = Checksum(binary.data(), header.binaryLength);
+  // Writes to a temporary file and renames it, so that other processes never read a partial file.
+  // The temporary file is unique to the thread, other threads or processes may be saving the same
+  // program at the same time.
+  char tempSuffix[48];
+  snprintf(tempSuffix, sizeof(tempSuffix), ".%d.%zx.tmp", CurrentProcessID(),
+           std::hash<std::thread::id>()(std::this_thread::get_id()));
+  auto tempPath = filePath + tempSuffix;
+  auto file = fopen(tempPath.c_str(), "wb");
+  if (file == nullptr) {
+    return;
+  }
+  auto success = fwrite(&header, sizeof(BinaryHeader), 1, file) == 1 &&
+                 fwrite(driverString.data(), 1, driverString.size(), file) == driverString.size() &&
+                 fwrite(vertex.data(), 1, vertex.size(), file) == vertex.size() &&
+                 fwrite(fragment.data(), 1, fragment.size(), file) == fragment.size() &&
+                 fwrite(binary.data(), 1, header.binaryLength, file) == header.binaryLength;
+  success = fclose(file) == 0 && success;
+  if (!success || rename(tempPath.c_str(), filePath.c_str()) != 0) {
+    remove(tempPath.c_str());
+  }
+}
+}  // namespace pag
@@ -0,0 +1,53 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <string>
+
+#include "GLInterface.h"
+
+namespace pag {
+/**
+ * Keeps the binaries of the linked GL programs on disk, so that a program can be loaded without
+ * compiling its shaders again after the process restarts. Programs are identified by their shader
+ * sources and the driver they were linked by, a cached binary is discarded once the driver changes.
+ * The cache is disabled until a directory is set.
+ */
+class GLProgramBinaryCache {
+ public:
+  /**
+   * Sets the directory to store the program binaries, which must exist and be writable. Pass an
+   * empty string to disable the cache, which is the default.
+   */
+  static void SetDirectory(const std::string& directory);
+
+  /**
+   * Creates a program from the cached binary of the shader sources. Returns 0 if there is no valid
+   * binary in the cache.
+   */
+  static unsigned LoadProgram(const GLInterface* gl, const std::string& vertex,
+                              const std::string& fragment);
+
+  /**
+   * Saves the binary of the linked program into the cache.
+   */
+  static void SaveProgram(const GLInterface* gl, unsigned program, const std::string& vertex,
+                          const std::string& fragment);
+};
+}  // namespace pag
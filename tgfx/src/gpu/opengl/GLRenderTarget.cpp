@@ -178,6 +178,24 @@ void GLRenderTarget::clear(const GLInterface* gl) const {
   gl->bindFramebuffer(GL::FRAMEBUFFER, oldFb);
 }
 
+void GLRenderTarget::clearRect(const GLInterface* gl, const Rect& rect) const {
+  auto x = static_cast<int>(rect.x());
+  auto y = static_cast<int>(rect.y());
+  if (_origin == ImageOrigin::BottomLeft) {
+    y = _height - static_cast<int>(rect.bottom);
+  }
+  int oldFb = 0;
+  gl->getIntegerv(GL::FRAMEBUFFER_BINDING, &oldFb);
+  gl->bindFramebuffer(GL::FRAMEBUFFER, renderTargetFBInfo.id);
+  gl->viewport(0, 0, _width, _height);
+  gl->enable(GL::SCISSOR_TEST);
+  gl->scissor(x, y, static_cast<int>(rect.width()), static_cast<int>(rect.height()));
+  gl->clearColor(0.0f, 0.0f, 0.0f, 0.0f);
+  gl->clear(GL::COLOR_BUFFER_BIT | GL::STENCIL_BUFFER_BIT | GL::DEPTH_BUFFER_BIT);
+  gl->disable(GL::SCISSOR_TEST);
+  gl->bindFramebuffer(GL::FRAMEBUFFER, oldFb);
+}
+
 static bool CanReadDirectly(const GLInterface* gl, ImageOrigin origin, const ImageInfo& srcInfo,
                             const ImageInfo& dstInfo) {
   if (origin != ImageOrigin::TopLeft || dstInfo.alphaType() != srcInfo.alphaType() ||
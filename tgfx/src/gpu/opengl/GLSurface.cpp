@@ -113,10 +113,10 @@ bool GLSurface::wait(const BackendSemaphore& semaphore) {
 }
 
 bool GLSurface::flush(BackendSemaphore* semaphore) {
+  if (canvas) {
+    canvas->flush();
+  }
   if (semaphore == nullptr) {
-    if (canvas) {
-      canvas->flush();
-    }
     return false;
   }
   const auto* gl = GLContext::Unwrap(getContext());
@@ -17,6 +17,7 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "GLUtil.h"
+#include "GLProgramBinaryCache.h"
 
 namespace pag {
 GLVersion GetGLVersion(const char* versionString) {
@@ -149,27 +150,38 @@ void SubmitTexture(const GLInterface* gl, const GLTextureInfo& glInfo, const Tex
 
 unsigned CreateProgram(const GLInterface* gl, const std::string& vertex,
                        const std::string& fragment) {
+  auto cachedProgram = GLProgramBinaryCache::LoadProgram(gl, vertex, fragment);
+  if (cachedProgram != 0) {
+    return cachedProgram;
+  }
   auto vertexShader = LoadShader(gl, GL::VERTEX_SHADER, vertex);
   if (vertexShader == 0) {
     return 0;
   }
   auto fragmentShader = LoadShader(gl, GL::FRAGMENT_SHADER, fragment);
   if (fragmentShader == 0) {
+    gl->deleteShader(vertexShader);
     return 0;
   }
   auto programHandle = gl->createProgram();
   gl->attachShader(programHandle, vertexShader);
   gl->attachShader(programHandle, fragmentShader);
+  if (gl->caps->programBinarySupport && gl->programParameteri) {
+    gl->programParameteri(programHandle, GL::PROGRAM_BINARY_RETRIEVABLE_HINT, GL::TRUE);
+  }
   gl->linkProgram(programHandle);
   int success;
   gl->getProgramiv(programHandle, GL::LINK_STATUS, &success);
+  gl->deleteShader(vertexShader);
+  gl->deleteShader(fragmentShader);
   if (!success) {
     char infoLog[512];
     gl->getProgramInfoLog(programHandle, 512, nullptr, infoLog);
+    LOGE("Could not link program: %s", infoLog);
     gl->deleteProgram(programHandle);
+    return 0;
   }
-  gl->deleteShader(vertexShader);
-  gl->deleteShader(fragmentShader);
+  GLProgramBinaryCache::SaveProgram(gl, programHandle, vertex, fragment);
   return programHandle;
 }
 
@@ -90,6 +90,16 @@ class Path {
    */
   bool isEmpty() const;
 
+  /**
+   * Returns the number of points in this Path.
+   */
+  int countPoints() const;
+
+  /**
+   * Returns the number of verbs in this Path.
+   */
+  int countVerbs() const;
+
   /**
    * Returns true if the point (x, y) is contained by Path, taking into account PathFillType.
    */
@@ -244,5 +254,7 @@ class Path {
   PathRef* writableRef();
 
   friend class PathRef;
+
+  friend class PathMaskCache;
 };
 }  // namespace pag
\ No newline at end of file
@@ -22,7 +22,9 @@
 
 namespace pag {
 static const FTLibrary& GetLibrary() {
-  static const auto& library = *new FTLibrary;
+  // Masks can be rasterized on the task pool, and an FT_Library must not be used by multiple
+  // threads at the same time.
+  static thread_local FTLibrary library;
   return library;
 }
 